@@ -0,0 +1,524 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/graphics/device/Instance.h>
+#include <yave/graphics/device/DeviceProperties.h>
+#include <yave/graphics/commands/CmdBufferRecorder.h>
+#include <yave/graphics/commands/CmdTimingRecorder.h>
+#include <yave/graphics/graphics.h>
+#include <yave/graphics/device/DeviceResources.h>
+
+#include <yave/framegraph/FrameGraph.h>
+#include <yave/framegraph/FrameGraphResourcePool.h>
+#include <yave/renderer/DefaultRenderer.h>
+
+#include <yave/assets/FolderAssetStore.h>
+#include <yave/assets/AssetLoader.h>
+
+#include <yave/ecs/EntityWorld.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/components/TransformableComponent.h>
+#include <yave/meshes/StaticMesh.h>
+
+#include <yave/systems/AssetLoaderSystem.h>
+#include <yave/systems/TransformHierarchySystem.h>
+#include <yave/systems/AABBUpdateSystem.h>
+#include <yave/systems/OctreeSystem.h>
+#include <yave/systems/ScriptSystem.h>
+#include <yave/systems/RendererSystem.h>
+
+#include <y/serde3/archives.h>
+#include <y/io2/File.h>
+
+#include <y/core/Chrono.h>
+#include <y/core/FrameArena.h>
+#include <y/concurrent/concurrent.h>
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+#include <y/utils/memory_tracking.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <new>
+#include <thread>
+
+using namespace yave;
+
+static core::String store_dir = "../store";
+static core::String world_file = "../world.yw3";
+static core::String camera_file;
+static core::String output_file = "benchmark.json";
+static usize frame_count = 100;
+static usize warmup_frames = 10;
+static usize grid_size = 0;
+static math::Vec2ui render_size = math::Vec2ui(1280, 720);
+static float orbit_radius = 10.0f;
+static bool debug_instance = false;
+
+static const double ns_to_ms = 1.0 / 1'000'000.0;
+
+
+template<typename T>
+static bool parse_number(std::string_view str, T& value) {
+    const auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && end == str.data() + str.size();
+}
+
+static bool parse_args(int argc, char** argv) {
+    const core::Span<const char*> args(argv + 1, argc - 1);
+    for(usize i = 0; i != args.size(); ++i) {
+        const std::string_view arg = args[i];
+        const std::string_view value = i + 1 < args.size() ? args[i + 1] : "";
+
+        bool ok = true;
+        if(arg == "--debug") {
+            debug_instance = true;
+            continue;
+        } else if(arg == "--store") {
+            store_dir = value;
+        } else if(arg == "--world") {
+            world_file = value;
+        } else if(arg == "--camera") {
+            camera_file = value;
+        } else if(arg == "--output") {
+            output_file = value;
+        } else if(arg == "--frames") {
+            ok = parse_number(value, frame_count) && frame_count;
+        } else if(arg == "--warmup") {
+            ok = parse_number(value, warmup_frames);
+        } else if(arg == "--grid") {
+            ok = parse_number(value, grid_size) && grid_size;
+        } else if(arg == "--radius") {
+            ok = parse_number(value, orbit_radius);
+        } else if(arg == "--size") {
+            const usize x = value.find('x');
+            ok = x != std::string_view::npos &&
+                 parse_number(value.substr(0, x), render_size.x()) &&
+                 parse_number(value.substr(x + 1), render_size.y()) &&
+                 render_size.x() && render_size.y();
+        } else {
+            log_msg(fmt("Unknown argument: {}", arg), Log::Error);
+            return false;
+        }
+
+        if(!ok || value.empty()) {
+            log_msg(fmt("Invalid value for {}: \"{}\"", arg, value), Log::Error);
+            return false;
+        }
+        ++i;
+    }
+    return true;
+}
+
+
+
+// ---------------------------------------------- CAMERA PATH ----------------------------------------------
+
+struct CameraKey {
+    math::Vec3 position;
+    math::Vec3 target;
+};
+
+// One key per line: "px py pz tx ty tz", keys are evenly spread over the benchmarked frames
+static core::Result<core::Vector<CameraKey>> load_camera_path(const core::String& file_name) {
+    auto text = io2::File::read_text_file(file_name);
+    y_try_discard(text);
+
+    core::Vector<CameraKey> keys;
+    std::string_view lines = text.unwrap();
+    while(!lines.empty()) {
+        const usize end = std::min(lines.find('\n'), lines.size());
+        const core::String line = lines.substr(0, end);
+        lines.remove_prefix(std::min(end + 1, lines.size()));
+
+        CameraKey key;
+        if(std::sscanf(line.data(), "%f %f %f %f %f %f",
+                &key.position.x(), &key.position.y(), &key.position.z(),
+                &key.target.x(), &key.target.y(), &key.target.z()) == 6) {
+            keys << key;
+        }
+    }
+
+    if(keys.is_empty()) {
+        return core::Err();
+    }
+    return core::Ok(std::move(keys));
+}
+
+static Camera camera_at(core::Span<CameraKey> path, usize frame) {
+    const float t = frame_count > 1 ? float(frame) / float(frame_count - 1) : 0.0f;
+
+    CameraKey key;
+    if(path.is_empty()) {
+        const float angle = t * 2.0f * math::pi<float>;
+        key.position = math::Vec3(std::cos(angle), std::sin(angle), 0.5f) * orbit_radius;
+    } else {
+        const float pos = t * float(path.size() - 1);
+        const usize index = std::min(usize(pos), path.size() - 1);
+        const usize next = std::min(index + 1, path.size() - 1);
+        const float f = pos - float(index);
+        key.position = path[index].position * (1.0f - f) + path[next].position * f;
+        key.target = path[index].target * (1.0f - f) + path[next].target * f;
+    }
+
+    const float aspect = float(render_size.x()) / float(render_size.y());
+    return Camera(
+        math::look_at(key.position, key.target, math::Vec3(0.0f, 0.0f, 1.0f)),
+        math::perspective(math::to_rad(60.0f), aspect, 0.1f)
+    );
+}
+
+
+
+// ---------------------------------------------- STATS ----------------------------------------------
+
+struct Stat {
+    double total = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    usize count = 0;
+
+    void add(double value) {
+        min = count ? std::min(min, value) : value;
+        max = count ? std::max(max, value) : value;
+        total += value;
+        ++count;
+    }
+
+    double avg() const {
+        return count ? total / double(count) : 0.0;
+    }
+};
+
+struct PassStats {
+    core::String name;
+    Stat cpu_ms;
+    Stat gpu_ms;
+};
+
+struct BenchmarkStats {
+    core::Vector<PassStats> passes;
+
+    Stat frame_ms;
+    Stat update_ms;
+    Stat record_ms;
+
+    Stat draw_calls;
+    Stat indirect_draws;
+    Stat recorded_triangles;
+    Stat visible_instances;
+    Stat visible_triangles;
+
+    Stat transient_mb;
+    Stat frame_arena_allocations;
+    Stat frame_arena_kb;
+    Stat allocations;
+
+    PassStats& pass(std::string_view name) {
+        for(PassStats& p : passes) {
+            if(p.name == name) {
+                return p;
+            }
+        }
+        return passes.emplace_back(PassStats{name});
+    }
+};
+
+static void add_timings(BenchmarkStats& stats, core::Span<CmdTimingRecorder::Event> events) {
+    const double tick_to_ms = device_properties().timestamp_period * ns_to_ms;
+
+    core::Vector<usize> starts;
+    for(usize i = 0; i != events.size(); ++i) {
+        switch(events[i].type) {
+            case CmdTimingRecorder::EventType::BeginZone:
+                starts << i;
+            break;
+
+            case CmdTimingRecorder::EventType::EndZone:
+                if(!starts.is_empty()) {
+                    const CmdTimingRecorder::Event& begin = events[starts.pop()];
+                    PassStats& pass = stats.pass(begin.name);
+                    pass.cpu_ms.add((events[i].cpu_nanos - begin.cpu_nanos) * ns_to_ms);
+                    pass.gpu_ms.add((events[i].gpu_timestamp.timestamp() - begin.gpu_timestamp.timestamp()) * tick_to_ms);
+                }
+            break;
+        }
+    }
+}
+
+static u64 total_allocations() {
+    u64 total = 0;
+    for(usize i = 0; i != usize(MemoryTag::Max); ++i) {
+        total += memory_tracking::tag_stats(MemoryTag(i)).total_allocations;
+    }
+    return total;
+}
+
+static void count_visible(BenchmarkStats& stats, const ecs::EntityWorld& world, const Camera& camera) {
+    const OctreeSystem* octree = world.find_system<OctreeSystem>();
+    if(!octree) {
+        return;
+    }
+
+    u64 instances = 0;
+    u64 triangles = 0;
+    for(const ecs::EntityId id : octree->find_entities(camera)) {
+        if(const StaticMeshComponent* comp = world.component<StaticMeshComponent>(id)) {
+            if(!comp->mesh().is_loaded() || comp->mesh().is_empty()) {
+                continue;
+            }
+            ++instances;
+            for(const MeshDrawCommand& sub_mesh : comp->mesh()->sub_meshes()) {
+                triangles += sub_mesh.index_count / 3;
+            }
+        }
+    }
+
+    stats.visible_instances.add(double(instances));
+    stats.visible_triangles.add(double(triangles));
+}
+
+
+
+// ---------------------------------------------- REPORT ----------------------------------------------
+
+static void write_stat(core::String& out, std::string_view name, const Stat& stat, bool last = false) {
+    fmt_into(out, "\"{}\":{{\"avg\":{:.4f},\"min\":{:.4f},\"max\":{:.4f}}}{}", name, stat.avg(), stat.min, stat.max, last ? "" : ",");
+}
+
+static core::String json_report(const BenchmarkStats& stats) {
+    core::String out;
+    fmt_into(out, "{{\n\"world\":\"{}\",\n\"frames\":{},\n\"warmup_frames\":{},\n\"width\":{},\n\"height\":{},\n",
+        world_file, frame_count, warmup_frames, render_size.x(), render_size.y());
+
+    out += "\"frame\":{";
+    write_stat(out, "cpu_ms", stats.frame_ms);
+    write_stat(out, "update_ms", stats.update_ms);
+    write_stat(out, "record_ms", stats.record_ms, true);
+    out += "},\n\"draws\":{";
+    write_stat(out, "draw_calls", stats.draw_calls);
+    write_stat(out, "indirect_draws", stats.indirect_draws);
+    write_stat(out, "recorded_triangles", stats.recorded_triangles);
+    write_stat(out, "visible_instances", stats.visible_instances);
+    write_stat(out, "visible_triangles", stats.visible_triangles, true);
+    out += "},\n\"memory\":{";
+    write_stat(out, "transient_mb", stats.transient_mb);
+    write_stat(out, "frame_arena_allocations", stats.frame_arena_allocations);
+    write_stat(out, "frame_arena_kb", stats.frame_arena_kb);
+    write_stat(out, "allocations", stats.allocations, true);
+    out += "},\n\"passes\":[";
+
+    for(usize i = 0; i != stats.passes.size(); ++i) {
+        const PassStats& pass = stats.passes[i];
+        fmt_into(out, "{}\n{{\"name\":\"{}\",", i ? "," : "", pass.name);
+        write_stat(out, "cpu_ms", pass.cpu_ms);
+        write_stat(out, "gpu_ms", pass.gpu_ms, true);
+        out += "}";
+    }
+    out += "\n]\n}\n";
+
+    return out;
+}
+
+
+
+// ---------------------------------------------- BENCHMARK ----------------------------------------------
+
+static core::Result<void> load_world(ecs::EntityWorld& world) {
+    auto file = io2::File::open(world_file);
+    y_try_discard(file);
+
+    serde3::ReadableArchive arc(file.unwrap(), serde3::DeserializationFlags::DontPropagatePolyFailure);
+    if(auto r = world.load_state(arc); !r) {
+        log_msg(fmt("Unable to load world: {} (for {})", serde3::error_msg(r.error()), r.error().member), Log::Error);
+        return core::Err();
+    }
+    return core::Ok();
+}
+
+// Builds a grid of cubes using only device resources, so the benchmark can run without any asset store
+static void create_grid_world(ecs::EntityWorld& world) {
+    const float spacing = 2.0f;
+    const float offset = float(grid_size - 1) * spacing * 0.5f;
+    for(usize y = 0; y != grid_size; ++y) {
+        for(usize x = 0; x != grid_size; ++x) {
+            const ecs::EntityId id = world.create_entity();
+            world.add_or_replace_component<StaticMeshComponent>(id, device_resources()[DeviceResources::CubeMesh], device_resources()[DeviceResources::EmptyMaterial]);
+            world.add_or_replace_component<TransformableComponent>(id)->set_position(math::Vec3(float(x) * spacing - offset, float(y) * spacing - offset, 0.0f));
+        }
+    }
+}
+
+static BenchmarkStats run_benchmark(ecs::EntityWorld& world, core::Span<CameraKey> path) {
+    BenchmarkStats stats;
+
+    RendererSettings settings;
+    settings.tone_mapping.auto_exposure = false;
+
+    auto resource_pool = std::make_shared<FrameGraphResourcePool>();
+    core::Chrono update_timer;
+
+    for(usize i = 0; i != warmup_frames + frame_count; ++i) {
+        const bool measured = i >= warmup_frames;
+        const Camera camera = camera_at(path, measured ? i - warmup_frames : 0);
+
+        const u64 allocs_before = total_allocations();
+        RenderPassRecorder::reset_draw_stats();
+
+        core::Chrono frame_timer;
+
+        world.tick();
+        world.update(float(update_timer.reset().to_secs()));
+        const double update_ms = frame_timer.elapsed().to_millis();
+
+        CmdBufferRecorder recorder = create_disposable_cmd_buffer();
+        CmdTimingRecorder time_rec(recorder);
+        {
+            const SceneView view(&world, camera);
+
+            FrameGraph graph(resource_pool);
+            DefaultRenderer::create(graph, view, render_size, settings);
+            graph.render(recorder, &time_rec);
+        }
+        const double record_ms = frame_timer.elapsed().to_millis() - update_ms;
+
+        recorder.submit().wait();
+        const double frame_ms = frame_timer.elapsed().to_millis();
+
+        const RenderPassRecorder::DrawStats draws = RenderPassRecorder::reset_draw_stats();
+        const core::FrameArena::FrameStats arena = core::FrameArena::next_frame();
+        const u64 allocs = total_allocations() - allocs_before;
+
+        if(measured) {
+            add_timings(stats, time_rec.events());
+            count_visible(stats, world, camera);
+
+            stats.frame_ms.add(frame_ms);
+            stats.update_ms.add(update_ms);
+            stats.record_ms.add(record_ms);
+
+            stats.draw_calls.add(double(draws.draw_calls));
+            stats.indirect_draws.add(double(draws.indirect_draws));
+            stats.recorded_triangles.add(double(draws.triangles));
+
+            stats.transient_mb.add(double(resource_pool->allocated_byte_size()) / (1024.0 * 1024.0));
+            stats.frame_arena_allocations.add(double(arena.allocations));
+            stats.frame_arena_kb.add(double(arena.allocated_bytes) / 1024.0);
+            stats.allocations.add(double(allocs));
+        }
+    }
+
+    return stats;
+}
+
+int main(int argc, char** argv) {
+    concurrent::set_thread_name("Main thread");
+
+    if(!parse_args(argc, argv)) {
+        log_msg("Usage: renderer_benchmark [--store dir] [--world file | --grid N] [--camera file] [--output file] [--frames N] [--warmup N] [--size WxH] [--radius R] [--debug]");
+        return 1;
+    }
+
+    core::Vector<CameraKey> camera_path;
+    if(!camera_file.is_empty()) {
+        auto path = load_camera_path(camera_file);
+        if(!path) {
+            log_msg(fmt("Unable to load camera path from \"{}\"", camera_file), Log::Error);
+            return 1;
+        }
+        camera_path = std::move(path.unwrap());
+    }
+
+    Instance instance(debug_instance ? DebugParams::debug() : DebugParams::none());
+
+    init_device(instance);
+    y_defer(destroy_device());
+
+    core::String report;
+    {
+        auto store = std::make_shared<FolderAssetStore>(store_dir);
+        store->set_compressed(AssetType::Mesh);
+        store->set_compressed(AssetType::Animation);
+
+        AssetLoader loader(store, AssetLoadingFlags::SkipFailedDependenciesBit, 4);
+
+        ecs::EntityWorld world;
+        world.add_system<AssetLoaderSystem>(loader);
+        world.add_system<TransformHierarchySystem>();
+        world.add_system<AABBUpdateSystem>();
+        world.add_system<OctreeSystem>();
+        world.add_system<ScriptSystem>();
+        world.add_system<RendererSystem>();
+
+        if(grid_size) {
+            world_file = fmt("grid_{}x{}", grid_size, grid_size);
+            create_grid_world(world);
+        } else if(!load_world(world)) {
+            log_msg(fmt("Unable to load \"{}\"", world_file), Log::Error);
+            return 1;
+        }
+
+        {
+            core::Chrono timer;
+            do {
+                world.tick();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } while(loader.is_loading());
+            log_msg(fmt("Assets loaded in {:.1f}ms", timer.elapsed().to_millis()));
+        }
+
+        report = json_report(run_benchmark(world, camera_path));
+    }
+
+    auto file = io2::File::create(output_file);
+    if(!file || !file.unwrap().write_array(report.data(), report.size()) || !file.unwrap().flush()) {
+        log_msg(fmt("Unable to write \"{}\"", output_file), Log::Error);
+        return 1;
+    }
+
+    log_msg(fmt("Benchmark results written to \"{}\"", output_file));
+
+    return 0;
+}
+
+
+
+// Feeds the allocation counts of the report
+void* operator new(std::size_t size) {
+    return memory_tracking::tracked_alloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t al) {
+    return memory_tracking::tracked_alloc(size, std::size_t(al));
+}
+
+void operator delete(void* ptr) noexcept {
+    memory_tracking::tracked_free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    memory_tracking::tracked_free(ptr);
+}
+
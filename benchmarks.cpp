@@ -0,0 +1,100 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/benchmark.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <charconv>
+
+using namespace y;
+
+template<typename T>
+static bool parse_number(std::string_view str, T& value) {
+    const auto [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    return ec == std::errc() && end == str.data() + str.size();
+}
+
+int main(int argc, char** argv) {
+    test::BenchmarkSettings settings;
+    core::String save_file;
+    core::String baseline_file;
+    double threshold = 0.1;
+
+    const core::Span<const char*> args(argv + 1, argc - 1);
+    for(usize i = 0; i != args.size(); ++i) {
+        const std::string_view arg = args[i];
+        const std::string_view value = i + 1 < args.size() ? args[++i] : "";
+
+        bool ok = !value.empty();
+        if(arg == "--filter") {
+            settings.filter = value;
+        } else if(arg == "--samples") {
+            ok &= parse_number(value, settings.samples);
+        } else if(arg == "--min-time") {
+            ok &= parse_number(value, settings.min_sample_ms);
+        } else if(arg == "--save") {
+            save_file = value;
+        } else if(arg == "--baseline") {
+            baseline_file = value;
+        } else if(arg == "--threshold") {
+            ok &= parse_number(value, threshold);
+            threshold /= 100.0;
+        } else {
+            ok = false;
+        }
+
+        if(!ok) {
+            log_msg(fmt("Invalid argument: {} {}", arg, value), Log::Error);
+            log_msg("Usage: benchmarks [--filter str] [--samples N] [--min-time ms] [--save file] [--baseline file] [--threshold percent]");
+            return 1;
+        }
+    }
+
+#ifdef Y_DEBUG
+    log_msg("Benchmarks built with Y_DEBUG, timings are not representative.", Log::Warning);
+#endif
+
+    const core::Vector<test::BenchmarkResult> results = test::run_benchmarks(settings);
+
+    if(!save_file.is_empty() && !test::save_results(save_file, results)) {
+        log_msg(fmt("Unable to write \"{}\"", save_file), Log::Error);
+        return 1;
+    }
+
+    if(!baseline_file.is_empty()) {
+        auto baseline = test::load_results(baseline_file);
+        if(!baseline) {
+            log_msg(fmt("Unable to read \"{}\"", baseline_file), Log::Error);
+            return 1;
+        }
+
+        if(const usize regressions = test::compare_results(results, baseline.unwrap(), threshold)) {
+            log_msg(fmt("{} benchmarks regressed by more than {}%", regressions, threshold * 100.0), Log::Error);
+            return 1;
+        }
+        log_msg("No regression");
+    }
+
+    return 0;
+}
+
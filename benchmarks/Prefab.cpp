@@ -0,0 +1,72 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+#include <yave/components/TransformableComponent.h>
+
+#include <y/test/benchmark.h>
+#include <y/utils/format.h>
+
+// Spawns a 4 entities prefab 1k, 10k and 100k times, with the batched path and one entity at a time.
+
+namespace {
+using namespace y;
+using namespace y::test;
+using namespace yave;
+
+ecs::EntityPrefab create_prefab() {
+    ecs::EntityPrefab prefab(ecs::EntityId::dummy(0));
+    prefab.add(TransformableComponent());
+
+    for(u32 i = 1; i != 4; ++i) {
+        auto child = std::make_unique<ecs::EntityPrefab>(ecs::EntityId::dummy(i));
+        child->add(TransformableComponent(math::Transform<>(math::Vec3(float(i), 0.0f, 0.0f))));
+        prefab.add_child(std::move(child));
+    }
+
+    return prefab;
+}
+
+y_bench_func("Prefab instantiation") {
+    const ecs::EntityPrefab prefab = create_prefab();
+    const ecs::PrefabSpawnPlan plan(prefab);
+
+    for(const usize count : {1'000_uu, 10'000_uu, 100'000_uu}) {
+        std::unique_ptr<ecs::EntityWorld> world;
+        const auto reset_world = [&] {
+            world = nullptr;
+            world = std::make_unique<ecs::EntityWorld>();
+        };
+
+        bench.run_with_setup(fmt_to_owned("instantiate {}", count), reset_world, [&] {
+            do_not_optimize(world->instantiate(plan, count));
+        });
+
+        bench.run_with_setup(fmt_to_owned("create_entity {}", count), reset_world, [&] {
+            for(usize i = 0; i != count; ++i) {
+                do_not_optimize(world->create_entity(prefab));
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,110 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/test/benchmark.h>
+
+// Iterates queries matching 1, 3 and 6 components over 1M entities, with and without a query cache.
+// The first component is on every entity, the others on a decreasing fraction of them.
+
+namespace {
+using namespace y;
+using namespace y::test;
+using namespace yave;
+
+template<usize I>
+struct BenchComponent {
+    float value = float(I);
+};
+
+using C0 = BenchComponent<0>;
+using C1 = BenchComponent<1>;
+using C2 = BenchComponent<2>;
+using C3 = BenchComponent<3>;
+using C4 = BenchComponent<4>;
+using C5 = BenchComponent<5>;
+
+static constexpr usize entity_count = 1'000'000;
+
+template<usize I>
+void add_component(ecs::EntityWorld& world, core::Span<ecs::EntityId> ids) {
+    for(usize i = 0; i != ids.size(); ++i) {
+        // 100%, 90%, 80%... of the entities
+        if(i % 10 >= I) {
+            world.add_or_replace_component<BenchComponent<I>>(ids[i]);
+        }
+    }
+}
+
+template<typename Q>
+float sum(Q&& query) {
+    float total = 0.0f;
+    for(auto&& comps : query.components()) {
+        std::apply([&](const auto&... c) { ((total += c.value), ...); }, comps);
+    }
+    return total;
+}
+
+y_bench_func("ECS queries") {
+    ecs::EntityWorld world;
+
+    auto ids = core::Vector<ecs::EntityId>::with_capacity(entity_count);
+    for(usize i = 0; i != entity_count; ++i) {
+        ids << world.create_entity();
+    }
+
+    add_component<0>(world, ids);
+    add_component<1>(world, ids);
+    add_component<2>(world, ids);
+    add_component<3>(world, ids);
+    add_component<4>(world, ids);
+    add_component<5>(world, ids);
+
+    const ecs::EntityWorld& const_world = world;
+
+    bench.run("1 component", [&] {
+        do_not_optimize(sum(const_world.query<const C0>()));
+    });
+
+    bench.run("3 components", [&] {
+        do_not_optimize(sum(const_world.query<const C0, const C1, const C2>()));
+    });
+
+    bench.run("6 components", [&] {
+        do_not_optimize(sum(const_world.query<const C0, const C1, const C2, const C3, const C4, const C5>()));
+    });
+
+    bench.run("1 component (cached)", [&] {
+        do_not_optimize(sum(const_world.cached_query<const C0>()));
+    });
+
+    bench.run("3 components (cached)", [&] {
+        do_not_optimize(sum(const_world.cached_query<const C0, const C1, const C2>()));
+    });
+
+    bench.run("6 components (cached)", [&] {
+        do_not_optimize(sum(const_world.cached_query<const C0, const C1, const C2, const C3, const C4, const C5>()));
+    });
+}
+
+}
@@ -27,7 +27,9 @@ SOFTWARE.
 #include <yave/graphics/shaders/ComputeProgram.h>
 
 #include <yave/material/MaterialTemplate.h>
+#include <yave/material/MaterialCompiler.h>
 
+#include <y/core/ScratchPad.h>
 #include <y/io2/File.h>
 
 #include <y/utils/format.h>
@@ -122,6 +124,12 @@ void EditorResources::load_resources() {
 
         _material_templates[i] = MaterialTemplate(std::move(template_data));
     }
+
+    core::ScratchPad<const MaterialTemplate*> templates(template_count);
+    for(usize i = 0; i != template_count; ++i) {
+        templates[i] = &_material_templates[i];
+    }
+    MaterialCompiler::precompile(templates);
 }
 
 const ComputeProgram& EditorResources::operator[](ComputePrograms i) const {
@@ -36,6 +36,7 @@ SOFTWARE.
 #include <yave/components/AtmosphereComponent.h>
 
 #include <yave/systems/AssetLoaderSystem.h>
+#include <yave/systems/TransformHierarchySystem.h>
 #include <yave/systems/AABBUpdateSystem.h>
 #include <yave/systems/OctreeSystem.h>
 #include <yave/systems/ScriptSystem.h>
@@ -53,6 +54,7 @@ editor_action("Remove all entities", [] { current_world().remove_all_entities();
 
 EditorWorld::EditorWorld(AssetLoader& loader) {
     add_system<AssetLoaderSystem>(loader);
+    add_system<TransformHierarchySystem>();
     add_system<AABBUpdateSystem>();
     add_system<OctreeSystem>();
     add_system<ScriptSystem>();
@@ -67,6 +67,11 @@ struct UiSettings {
 };
 
 struct PerfSettings {
+    // Mesh data moved per frame while the mesh buffers are fragmented
+    u64 mesh_defrag_budget = 4 * 1024 * 1024;
+    float mesh_defrag_threshold = 0.25f;
+
+    y_reflect(PerfSettings, mesh_defrag_budget, mesh_defrag_threshold)
 };
 
 struct DebugSettings {
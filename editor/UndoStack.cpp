@@ -25,12 +25,21 @@ SOFTWARE.
 #include "EditorWorld.h"
 #include "Widget.h"
 
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/io2/Buffer.h>
+#include <y/serde3/archives.h>
+
 #include <y/utils/log.h>
+#include <y/utils/format.h>
 
 #include <editor/utils/ui.h>
 
 namespace editor {
 
+editor_action_shortcut("Undo", Key::Ctrl + Key::Z, [] { undo_stack().undo(); }, "Edit")
+editor_action_shortcut("Redo", Key::Ctrl + Key::Y, [] { undo_stack().redo(); }, "Edit")
+
 
 class UndoStackWidget : public Widget {
 
@@ -41,18 +50,25 @@ class UndoStackWidget : public Widget {
         }
 
         void on_gui() override {
-            const auto items = undo_stack().items();
-            // const usize top = undo_stack().stack_top();
+            const UndoStack& stack = undo_stack();
+            const usize top = stack.stack_top();
 
-            ImGui::Text("%u items in stack", u32(items.size()));
+            ImGui::Text("%u items in stack (%.1f KB)", u32(stack.size()), stack.memory_usage() / 1024.0f);
+
+            if(ImGui::BeginTable("##undostack", 3)) {
+                for(usize i = 0; i != stack.size(); ++i) {
+                    const UndoStack::Item& item = stack._items[i];
 
-            if(ImGui::BeginTable("##undostack", 2)) {
-                for(usize i = 0; items.size(); ++i) {
-                    // const bool is_current =  i + 1 == top;
                     imgui::table_begin_next_row();
-                    ImGui::TextUnformatted(items[i].name.data());
+                    if(i < top) {
+                        ImGui::TextUnformatted(item.name.data());
+                    } else {
+                        ImGui::TextDisabled("%s", item.name.data());
+                    }
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u components", u32(item.deltas.size()));
                     ImGui::TableNextColumn();
-                    ImGui::TextUnformatted(fmt_c_str("{:#08x}", items[i].id.index()));
+                    ImGui::Text("%u bytes", u32(item.byte_size));
                 }
 
                 ImGui::EndTable();
@@ -61,9 +77,394 @@ class UndoStackWidget : public Widget {
 };
 
 
+
+static core::Vector<u8> serialize_component(const ecs::EntityWorld& world, ecs::EntityId id, ecs::ComponentTypeIndex type_id) {
+    if(!world.exists(id) || !world.has(id, type_id)) {
+        return {};
+    }
+
+    io2::Buffer buffer;
+    serde3::WritableArchive arc(buffer);
+    if(!world.save_component(id, type_id, arc)) {
+        log_msg(fmt("Unable to serialize {} for undo", world.component_type_name(type_id)), Log::Error);
+        return {};
+    }
+
+    return core::Vector<u8>(core::Span<u8>(buffer.data(), buffer.size()));
+}
+
+static bool apply_state(ecs::EntityWorld& world, ecs::EntityId id, ecs::ComponentTypeIndex type_id, core::Vector<u8> state) {
+    if(!world.exists(id)) {
+        return false;
+    }
+
+    if(state.is_empty()) {
+        world.remove_component(id, type_id);
+        return true;
+    }
+
+    // Existing components are loaded in place, replacing them would lose the state that isn't serialized
+    io2::Buffer buffer(std::move(state));
+    serde3::ReadableArchive arc(buffer);
+    return world.load_component(id, type_id, arc).is_ok();
+}
+
+static core::Vector<ecs::ComponentTypeIndex> component_types(const EditorWorld& world, ecs::EntityId id) {
+    core::Vector<ecs::ComponentTypeIndex> types;
+    for(const auto& [name, info] : EditorWorld::component_types()) {
+        if(world.has(id, info.type_id)) {
+            types << info.type_id;
+        }
+    }
+    return types;
+}
+
+static core::Vector<ecs::Tag> entity_tags(const EditorWorld& world, ecs::EntityId id) {
+    core::Vector<ecs::Tag> tags;
+    for(const ecs::Tag tag : world.tags()) {
+        // Selection isn't part of the history
+        if(!tag.is_implicit() && tag != ecs::tags::selected && world.has_tag(id, tag)) {
+            tags << tag;
+        }
+    }
+    return tags;
+}
+
+
+
+usize EntityChange::byte_size() const {
+    return sizeof(EntityChange) + children.size() * sizeof(ecs::EntityId) + tags.size() * sizeof(ecs::Tag);
+}
+
+
+
+
+// Runs closer than this are merged
+static constexpr usize min_run_gap = 8;
+
+ComponentDelta::ComponentDelta(ecs::EntityId id, ecs::ComponentTypeIndex type_id, core::Span<u8> before, core::Span<u8> after) : _id(id), _type_id(type_id) {
+    _full = before.size() != after.size() || before.is_empty();
+    if(_full) {
+        _before = core::Vector<u8>(before);
+        _after = core::Vector<u8>(after);
+        return;
+    }
+
+    _state_size = u32(before.size());
+
+    usize i = 0;
+    while(i != before.size()) {
+        if(before[i] == after[i]) {
+            ++i;
+            continue;
+        }
+
+        usize end = i + 1;
+        for(usize same = 0; end != before.size() && same < min_run_gap; ++end) {
+            same = before[end] == after[end] ? same + 1 : 0;
+        }
+        while(before[end - 1] == after[end - 1]) {
+            --end;
+        }
+
+        _runs.emplace_back(u32(i), u32(end - i));
+        for(usize k = i; k != end; ++k) {
+            _before.emplace_back(before[k]);
+            _after.emplace_back(after[k]);
+        }
+
+        i = end;
+    }
+}
+
+ecs::EntityId ComponentDelta::id() const {
+    return _id;
+}
+
+ecs::ComponentTypeIndex ComponentDelta::type_id() const {
+    return _type_id;
+}
+
+bool ComponentDelta::is_empty() const {
+    return _full ? _before == _after : _runs.is_empty();
+}
+
+usize ComponentDelta::byte_size() const {
+    return sizeof(ComponentDelta) + _runs.size() * sizeof(Run) + _before.size() + _after.size();
+}
+
+static core::Result<core::Vector<u8>> patch(core::Span<u8> state, usize state_size, core::Span<u8> run_bytes, auto&& runs) {
+    if(state.size() != state_size) {
+        return core::Err();
+    }
+
+    core::Vector<u8> patched(state);
+    const u8* bytes = run_bytes.data();
+    for(const auto& run : runs) {
+        std::copy_n(bytes, run.size, patched.data() + run.offset);
+        bytes += run.size;
+    }
+
+    return core::Ok(std::move(patched));
+}
+
+core::Result<core::Vector<u8>> ComponentDelta::before(core::Span<u8> after) const {
+    if(_full) {
+        if(after.size() != _after.size()) {
+            return core::Err();
+        }
+        return core::Ok(core::Vector<u8>(_before));
+    }
+    return patch(after, _state_size, _before, _runs);
+}
+
+core::Result<core::Vector<u8>> ComponentDelta::after(core::Span<u8> before) const {
+    if(_full) {
+        if(before.size() != _before.size()) {
+            return core::Err();
+        }
+        return core::Ok(core::Vector<u8>(_after));
+    }
+    return patch(before, _state_size, _after, _runs);
+}
+
+
+
+
 UndoStack::UndoStack() {
 }
 
+void UndoStack::begin_edit(std::string_view name) {
+    y_debug_assert(!_editing);
+
+    _editing = true;
+    _edit_name = name;
+    _snapshots.make_empty();
+    _entities.make_empty();
+}
+
+void UndoStack::record(const EditorWorld& world, ecs::EntityId id, ecs::ComponentTypeIndex type_id) {
+    y_debug_assert(_editing);
+
+    for(const Snapshot& snapshot : _snapshots) {
+        if(snapshot.id == id && snapshot.type_id == type_id) {
+            return;
+        }
+    }
+
+    _snapshots.emplace_back(id, type_id, serialize_component(world, id, type_id));
+}
+
+void UndoStack::record_created(const EditorWorld& world, ecs::EntityId id) {
+    y_debug_assert(_editing);
+
+    {
+        EntityChange& change = _entities.emplace_back();
+        change.id = id;
+        change.parent = world.parent(id);
+        change.created = true;
+    }
+
+    // Parents are always recorded before their children
+    for(const ecs::EntityId child : world.children(id)) {
+        record_created(world, child);
+    }
+}
+
+void UndoStack::record_removed(const EditorWorld& world, ecs::EntityId id) {
+    y_debug_assert(_editing);
+
+    for(const ecs::ComponentTypeIndex type_id : component_types(world, id)) {
+        record(world, id, type_id);
+    }
+
+    EntityChange& change = _entities.emplace_back();
+    change.id = id;
+    change.parent = world.parent(id);
+    change.children = core::Vector<ecs::EntityId>::from_range(world.children(id));
+    change.tags = entity_tags(world, id);
+}
+
+void UndoStack::end_edit(const EditorWorld& world) {
+    y_profile();
+    y_debug_assert(_editing);
+
+    _editing = false;
+
+    // Created entities are diffed against an empty state, whatever was recorded for them during the edit
+    for(EntityChange& change : _entities) {
+        if(!change.created || !world.exists(change.id)) {
+            continue;
+        }
+
+        change.tags = entity_tags(world, change.id);
+        for(const ecs::ComponentTypeIndex type_id : component_types(world, change.id)) {
+            const auto it = std::find_if(_snapshots.begin(), _snapshots.end(), [&](const Snapshot& s) { return s.id == change.id && s.type_id == type_id; });
+            if(it == _snapshots.end()) {
+                _snapshots.emplace_back(change.id, type_id, core::Vector<u8>());
+            } else {
+                it->state.make_empty();
+            }
+        }
+    }
+
+    // When merging, the states from before the merged item are rebuilt from the snapshots
+    Item* merged = mergeable_item();
+    auto befores = core::Vector<core::Vector<u8>>::with_capacity(_snapshots.size());
+    for(const Snapshot& snapshot : _snapshots) {
+        if(!merged) {
+            break;
+        }
+
+        const auto it = std::find_if(merged->deltas.begin(), merged->deltas.end(), [&](const ComponentDelta& d) { return d.id() == snapshot.id && d.type_id() == snapshot.type_id; });
+        if(it == merged->deltas.end()) {
+            befores.emplace_back(snapshot.state);
+        } else if(auto before = it->before(snapshot.state)) {
+            befores.emplace_back(std::move(before.unwrap()));
+        } else {
+            merged = nullptr;
+        }
+    }
+
+    Item item;
+    item.name = _edit_name;
+    for(usize i = 0; i != _snapshots.size(); ++i) {
+        const Snapshot& snapshot = _snapshots[i];
+        const core::Vector<u8> after = serialize_component(world, snapshot.id, snapshot.type_id);
+        ComponentDelta delta(snapshot.id, snapshot.type_id, merged ? befores[i] : snapshot.state, after);
+        if(!delta.is_empty()) {
+            item.byte_size += delta.byte_size();
+            item.deltas.emplace_back(std::move(delta));
+        }
+    }
+
+    _snapshots.make_empty();
+
+    for(EntityChange& change : _entities) {
+        item.byte_size += change.byte_size();
+        item.entities.emplace_back(std::move(change));
+    }
+    _entities.make_empty();
+
+    if(merged) {
+        _memory -= _items.last().byte_size;
+        _items.pop_back();
+        --_top;
+    }
+
+    if(!item.deltas.is_empty() || !item.entities.is_empty()) {
+        push(std::move(item));
+    }
+
+    _sealed = false;
+}
+
+void UndoStack::seal() {
+    _sealed = true;
+}
+
+UndoStack::Item* UndoStack::mergeable_item() {
+    if(_sealed || !_top || _top != _items.size() || !_entities.is_empty()) {
+        return nullptr;
+    }
+
+    Item& last = _items.last();
+    if(last.name != _edit_name || !last.entities.is_empty()) {
+        return nullptr;
+    }
+
+    for(const ComponentDelta& delta : last.deltas) {
+        const bool recorded = std::any_of(_snapshots.begin(), _snapshots.end(), [&](const Snapshot& s) { return s.id == delta.id() && s.type_id == delta.type_id(); });
+        if(!recorded) {
+            return nullptr;
+        }
+    }
+
+    return &last;
+}
+
+void UndoStack::push(Item item) {
+    while(_items.size() != _top) {
+        _memory -= _items.last().byte_size;
+        _items.pop_back();
+    }
+
+    _memory += item.byte_size;
+    _items.emplace_back(std::move(item));
+    ++_top;
+
+    while(_memory > _budget && _items.size() > 1) {
+        _memory -= _items.first().byte_size;
+        _items.pop_front();
+        --_top;
+    }
+}
+
+void UndoStack::apply_item(EditorWorld& world, const Item& item, bool undo) {
+    y_profile();
+
+    const usize entity_count = item.entities.size();
+    auto entity_change = [&](usize i) -> const EntityChange& {
+        return item.entities[undo ? entity_count - i - 1 : i];
+    };
+
+    // Entities have to exist before their components are restored
+    for(usize i = 0; i != entity_count; ++i) {
+        if(const EntityChange& change = entity_change(i); change.created != undo) {
+            apply_entity_change(world, change, true);
+        }
+    }
+
+    for(usize i = 0; i != item.deltas.size(); ++i) {
+        const ComponentDelta& delta = item.deltas[undo ? item.deltas.size() - i - 1 : i];
+        const ecs::EntityId id = resolve(delta.id());
+
+        const core::Vector<u8> current = serialize_component(world, id, delta.type_id());
+        auto state = undo ? delta.before(current) : delta.after(current);
+        if(!state || !apply_state(world, id, delta.type_id(), std::move(state.unwrap()))) {
+            log_msg(fmt("Unable to {} \"{}\": entity has been modified", undo ? "undo" : "redo", item.name), Log::Error);
+        }
+    }
+
+    for(usize i = 0; i != entity_count; ++i) {
+        if(const EntityChange& change = entity_change(i); change.created == undo) {
+            apply_entity_change(world, change, false);
+        }
+    }
+}
+
+void UndoStack::apply_entity_change(EditorWorld& world, const EntityChange& change, bool create) {
+    if(!create) {
+        if(const ecs::EntityId id = resolve(change.id); world.exists(id)) {
+            world.remove_entity(id);
+        }
+        return;
+    }
+
+    const ecs::EntityId id = world.create_entity();
+    _remapped[resolve(change.id)] = id;
+
+    if(const ecs::EntityId parent = resolve(change.parent); world.exists(parent)) {
+        world.set_parent(id, parent);
+    }
+
+    for(const ecs::EntityId child : change.children) {
+        if(const ecs::EntityId c = resolve(child); world.exists(c)) {
+            world.set_parent(c, id);
+        }
+    }
+
+    for(const ecs::Tag& tag : change.tags) {
+        world.add_tag(id, tag);
+    }
+}
+
+ecs::EntityId UndoStack::resolve(ecs::EntityId id) const {
+    for(auto it = _remapped.find(id); it != _remapped.end(); it = _remapped.find(id)) {
+        id = it->second;
+    }
+    return id;
+}
 
 void UndoStack::undo() {
     if(!_top) {
@@ -72,8 +473,8 @@ void UndoStack::undo() {
     }
 
     --_top;
-    _items[_top].undo(current_world());
-
+    apply_item(current_world(), _items[_top], true);
+    _sealed = true;
 }
 
 void UndoStack::redo() {
@@ -82,20 +483,29 @@ void UndoStack::redo() {
         return;
     }
 
-    _items[_top].redo(current_world());
+    apply_item(current_world(), _items[_top], false);
     ++_top;
+    _sealed = true;
 }
 
-void UndoStack::add(Item item) {
-    while(_items.size() != _top) {
-        _items.pop();
-    }
-    _items.emplace_back(std::move(item));
-    ++_top;
+void UndoStack::clear() {
+    _items.make_empty();
+    _top = 0;
+    _memory = 0;
+    _sealed = true;
+    _remapped.make_empty();
 }
 
-core::Span<UndoStack::Item> UndoStack::items() const {
-    return _items;
+void UndoStack::set_memory_budget(usize budget) {
+    _budget = budget;
+}
+
+usize UndoStack::memory_usage() const {
+    return _memory;
+}
+
+usize UndoStack::size() const {
+    return _items.size();
 }
 
 usize UndoStack::stack_top() const {
@@ -103,4 +513,3 @@ usize UndoStack::stack_top() const {
 }
 
 }
-
@@ -25,38 +25,137 @@ SOFTWARE.
 #include <editor/editor.h>
 
 #include <yave/ecs/ecs.h>
+#include <yave/ecs/tags.h>
 
-#include <y/io2/Buffer.h>
+#include <y/core/RingQueue.h>
+#include <y/core/HashMap.h>
+#include <y/core/Result.h>
 
 namespace editor {
 
+// Binary difference between two serialized states of a component.
+// An empty state means that the entity doesn't have the component.
+class ComponentDelta {
+    public:
+        ComponentDelta() = default;
+        ComponentDelta(ecs::EntityId id, ecs::ComponentTypeIndex type_id, core::Span<u8> before, core::Span<u8> after);
+
+        ecs::EntityId id() const;
+        ecs::ComponentTypeIndex type_id() const;
+
+        bool is_empty() const;
+        usize byte_size() const;
+
+        // Rebuilds the state on the other side of the delta, fails if the given state doesn't match
+        core::Result<core::Vector<u8>> before(core::Span<u8> after) const;
+        core::Result<core::Vector<u8>> after(core::Span<u8> before) const;
+
+    private:
+        struct Run {
+            u32 offset = 0;
+            u32 size = 0;
+        };
+
+        ecs::EntityId _id;
+        ecs::ComponentTypeIndex _type_id = ecs::ComponentTypeIndex::invalid_index;
+
+        // States of the same size only store the runs that differ, other states are stored in full
+        bool _full = false;
+        u32 _state_size = 0;
+        core::Vector<Run> _runs;
+        core::Vector<u8> _before;
+        core::Vector<u8> _after;
+};
+
+// An entity created or removed by an edit, its components are recorded as deltas from or to an empty state
+struct EntityChange {
+    ecs::EntityId id;
+    ecs::EntityId parent;
+    core::Vector<ecs::EntityId> children;
+    core::Vector<ecs::Tag> tags;
+    bool created = false;
+
+    usize byte_size() const;
+};
+
 class UndoStack : NonMovable {
     public:
         struct Item {
             core::String name;
-            ecs::EntityId id;
-            std::function<void(EditorWorld&)> undo;
-            std::function<void(EditorWorld&)> redo;
+            core::Vector<EntityChange> entities;
+            core::Vector<ComponentDelta> deltas;
+            usize byte_size = 0;
         };
 
         UndoStack();
 
-        void add(Item item);
+        // Components recorded between begin_edit and end_edit are diffed as a single item.
+        // Consecutive edits with the same name on the same components are merged until seal is called.
+        void begin_edit(std::string_view name);
+        void record(const EditorWorld& world, ecs::EntityId id, ecs::ComponentTypeIndex type_id);
+        void end_edit(const EditorWorld& world);
+
+        // Call after creating the entity, its children are recorded as well
+        void record_created(const EditorWorld& world, ecs::EntityId id);
+
+        // Call before removing the entity, children are not removed with it and are recorded separately
+        void record_removed(const EditorWorld& world, ecs::EntityId id);
+
+        void seal();
+
+        template<typename T, typename F>
+        void edit(EditorWorld& world, std::string_view name, ecs::EntityId id, F&& func) {
+            begin_edit(name);
+            record(world, id, ecs::type_index<T>());
+            func();
+            end_edit(world);
+        }
 
         void undo();
         void redo();
 
-        core::Span<Item> items() const;
+        void clear();
+
+        // Oldest items are discarded once the stack uses more than budget bytes
+        void set_memory_budget(usize budget);
+        usize memory_usage() const;
+
+        usize size() const;
         usize stack_top() const;
 
     private:
         friend class UndoStackWidget;
 
-        core::Vector<Item> _items;
+        struct Snapshot {
+            ecs::EntityId id;
+            ecs::ComponentTypeIndex type_id;
+            core::Vector<u8> state;
+        };
+
+        Item* mergeable_item();
+        void push(Item item);
+
+        void apply_item(EditorWorld& world, const Item& item, bool undo);
+        void apply_entity_change(EditorWorld& world, const EntityChange& change, bool create);
+
+        // Entities recreated by undo or redo get new ids, items keep refering to the original ones
+        ecs::EntityId resolve(ecs::EntityId id) const;
+
+        core::RingQueue<Item> _items;
         usize _top = 0;
+
+        usize _memory = 0;
+        usize _budget = 64 * 1024 * 1024;
+
+        bool _sealed = true;
+        bool _editing = false;
+        core::String _edit_name;
+        core::Vector<Snapshot> _snapshots;
+        core::Vector<EntityChange> _entities;
+
+        core::FlatHashMap<ecs::EntityId, ecs::EntityId> _remapped;
 };
 
 }
 
 #endif // EDITOR_UNDOSTACK_H
-
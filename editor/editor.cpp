@@ -33,6 +33,7 @@ SOFTWARE.
 #include <yave/assets/AssetLoader.h>
 #include <yave/utils/DirectDraw.h>
 #include <yave/scene/SceneView.h>
+#include <yave/graphics/device/MeshAllocator.h>
 
 #include <y/io2/File.h>
 #include <y/serde3/archives.h>
@@ -109,7 +110,12 @@ void init_editor(ImGuiPlatform* platform, const Settings& settings) {
     application::undo_stack = std::make_unique<UndoStack>();
     application::resources = std::make_unique<EditorResources>();
     application::ui = std::make_unique<UiManager>();
-    application::asset_store = std::make_shared<FolderAssetStore>(store_dir);
+    {
+        auto store = std::make_shared<FolderAssetStore>(store_dir);
+        store->set_compressed(AssetType::Mesh);
+        store->set_compressed(AssetType::Animation);
+        application::asset_store = std::move(store);
+    }
     application::loader = std::make_unique<AssetLoader>(application::asset_store, AssetLoadingFlags::SkipFailedDependenciesBit, 4);
     application::thumbmail_renderer = std::make_unique<ThumbmailRenderer>(*application::loader);
     application::world = std::make_unique<EditorWorld>(*application::loader);
@@ -182,11 +188,22 @@ static void load_world_deferred() {
         log_msg("World was only partialy loaded", Log::Warning);
     }
 
+    undo_stack().clear();
     log_msg("World loaded");
 }
 
+static void defragment_meshes() {
+    const PerfSettings& settings = app_settings().perf;
+    const auto [vertex_frag, triangle_frag] = mesh_allocator().fragmentation();
+    if(std::max(vertex_frag, triangle_frag) > settings.mesh_defrag_threshold) {
+        mesh_allocator().defragment(settings.mesh_defrag_budget);
+    }
+}
+
 void post_tick() {
     y_profile();
+
+    defragment_meshes();
     if(application::deferred_actions & application::Save) {
         save_world_deferred();
     }
@@ -198,6 +215,7 @@ void post_tick() {
     if(application::deferred_actions & application::New) {
         application::world = std::make_unique<EditorWorld>(*application::loader);
         application::default_scene_view = SceneView(application::world.get());
+        undo_stack().clear();
         log_msg("New world");
     }
 
@@ -32,6 +32,8 @@ SOFTWARE.
 
 #include <y/utils/log.h>
 #include <y/utils/format.h>
+#include <y/utils/memory_tracking.h>
+#include <y/utils/trace.h>
 
 #ifdef Y_OS_WIN
 #include <windows.h>
@@ -42,6 +44,7 @@ using namespace editor;
 static bool debug_instance = is_debug_defined;
 static bool multi_viewport = false;
 static bool run_tests = false;
+static bool capture_trace = false;
 
 
 static void parse_args(int argc, char** argv) {
@@ -56,6 +59,8 @@ static void parse_args(int argc, char** argv) {
             multi_viewport = true;
         } else if(arg == "--run-tests") {
             run_tests = true;
+        } else if(arg == "--trace") {
+            capture_trace = true;
         } else if(arg == "--errbreak") {
 #ifdef Y_DEBUG
             core::result::break_on_error = true;
@@ -90,9 +95,12 @@ static Instance create_instance() {
 
 int main(int argc, char** argv) {
     concurrent::set_thread_name("Main thread");
+    y_memory_tag(MemoryTag::Editor);
 
     parse_args(argc, argv);
 
+    trace::set_enabled(capture_trace);
+
     if(!crashhandler::setup_handler()) {
         log_msg("Unable to setup crash handler.", Log::Warning);
     }
@@ -116,6 +124,15 @@ int main(int argc, char** argv) {
 
     settings.save();
 
+    memory_tracking::log_report();
+
+    if(capture_trace) {
+        trace::set_enabled(false);
+        if(!trace::save("trace.json")) {
+            log_msg("Unable to write trace.json", Log::Error);
+        }
+    }
+
     log_msg("exiting...");
 
     return 0;
@@ -115,14 +115,14 @@ static void render_editor_entities(RenderPassRecorder& recorder, const FrameGrap
 
         {
             std::tie(uv, size) = imgui::compute_glyph_uv_size(ICON_FA_LIGHTBULB);
-            for(ecs::EntityId id : world.query<PointLightComponent>(tags).ids()) {
+            for(ecs::EntityId id : world.cached_query<PointLightComponent>(tags).ids()) {
                 push_entity(id);
             }
         }
 
         {
             std::tie(uv, size) = imgui::compute_glyph_uv_size(ICON_FA_VIDEO);
-            for(ecs::EntityId id : world.query<SpotLightComponent>(tags).ids()) {
+            for(ecs::EntityId id : world.cached_query<SpotLightComponent>(tags).ids()) {
                 push_entity(id);
             }
         }
@@ -105,10 +105,16 @@ IdBufferPass IdBufferPass::create(FrameGraph& framegraph, const SceneView& view,
                 render_pass.set_main_descriptor_set(self->descriptor_sets()[main_descriptor_set_index]);
                 render_pass.bind_material_template(resources()[EditorResources::IdMaterialTemplate], self->descriptor_sets()[static_meshes.descriptor_set_index], true);
 
-                static_meshes.render_custom(render_pass, self, [&](ecs::EntityId id, const StaticMeshComponent&, const MeshDrawCommand& draw_cmd, const Material*, u32 instance_index) {
-                    id_mapping[instance_index] = id.index();
-                    render_pass.draw(draw_cmd.vk_indirect_data(instance_index));
+                const usize batch_count = static_meshes.render_custom(render_pass, self, [&](const StaticMeshRenderSubPass::Batch& batch) {
+                    for(usize i = 0; i != batch.ids.size(); ++i) {
+                        id_mapping[batch.first_instance + i] = batch.ids[i].index();
+                    }
                 });
+
+                if(batch_count) {
+                    const TypedSubBuffer<VkDrawIndexedIndirectCommand, BufferUsage::IndirectBit> indirect = self->resources().buffer<BufferUsage::IndirectBit>(static_meshes.indirect_buffer);
+                    render_pass.draw_indirect(indirect, 0, batch_count);
+                }
             }
         }
     });
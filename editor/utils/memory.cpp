@@ -23,9 +23,9 @@ SOFTWARE.
 #include "memory.h"
 
 #include <y/utils/memory.h>
+#include <y/utils/memory_tracking.h>
 
 #include <atomic>
-#include <cstdlib>
 
 namespace editor {
 namespace memory {
@@ -50,22 +50,7 @@ static void* alloc_internal(usize size, usize alignment = max_alignment) {
         return nullptr;
     }
 
-    auto try_alloc = [=] {
-        #ifdef Y_MSVC
-            return _aligned_malloc(size, alignment);
-        #else
-            return std::aligned_alloc(alignment, size);
-        #endif
-    };
-
-    void* ptr = nullptr;
-    while((ptr = try_alloc()) == nullptr) {
-        std::new_handler nh = std::get_new_handler();
-        if(!nh) {
-            throw std::bad_alloc{};
-        }
-        nh();
-    }
+    void* ptr = memory_tracking::tracked_alloc(size, alignment);
 
     ++total_allocs;
     ++live_allocs;
@@ -83,11 +68,7 @@ static void free_internal(void* ptr) {
 
     y_profile_free(ptr);
 
-#ifdef Y_MSVC
-    _aligned_free(ptr);
-#else
-    std::free(ptr);
-#endif
+    memory_tracking::tracked_free(ptr);
 }
 }
 }
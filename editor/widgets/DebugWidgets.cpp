@@ -32,7 +32,11 @@ SOFTWARE.
 
 #include <editor/utils/ui.h>
 
+#include <y/core/FrameArena.h>
+#include <y/utils/memory_tracking.h>
+#include <y/utils/trace.h>
 #include <y/utils/format.h>
+#include <y/utils/log.h>
 
 
 namespace editor {
@@ -125,6 +129,40 @@ class MemoryDebug : public Widget {
             ImGui::TextUnformatted(fmt_c_str("{} live allocations", memory::live_allocations()));
             ImGui::TextUnformatted(fmt_c_str("{} allocations per frame", total_allocs - _last_total));
             _last_total = total_allocs;
+
+            const core::FrameArena::FrameStats arena_stats = core::FrameArena::last_frame_stats();
+            ImGui::Separator();
+            ImGui::TextUnformatted(fmt_c_str("{} frame arena allocations per frame", arena_stats.allocations));
+            ImGui::TextUnformatted(fmt_c_str("{} KB allocated from frame arenas per frame", arena_stats.allocated_bytes / 1024));
+            ImGui::TextUnformatted(fmt_c_str("{} KB reserved by frame arenas", core::FrameArena::total_reserved_size() / 1024));
+
+            ImGui::Separator();
+            if(ImGui::BeginTable("##tags", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+                ImGui::TableSetupColumn("Tag");
+                ImGui::TableSetupColumn("Live (KB)");
+                ImGui::TableSetupColumn("Peak (KB)");
+                ImGui::TableSetupColumn("Allocations");
+                ImGui::TableSetupColumn("Budget (KB)");
+                ImGui::TableHeadersRow();
+
+                for(usize i = 0; i != usize(MemoryTag::Max); ++i) {
+                    const MemoryTag tag = MemoryTag(i);
+                    const memory_tracking::TagStats stats = memory_tracking::tag_stats(tag);
+
+                    imgui::table_begin_next_row();
+                    ImGui::TextUnformatted(memory_tag_name(tag).data());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(fmt_c_str("{}", stats.live_bytes / 1024));
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(fmt_c_str("{}", stats.peak_bytes / 1024));
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(fmt_c_str("{}", stats.live_allocations));
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(stats.budget ? fmt_c_str("{}", stats.budget / 1024) : "-");
+                }
+
+                ImGui::EndTable();
+            }
         }
 
     private:
@@ -191,9 +229,9 @@ class EcsDebug : public Widget {
                     ImGui::TableSetupColumn("##entities", ImGuiTableColumnFlags_WidthFixed);
                     ImGui::TableSetupColumn("##actions",ImGuiTableColumnFlags_WidthFixed);
 
-                    for(const core::String& tag : world.tags()) {
+                    for(const ecs::Tag tag : world.tags()) {
                         imgui::table_begin_next_row();
-                        ImGui::TextUnformatted(tag.data());
+                        ImGui::TextUnformatted(tag.name().data());
                         ImGui::TableNextColumn();
                         ImGui::TextUnformatted(fmt_c_str("{} entities", world.tag_set(tag)->size()));
                         ImGui::TableNextColumn();
@@ -233,6 +271,19 @@ class MeshAllocatorDebug : public Widget {
                     fmt_c_str("{}k / {}k", tris / 1000, MeshAllocator::default_triangle_count / 1000)
                 );
             }
+
+            ImGui::Separator();
+
+            {
+                const auto [vert_frag, tris_frag] = mesh_allocator().fragmentation();
+                ImGui::Text("Vertex fragmentation: %.1f%%", vert_frag * 100.0f);
+                ImGui::Text("Triangle fragmentation: %.1f%%", tris_frag * 100.0f);
+                ImGui::Text("%u free blocks", unsigned(mesh_allocator().free_blocks()));
+
+                if(ImGui::Button("Defragment")) {
+                    mesh_allocator().defragment(u64(-1));
+                }
+            }
         }
 };
 
@@ -272,4 +323,39 @@ class UiDebug : public Widget {
 };
 
 
+class TraceCapture : public Widget {
+    editor_widget(TraceCapture, "View", "Debug")
+
+    public:
+        TraceCapture() : Widget("Trace capture", ImGuiWindowFlags_AlwaysAutoResize) {
+        }
+
+    protected:
+        void on_gui() override {
+#ifdef YAVE_PROFILING
+            ImGui::TextUnformatted("Tracy is enabled, zones are not recorded");
+#else
+            imgui::text_input("File", _file_name);
+
+            if(!trace::is_enabled()) {
+                if(ImGui::Button("Start capture")) {
+                    trace::clear();
+                    trace::set_enabled(true);
+                }
+            } else {
+                if(ImGui::Button("Stop and save")) {
+                    trace::set_enabled(false);
+                    if(!trace::save(_file_name)) {
+                        log_msg(fmt("Unable to write trace to \"{}\"", _file_name), Log::Error);
+                    }
+                }
+            }
+#endif
+        }
+
+    private:
+        core::String _file_name = "trace.json";
+};
+
+
 }
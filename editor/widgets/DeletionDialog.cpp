@@ -23,12 +23,18 @@ SOFTWARE.
 #include "DeletionDialog.h"
 
 #include <editor/EditorWorld.h>
+#include <editor/UndoStack.h>
 #include <editor/components/EditorComponent.h>
 
 #include <editor/utils/ui.h>
 
 namespace editor {
 
+static void remove_entity(EditorWorld& world, ecs::EntityId id) {
+    undo_stack().record_removed(world, id);
+    world.remove_entity(id);
+}
+
 static void remove_children(EditorWorld& world, ecs::EntityId id) {
     core::SmallVector<ecs::EntityId, 64> children;
     for(const ecs::EntityId child : world.children(id)) {
@@ -37,7 +43,7 @@ static void remove_children(EditorWorld& world, ecs::EntityId id) {
 
     for(const ecs::EntityId child : children) {
         remove_children(world, child);
-        world.remove_entity(child);
+        remove_entity(world, child);
     }
 }
 
@@ -71,6 +77,7 @@ void DeletionDialog::on_gui() {
 
     if(ImGui::Button("Ok")) {
         y_profile_zone("deleting entities");
+        undo_stack().begin_edit("Delete");
         for(const ecs::EntityId id : _ids) {
             if(!world.exists(id)) {
                 continue;
@@ -78,8 +85,9 @@ void DeletionDialog::on_gui() {
             if(_delete_children) {
                 remove_children(world, id);
             }
-            world.remove_entity(id);
+            remove_entity(world, id);
         }
+        undo_stack().end_edit(world);
         close();
     }
 
@@ -26,6 +26,7 @@ SOFTWARE.
 #include <editor/Settings.h>
 #include <editor/EditorWorld.h>
 #include <editor/EditorResources.h>
+#include <editor/UndoStack.h>
 #include <editor/utils/CameraController.h>
 #include <editor/utils/ui.h>
 
@@ -36,6 +37,7 @@ SOFTWARE.
 #include <yave/graphics/commands/CmdBufferRecorder.h>
 #include <yave/graphics/commands/CmdTimingRecorder.h>
 #include <yave/graphics/device/DeviceResources.h>
+#include <yave/systems/RendererSystem.h>
 
 #include <yave/utils/color.h>
 
@@ -283,7 +285,14 @@ void EngineView::make_drop_target() {
     if(ImGui::BeginDragDropTarget()) {
         if(const ImGuiPayload* payload = ImGui::AcceptDragDropPayload(imgui::drag_drop_path_id)) {
             const std::string_view name = static_cast<const char*>(payload->Data);
-            current_world().set_selected(current_world().add_prefab(name));
+            EditorWorld& world = current_world();
+            undo_stack().begin_edit("Add prefab");
+            const ecs::EntityId id = world.add_prefab(name);
+            if(id.is_valid()) {
+                undo_stack().record_created(world, id);
+            }
+            world.set_selected(id);
+            undo_stack().end_edit(world);
         }
         ImGui::EndDragDropTarget();
     }
@@ -580,6 +589,26 @@ void EngineView::draw_settings_menu() {
 
         ImGui::EndMenu();
     }
+
+    if(ImGui::BeginMenu("Culling")) {
+        GPUCullingSettings& settings = _settings.renderer_settings.culling;
+
+        ImGui::Checkbox("Enable GPU culling", &settings.enable);
+        ImGui::Checkbox("Occlusion culling", &settings.occlusion_culling);
+
+        if(RendererSystem* renderer = current_world().find_system<RendererSystem>()) {
+            const uniform::CullingStats stats = renderer->static_meshes().consume_stats();
+
+            ImGui::Separator();
+
+            ImGui::TextUnformatted(fmt_c_str("Instances: {}", stats.instances));
+            ImGui::TextUnformatted(fmt_c_str("Frustum culled: {}", stats.frustum_culled));
+            ImGui::TextUnformatted(fmt_c_str("Occlusion culled: {}", stats.occlusion_culled));
+            ImGui::TextUnformatted(fmt_c_str("Drawn: {}", stats.drawn));
+        }
+
+        ImGui::EndMenu();
+    }
 }
 
 }
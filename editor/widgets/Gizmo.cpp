@@ -89,7 +89,7 @@ static math::Vec3 intersect_ray_plane(const math::Vec3& orig, const math::Vec3&
     return orig + dir * t;
 }
 
-static [[nodiscard]] bool intersect_lines(const math::Vec3& start_a, const math::Vec3& end_a, const math::Vec3& start_b, const math::Vec3& end_b, math::Vec3& closest) {
+[[nodiscard]] static bool intersect_lines(const math::Vec3& start_a, const math::Vec3& end_a, const math::Vec3& start_b, const math::Vec3& end_b, math::Vec3& closest) {
     const math::Vec3 starts = start_a - start_b;
     const math::Vec3 ends = end_b - start_b;
     const math::Vec3 dir_a = end_a - start_a;
@@ -146,16 +146,36 @@ static bool is_inside(core::Span<math::Vec2> pts, const math::Vec2& p) {
     return true;
 }
 
-static void move_recursive(EditorWorld& world, ecs::EntityId id, math::Transform<> old_parent_transform, math::Transform<> new_parent_transform) {
-    if(TransformableComponent* component = world.component_mut<TransformableComponent>(id)) {
-        const math::Transform<> tr = component->transform();
-        component->set_transform(new_parent_transform * old_parent_transform.inverse() * tr);
-        old_parent_transform = tr;
-        new_parent_transform = component->transform();
+// The gizmo is attached to the last selected entity
+static ecs::EntityId gizmo_entity(const EditorWorld& world) {
+    const core::Span<ecs::EntityId> selected = world.selected_entities();
+    return selected.is_empty() ? ecs::EntityId() : selected[selected.size() - 1];
+}
+
+// Every selected entity is moved along with the gizmo entity, children are moved by TransformHierarchySystem
+// Every frame of a drag is merged into the same undo item
+static void set_transform(EditorWorld& world, ecs::EntityId id, const math::Transform<>& transform) {
+    const TransformableComponent* gizmo_transformable = world.component<TransformableComponent>(id);
+    if(!gizmo_transformable) {
+        return;
+    }
+
+    const math::Transform<> delta(transform * gizmo_transformable->transform().inverse());
+
+    undo_stack().begin_edit("Transform");
+    for(const ecs::EntityId selected : world.selected_entities()) {
+        undo_stack().record(world, selected, ecs::type_index<TransformableComponent>());
+        if(TransformableComponent* component = world.component_mut<TransformableComponent>(selected)) {
+            component->set_transform(selected == id ? transform : math::Transform<>(delta * component->transform()));
+        }
     }
+    undo_stack().end_edit(world);
+}
 
-    for(const ecs::EntityId child : world.children(id)) {
-        move_recursive(world, child, old_parent_transform, new_parent_transform);
+static void end_drag_if_released(bool& is_dragging) {
+    is_dragging &= ImGui::IsMouseDown(ImGuiMouseButton_Left);
+    if(!is_dragging) {
+        undo_stack().seal();
     }
 }
 
@@ -216,10 +236,10 @@ bool TranslationGizmo::is_hovered(usize axis) const {
 }
 
 void TranslationGizmo::draw() {
-    _is_dragging &= ImGui::IsMouseDown(ImGuiMouseButton_Left);
+    end_drag_if_released(_is_dragging);
 
     EditorWorld& world = current_world();
-    const ecs::EntityId selected = world.selected_entity();
+    const ecs::EntityId selected = gizmo_entity(world);
 
     if(!selected.is_valid()) {
         return;
@@ -310,11 +330,10 @@ void TranslationGizmo::draw() {
 
 
     auto set_position = [&](const math::Vec3& pos) {
-        const math::Transform<> old_transform = transformable->transform();
-        math::Transform<> new_transform = old_transform;
+        math::Transform<> new_transform = transformable->transform();
         new_transform.position() = pos;
 
-        move_recursive(world, selected, old_transform, new_transform);
+        set_transform(world, selected, new_transform);
     };
 
 
@@ -409,10 +428,10 @@ RotationGizmo::RotationGizmo(SceneView* view) : GizmoBase(view) {
 }
 
 void RotationGizmo::draw() {
-    _is_dragging &= ImGui::IsMouseDown(ImGuiMouseButton_Left);
+    end_drag_if_released(_is_dragging);
 
     EditorWorld& world = current_world();
-    const ecs::EntityId selected = world.selected_entity();
+    const ecs::EntityId selected = gizmo_entity(world);
 
     if(!selected.is_valid()) {
         return;
@@ -522,9 +541,8 @@ void RotationGizmo::draw() {
 
 
     auto set_rotation = [transformable, selected, &world](const math::Quaternion<>& quat) {
-        const math::Transform<> old_transform = transformable->transform();
-        const auto [obj_pos, obj_rot, obj_scale] = old_transform.decompose();
-        move_recursive(world, selected, old_transform, math::Transform<>(obj_pos, quat * obj_rot, obj_scale));
+        const auto [obj_pos, obj_rot, obj_scale] = transformable->transform().decompose();
+        set_transform(world, selected, math::Transform<>(obj_pos, quat * obj_rot, obj_scale));
     };
 
 
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include <editor/Settings.h>
 #include <editor/EditorWorld.h>
+#include <editor/UndoStack.h>
 #include <editor/components/EditorComponent.h>
 
 #include <yave/components/TransformableComponent.h>
@@ -59,9 +60,15 @@ static void set_new_entity_pos(ecs::EntityId id) {
 static void add_prefab() {
     add_detached_widget<AssetSelector>(AssetType::Prefab, "Add prefab")->set_selected_callback(
         [](AssetId asset) {
-            const ecs::EntityId id = current_world().add_prefab(asset);
-            current_world().set_selected(id);
+            EditorWorld& world = current_world();
+            undo_stack().begin_edit("Add prefab");
+            const ecs::EntityId id = world.add_prefab(asset);
+            if(id.is_valid()) {
+                undo_stack().record_created(world, id);
+            }
+            world.set_selected(id);
             set_new_entity_pos(id);
+            undo_stack().end_edit(world);
             return id.is_valid();
         });
 }
@@ -42,7 +42,7 @@ class Outliner final : public Widget {
         void display_node(EditorWorld& world, ecs::EntityId id);
         bool make_drop_target(EditorWorld& world, ecs::EntityId id);
 
-        core::Vector<std::tuple<const char*, core::String, bool>> _tag_buttons;
+        core::Vector<std::tuple<const char*, ecs::Tag, bool>> _tag_buttons;
 
         ecs::EntityId _context_menu_target;
         ecs::EntityId _click_target;
@@ -146,8 +146,10 @@ void PerformanceMetrics::draw_timings() {
 void PerformanceMetrics::draw_memory() {
     double used_per_type_mb[4] = {};
     double allocated_per_type_mb[4] = {};
+    float max_fragmentation = 0.0f;
     for(const auto& heaps : device_allocator().heaps()) {
         for(const auto& heap : heaps) {
+            max_fragmentation = std::max(max_fragmentation, heap->fragmentation());
             u64 free = heap->available();
             const u64 used = heap->size() - free;
             used_per_type_mb[uenum(heap->memory_type())] += to_mb(used);
@@ -183,6 +185,7 @@ void PerformanceMetrics::draw_memory() {
         ImGui::Text("Total used: %.1lfMB", total_used_mb);
         ImGui::Text("Dedicated allocation: %.1lfMB across %u allocations", dedicated_mb, unsigned(dedicated_count));
         ImGui::Text("Total allocated: %.1lfMB", total_allocated_mb);
+        ImGui::Text("Worst heap fragmentation: %.1f%%", max_fragmentation * 100.0f);
         ImGui::SetNextItemWidth(-1);
         progress_bar(total_used_mb, total_allocated_mb);
 
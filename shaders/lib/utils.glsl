@@ -56,6 +56,28 @@ struct TransformableData {
     mat4 last;
 };
 
+struct StaticMeshInstance {
+    vec3 center;
+    float radius;
+
+    uint transform_index;
+    uint material_index;
+    uint group_index;
+    uint index_count;
+
+    uint first_index;
+    int vertex_offset;
+    uint group_offset;
+    uint padding_0;
+};
+
+struct CullingStats {
+    uint instances;
+    uint frustum_culled;
+    uint occlusion_culled;
+    uint drawn;
+};
+
 const uint diffuse_texture_index = 0;
 const uint normal_texture_index = 1;
 const uint roughness_texture_index = 2;
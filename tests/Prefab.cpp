@@ -0,0 +1,146 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/ecs/EntityWorld.h>
+#include <yave/components/TransformableComponent.h>
+
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+struct ReferenceComponent {
+    ecs::EntityId target;
+
+    y_reflect(ReferenceComponent, target)
+};
+
+// Root with two children, every child references the root
+ecs::EntityPrefab create_prefab() {
+    ecs::EntityPrefab prefab(ecs::EntityId::dummy(0));
+    prefab.add(TransformableComponent(math::Transform<>(math::Vec3(1.0f, 0.0f, 0.0f))));
+
+    for(u32 i = 1; i != 3; ++i) {
+        auto child = std::make_unique<ecs::EntityPrefab>(ecs::EntityId::dummy(i));
+        child->add(TransformableComponent());
+        child->add(ReferenceComponent{ecs::EntityId::dummy(0)});
+        prefab.add_child(std::move(child));
+    }
+
+    return prefab;
+}
+
+y_test_func("Prefab instantiation") {
+    const ecs::EntityPrefab prefab = create_prefab();
+    const ecs::PrefabSpawnPlan plan(prefab);
+    y_test_assert(plan.node_count() == 3);
+
+    ecs::EntityWorld world;
+
+    const usize count = 100;
+    const core::Vector<ecs::EntityId> ids = world.instantiate(plan, count);
+    y_test_assert(ids.size() == count * 3);
+    y_test_assert(world.entity_count() == count * 3);
+
+    for(usize i = 0; i != count; ++i) {
+        const ecs::EntityId root = ids[i];
+        y_test_assert(!world.has_parent(root));
+        y_test_assert(world.component<TransformableComponent>(root)->transform().position() == math::Vec3(1.0f, 0.0f, 0.0f));
+
+        for(usize n = 1; n != 3; ++n) {
+            const ecs::EntityId child = ids[n * count + i];
+            y_test_assert(world.parent(child) == root);
+            y_test_assert(world.component<ReferenceComponent>(child)->target == root);
+        }
+    }
+}
+
+y_test_func("Prefab instantiation matches add_prefab") {
+    const ecs::EntityPrefab prefab = create_prefab();
+
+    ecs::EntityWorld world;
+    const ecs::EntityId root = world.create_entity(prefab);
+    y_test_assert(world.entity_count() == 3);
+
+    for(const ecs::EntityId child : world.children(root)) {
+        y_test_assert(world.component<TransformableComponent>(child));
+        y_test_assert(world.component<ReferenceComponent>(child)->target == root);
+    }
+}
+
+y_test_func("Prefab with duplicated ids") {
+    ecs::EntityPrefab prefab(ecs::EntityId::dummy(0));
+    {
+        auto child = std::make_unique<ecs::EntityPrefab>(ecs::EntityId::dummy(0));
+        child->add(ReferenceComponent{ecs::EntityId::dummy(0)});
+        prefab.add_child(std::move(child));
+    }
+
+    const ecs::PrefabSpawnPlan plan(prefab);
+    y_test_assert(plan.node_count() == 2);
+    y_test_assert(plan.node_index(ecs::EntityId::dummy(0)) == 0);
+
+    ecs::EntityWorld world;
+
+    // References to a duplicated id resolve to the first entity
+    const core::Vector<ecs::EntityId> ids = world.instantiate(plan, 4);
+    y_test_assert(ids.size() == 8);
+    for(usize i = 0; i != 4; ++i) {
+        y_test_assert(world.component<ReferenceComponent>(ids[4 + i])->target == ids[i]);
+    }
+
+    const ecs::EntityId root = world.create_entity(prefab);
+    y_test_assert(world.entity_count() == 10);
+    for(const ecs::EntityId child : world.children(root)) {
+        y_test_assert(world.component<ReferenceComponent>(child)->target == root);
+    }
+}
+
+y_test_func("Prefab asset children have their own ids") {
+    ecs::EntityPrefab prefab(ecs::EntityId::dummy(0));
+    {
+        ecs::EntityPrefab child(ecs::EntityId::dummy(0));
+        child.add(ReferenceComponent{ecs::EntityId::dummy(0)});
+        prefab.add_child(make_asset<ecs::EntityPrefab>(std::move(child)));
+    }
+
+    const ecs::PrefabSpawnPlan plan(prefab);
+    y_test_assert(plan.node_count() == 2);
+    y_test_assert(plan.nodes()[1].scope != plan.nodes()[0].scope);
+
+    ecs::EntityWorld world;
+
+    const core::Vector<ecs::EntityId> ids = world.instantiate(plan, 4);
+    for(usize i = 0; i != 4; ++i) {
+        const ecs::EntityId child = ids[4 + i];
+        y_test_assert(world.parent(child) == ids[i]);
+        y_test_assert(world.component<ReferenceComponent>(child)->target == child);
+    }
+
+    const ecs::EntityId root = world.create_entity(prefab);
+    for(const ecs::EntityId child : world.children(root)) {
+        y_test_assert(world.component<ReferenceComponent>(child)->target == child);
+    }
+}
+
+}
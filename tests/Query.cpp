@@ -0,0 +1,87 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <yave/ecs/EntityWorld.h>
+#include <yave/components/TransformableComponent.h>
+
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+struct QueryTestComponent {
+    u32 value = 0;
+};
+
+y_test_func("Cached query survives cache eviction") {
+    ecs::EntityWorld world;
+
+    const ecs::EntityId a = world.create_entity();
+    world.add_or_replace_component<QueryTestComponent>(a);
+
+    y_test_assert(world.cached_query<QueryTestComponent>().size() == 1);
+
+    // Long enough for the cache to be evicted
+    for(usize i = 0; i != 256; ++i) {
+        world.tick();
+    }
+
+    // Evicted caches must no longer be notified by the container
+    const ecs::EntityId b = world.create_entity();
+    world.add_or_replace_component<QueryTestComponent>(b);
+    world.remove_component(a, ecs::type_index<QueryTestComponent>());
+
+    const auto ids = world.cached_query<QueryTestComponent>().ids();
+    y_test_assert(ids.size() == 1);
+    y_test_assert(ids[0] == b);
+
+    world.add_or_replace_component<QueryTestComponent>(a);
+    y_test_assert(world.cached_query<QueryTestComponent>().size() == 2);
+}
+
+y_test_func("Cached query with component tags") {
+    ecs::EntityWorld world;
+
+    const ecs::EntityId a = world.create_entity();
+    world.add_or_replace_component<QueryTestComponent>(a);
+    world.add_or_replace_component<TransformableComponent>(a);
+
+    const ecs::EntityId b = world.create_entity();
+    world.add_or_replace_component<QueryTestComponent>(b);
+
+    const std::array short_name = {ecs::Tag("@TransformableComponent")};
+    const std::array qualified_name = {ecs::Tag("@yave::TransformableComponent")};
+    const std::array negated = {ecs::Tag("!@TransformableComponent")};
+    const std::array unknown = {ecs::Tag("@NotAComponent")};
+
+    y_test_assert(world.cached_query<QueryTestComponent>(short_name).size() == 1);
+    y_test_assert(world.cached_query<QueryTestComponent>(qualified_name).size() == 1);
+    y_test_assert(world.cached_query<QueryTestComponent>(negated).size() == 1);
+    y_test_assert(world.cached_query<QueryTestComponent>(unknown).size() == 0);
+
+    world.add_or_replace_component<TransformableComponent>(b);
+    y_test_assert(world.cached_query<QueryTestComponent>(short_name).size() == 2);
+    y_test_assert(world.cached_query<QueryTestComponent>(negated).size() == 0);
+}
+
+}
+
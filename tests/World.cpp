@@ -0,0 +1,102 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/io2/Buffer.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace yave;
+
+struct SavedComponent {
+    u32 value = 0;
+
+    y_reflect(SavedComponent, value)
+};
+
+void fill_world(ecs::EntityWorld& world, usize count) {
+    for(usize i = 0; i != count; ++i) {
+        const ecs::EntityId id = world.create_entity();
+        world.add_or_replace_component<SavedComponent>(id, u32(i));
+        if(i % 2) {
+            world.add_tag(id, "odd");
+        }
+    }
+}
+
+y_test_func("World state round trip") {
+    ecs::EntityWorld world;
+    fill_world(world, 100);
+
+    io2::Buffer buffer;
+    {
+        serde3::WritableArchive arc(buffer);
+        y_test_assert(world.save_state(arc));
+    }
+    buffer.reset();
+
+    ecs::EntityWorld loaded;
+    fill_world(loaded, 10);
+
+    serde3::ReadableArchive arc(buffer);
+    y_test_assert(loaded.load_state(arc));
+
+    y_test_assert(loaded.entity_count() == 100);
+
+    const std::array odd = {ecs::Tag("odd")};
+    y_test_assert(loaded.query<SavedComponent>().size() == 100);
+    y_test_assert(loaded.query<SavedComponent>(odd).size() == 50);
+
+    for(auto&& [id, comp] : loaded.query<SavedComponent>()) {
+        const auto& [saved] = comp;
+        y_test_assert(saved.value == world.component<SavedComponent>(id)->value);
+    }
+}
+
+y_test_func("World state failed load keeps the world") {
+    ecs::EntityWorld world;
+    fill_world(world, 100);
+
+    io2::Buffer buffer;
+    {
+        serde3::WritableArchive arc(buffer);
+        y_test_assert(world.save_state(arc));
+    }
+
+    // Drop the end of the containers
+    io2::Buffer truncated;
+    y_test_assert(truncated.write(buffer.data(), buffer.size() / 2));
+    truncated.reset();
+
+    ecs::EntityWorld loaded;
+    fill_world(loaded, 10);
+
+    serde3::ReadableArchive arc(truncated);
+    y_test_assert(!loaded.load_state(arc));
+
+    y_test_assert(loaded.entity_count() == 10);
+    y_test_assert(loaded.query<SavedComponent>().size() == 10);
+}
+
+}
+
@@ -0,0 +1,79 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/benchmark.h>
+
+#include <y/core/TLSFAllocator.h>
+#include <y/core/FrameArena.h>
+#include <y/core/Vector.h>
+
+#include <new>
+#include <random>
+
+namespace {
+using namespace y;
+using namespace y::core;
+using namespace y::test;
+
+y_bench_func("Allocators") {
+    std::mt19937 rng(8);
+    Vector<u64> sizes;
+    for(usize i = 0; i != 1000; ++i) {
+        sizes << 16 + rng() % 4096;
+    }
+
+    TLSFAllocator tlsf(u64(1) << 32);
+    Vector<u64> offsets = Vector<u64>::with_capacity(sizes.size());
+    bench.run("TLSFAllocator alloc/free 1k", [&] {
+        offsets.make_empty();
+        for(const u64 size : sizes) {
+            offsets << tlsf.alloc(size, 16).unwrap();
+        }
+        for(usize i = 0; i < offsets.size(); i += 2) {
+            tlsf.free(offsets[i]);
+        }
+        for(usize i = 1; i < offsets.size(); i += 2) {
+            tlsf.free(offsets[i]);
+        }
+    });
+
+    Vector<void*> ptrs = Vector<void*>::with_capacity(sizes.size());
+    bench.run("operator new/delete 1k", [&] {
+        ptrs.make_empty();
+        for(const u64 size : sizes) {
+            ptrs << ::operator new(size);
+        }
+        for(void* ptr : ptrs) {
+            ::operator delete(ptr);
+        }
+    });
+
+    FrameArena arena;
+    bench.run("FrameArena allocate/reset 1k", [&] {
+        for(const u64 size : sizes) {
+            do_not_optimize(arena.allocate(size));
+        }
+        arena.reset();
+    });
+}
+
+}
+
@@ -0,0 +1,73 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/benchmark.h>
+
+#include <y/concurrent/StaticThreadPool.h>
+
+#include <array>
+
+namespace {
+using namespace y;
+using namespace y::core;
+using namespace y::test;
+
+y_bench_func("StaticThreadPool") {
+    concurrent::StaticThreadPool pool;
+
+    // Waits for group by scheduling a task that depends on it
+    auto wait = [&](concurrent::DependencyGroup& group) {
+        pool.schedule_with_future([] { return 0; }, nullptr, {group}).wait();
+    };
+
+    bench.run("schedule 1k empty tasks", [&] {
+        concurrent::DependencyGroup group;
+        for(usize i = 0; i != 1000; ++i) {
+            pool.schedule([] {}, &group);
+        }
+        wait(group);
+    });
+
+    bench.run("schedule 64 tasks x 10k ops", [&] {
+        concurrent::DependencyGroup group;
+        for(usize i = 0; i != 64; ++i) {
+            pool.schedule([] {
+                u64 x = 0;
+                for(u64 k = 0; k != 10000; ++k) {
+                    x = x * 6364136223846793005ull + k;
+                }
+                do_not_optimize(x);
+            }, &group);
+        }
+        wait(group);
+    });
+
+    bench.run("dependency chain of 100 tasks", [&] {
+        std::array<concurrent::DependencyGroup, 100> groups;
+        for(usize i = 0; i != groups.size(); ++i) {
+            pool.schedule([] {}, &groups[i], i ? Span<concurrent::DependencyGroup>(groups[i - 1]) : Span<concurrent::DependencyGroup>());
+        }
+        wait(groups.back());
+    });
+}
+
+}
+
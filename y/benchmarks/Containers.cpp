@@ -0,0 +1,238 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/benchmark.h>
+
+#include <y/core/Vector.h>
+#include <y/core/RingQueue.h>
+#include <y/core/HashMap.h>
+#include <y/core/BitSet.h>
+#include <y/utils/sort.h>
+#include <y/utils/format.h>
+
+#include <unordered_map>
+#include <random>
+
+namespace {
+using namespace y;
+using namespace y::core;
+using namespace y::test;
+
+static Vector<u64> random_keys(usize count, u32 seed) {
+    std::mt19937_64 rng(seed);
+    Vector<u64> keys = Vector<u64>::with_capacity(count);
+    for(usize i = 0; i != count; ++i) {
+        keys << rng();
+    }
+    return keys;
+}
+
+template<typename Map>
+static void bench_map(Benchmark& bench, std::string_view name) {
+    const usize count = 10000;
+    const Vector<u64> keys = random_keys(count, 1);
+    const Vector<u64> missing = random_keys(count, 2);
+
+    Map full;
+    for(const u64 k : keys) {
+        full[k] = k;
+    }
+
+    bench.run(fmt("{} insert 10k", name), [&] {
+        Map map;
+        for(const u64 k : keys) {
+            map[k] = k;
+        }
+        do_not_optimize(map);
+    });
+
+    bench.run(fmt("{} find hit 10k", name), [&] {
+        u64 sum = 0;
+        for(const u64 k : keys) {
+            sum += full.find(k)->second;
+        }
+        do_not_optimize(sum);
+    });
+
+    bench.run(fmt("{} find miss 10k", name), [&] {
+        usize found = 0;
+        for(const u64 k : missing) {
+            found += full.find(k) != full.end();
+        }
+        do_not_optimize(found);
+    });
+
+    // Maps are not all copyable, so the map has to be filled again every iteration
+    bench.run(fmt("{} insert then erase 10k", name), [&] {
+        Map map;
+        for(const u64 k : keys) {
+            map[k] = k;
+        }
+        for(const u64 k : keys) {
+            map.erase(k);
+        }
+        do_not_optimize(map);
+    });
+
+    bench.run(fmt("{} iterate 10k", name), [&] {
+        u64 sum = 0;
+        for(const auto& [k, v] : full) {
+            sum += v;
+        }
+        do_not_optimize(sum);
+    });
+}
+
+template<core::detail::ProbingStrategy Strategy>
+using ProbingMap = FlatHashMap<u64, u64, Hash<u64>, std::equal_to<u64>, Strategy>;
+
+y_bench_func("Vector") {
+    bench.run("push_back 10k", [] {
+        Vector<u32> vec;
+        for(u32 i = 0; i != 10000; ++i) {
+            vec.push_back(i);
+        }
+        do_not_optimize(vec.data());
+    });
+
+    bench.run("push_back reserved 10k", [] {
+        Vector<u32> vec = Vector<u32>::with_capacity(10000);
+        for(u32 i = 0; i != 10000; ++i) {
+            vec.push_back(i);
+        }
+        do_not_optimize(vec.data());
+    });
+
+    const Vector<u64> keys = random_keys(100000, 3);
+    bench.run("iterate 100k", [&] {
+        u64 sum = 0;
+        for(const u64 k : keys) {
+            sum += k;
+        }
+        do_not_optimize(sum);
+    });
+
+    bench.run("copy 100k", [&] {
+        const Vector<u64> copy(keys);
+        do_not_optimize(copy.data());
+    });
+}
+
+y_bench_func("RingQueue") {
+    bench.run("push/pop 10k", [] {
+        RingQueue<u32> queue;
+        u64 sum = 0;
+        for(u32 i = 0; i != 10000; ++i) {
+            queue.push_back(i);
+            if(i % 4 == 3) {
+                sum += queue.pop_front();
+                sum += queue.pop_front();
+            }
+        }
+        do_not_optimize(sum);
+    });
+}
+
+y_bench_func("HashMap") {
+    bench_map<ProbingMap<core::detail::ProbingStrategy::Group>>(bench, "group");
+    bench_map<ProbingMap<core::detail::ProbingStrategy::Quadratic>>(bench, "quadratic");
+    bench_map<ProbingMap<core::detail::ProbingStrategy::Linear>>(bench, "linear");
+    bench_map<std::unordered_map<u64, u64>>(bench, "std::unordered_map");
+}
+
+y_bench_func("BitSet") {
+    const usize size = 100000;
+    std::mt19937 rng(4);
+
+    // Sets of decreasing density, like component sets of an ECS world
+    Vector<BitSet> sets;
+    for(const u32 density : {90, 50, 25}) {
+        BitSet& set = sets.emplace_back();
+        for(usize i = 0; i != size; ++i) {
+            if(rng() % 100 < density) {
+                set.set(i);
+            }
+        }
+    }
+
+    BitSet excluded;
+    for(usize i = 0; i < size; i += 7) {
+        excluded.set(i);
+    }
+
+    const std::array<const BitSet*, 3> includes = {&sets[0], &sets[1], &sets[2]};
+    const std::array<const BitSet*, 1> excludes = {&excluded};
+
+    Vector<u32> indices;
+    bench.run("match 3 includes 100k", [&] {
+        indices.make_empty();
+        BitSet::match(includes, {}, indices);
+        do_not_optimize(indices.data());
+    });
+
+    bench.run("match 3 includes 1 exclude 100k", [&] {
+        indices.make_empty();
+        BitSet::match(includes, excludes, indices);
+        do_not_optimize(indices.data());
+    });
+
+    bench.run("probe 3 sets 100k", [&] {
+        indices.make_empty();
+        for(u32 i = 0; i != size; ++i) {
+            if(sets[0].test(i) && sets[1].test(i) && sets[2].test(i) && !excluded.test(i)) {
+                indices << i;
+            }
+        }
+        do_not_optimize(indices.data());
+    });
+}
+
+// Same shape as the static mesh draw list: 64 bits keys sorted along with a draw index
+y_bench_func("Sort") {
+    const usize count = 50000;
+    const Vector<u64> keys = random_keys(count, 5);
+
+    Vector<u64> sorted_keys(count, u64(0));
+    Vector<u32> values(count, u32(0));
+    Vector<u64> keys_buffer(count, u64(0));
+    Vector<u32> values_buffer(count, u32(0));
+
+    bench.run("radix_sort 50k", [&] {
+        std::copy(keys.begin(), keys.end(), sorted_keys.begin());
+        for(u32 i = 0; i != count; ++i) {
+            values[i] = i;
+        }
+        radix_sort(sorted_keys.data(), values.data(), count, keys_buffer.data(), values_buffer.data());
+        do_not_optimize(values.data());
+    });
+
+    Vector<std::pair<u64, u32>> pairs(count, std::pair<u64, u32>());
+    bench.run("std::sort 50k", [&] {
+        for(u32 i = 0; i != count; ++i) {
+            pairs[i] = {keys[i], i};
+        }
+        std::sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        do_not_optimize(pairs.data());
+    });
+}
+
+}
+
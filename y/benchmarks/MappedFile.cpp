@@ -0,0 +1,177 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/test/benchmark.h>
+
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/serde3/archives.h>
+
+#include <y/core/String.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+#ifdef Y_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Loads 1GB of mesh data from disk, with the file in the page cache (warm) and evicted before every load (cold).
+// This writes a 1GB temporary file and takes more than a minute: filter it out when iterating on other benchmarks.
+
+namespace {
+using namespace y;
+using namespace y::core;
+using namespace y::test;
+
+// Not reflected, like yave's PackedVertex, so that vertex arrays go through the POD collection path
+struct MeshVertex {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    u32 normal = 0;
+    u32 tangent = 0;
+    u32 uv = 0;
+};
+
+struct Mesh {
+    Vector<MeshVertex> vertices;
+    Vector<u32> indices;
+
+    y_reflect(Mesh, vertices, indices)
+};
+
+static constexpr usize mesh_set_size = 1024 * 1024 * 1024;
+static constexpr usize mesh_size = 16 * 1024 * 1024;
+static constexpr usize mesh_count = mesh_set_size / mesh_size;
+
+static Mesh create_mesh() {
+    const usize vertex_count = (mesh_size * 3 / 4) / sizeof(MeshVertex);
+    const usize index_count = (mesh_size / 4) / sizeof(u32);
+
+    Mesh mesh;
+    mesh.vertices.set_min_capacity(vertex_count);
+    for(usize i = 0; i != vertex_count; ++i) {
+        mesh.vertices << MeshVertex{float(i % 1024), float(i / 1024), 0.0f, u32(i), u32(i * 7), u32(i * 13)};
+    }
+    mesh.indices.set_min_capacity(index_count);
+    for(usize i = 0; i != index_count; ++i) {
+        mesh.indices << u32((i * 2654435761u) % vertex_count);
+    }
+    return mesh;
+}
+
+// Drops the file from the OS page cache, so that the next read has to go to the disk
+static bool evict_from_cache(const String& name) {
+#ifdef Y_OS_WIN
+    // Opening a file without buffering flushes and discards its cached pages
+    const HANDLE handle = ::CreateFileA(name.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+    if(handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    ::CloseHandle(handle);
+    return true;
+#else
+    const int fd = ::open(name.data(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    const bool evicted = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return evicted;
+#endif
+}
+
+template<typename F>
+static bool load_mesh_set(F&& open) {
+    auto file = open();
+    if(file.is_error()) {
+        return false;
+    }
+
+    Mesh mesh;
+    usize vertices = 0;
+    for(usize i = 0; i != mesh_count; ++i) {
+        mesh = Mesh();
+        if(serde3::ReadableArchive(file.unwrap()).deserialize(mesh).is_error()) {
+            return false;
+        }
+        vertices += mesh.vertices.size();
+    }
+    do_not_optimize(vertices);
+    return true;
+}
+
+y_bench_func("Mesh set loading") {
+    const String name = (std::filesystem::temp_directory_path() / fmt("y_mesh_set_bench_{}", std::random_device()())).string();
+    y_defer(std::remove(name.data()));
+
+    {
+        const Mesh mesh = create_mesh();
+        auto file = io2::File::create(name);
+        if(file.is_error()) {
+            log_msg(fmt("Unable to create \"{}\"", name), Log::Error);
+            return;
+        }
+        for(usize i = 0; i != mesh_count; ++i) {
+            if(serde3::WritableArchive(file.unwrap()).serialize(mesh).is_error()) {
+                log_msg(fmt("Unable to write \"{}\"", name), Log::Error);
+                return;
+            }
+        }
+    }
+
+    const auto open_file = [&] { return io2::File::open(name); };
+    const auto open_mapped = [&] { return io2::MappedFile::open(name); };
+
+    bench.run("File 1GB (warm)", [&] {
+        do_not_optimize(load_mesh_set(open_file));
+    });
+
+    bench.run("MappedFile 1GB (warm)", [&] {
+        do_not_optimize(load_mesh_set(open_mapped));
+    });
+
+    if(!evict_from_cache(name)) {
+        log_msg("Unable to evict files from the page cache, skipping cold loads", Log::Warning);
+        return;
+    }
+
+    const auto evict = [&] { evict_from_cache(name); };
+
+    bench.run_with_setup("File 1GB (cold)", evict, [&] {
+        do_not_optimize(load_mesh_set(open_file));
+    });
+
+    bench.run_with_setup("MappedFile 1GB (cold)", evict, [&] {
+        do_not_optimize(load_mesh_set(open_mapped));
+    });
+}
+
+}
+
@@ -0,0 +1,103 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/benchmark.h>
+
+#include <y/math/Transform.h>
+#include <y/core/Vector.h>
+
+#include <random>
+#include <tuple>
+
+namespace {
+using namespace y;
+using namespace y::core;
+using namespace y::math;
+using namespace y::test;
+
+static constexpr usize count = 1024;
+
+struct MathData {
+    Vector<Vec3> positions;
+    Vector<Quaternion<>> rotations;
+    Vector<Transform<>> transforms;
+
+    MathData() {
+        std::mt19937 rng(6);
+        std::uniform_real_distribution<float> distrib(-10.0f, 10.0f);
+        for(usize i = 0; i != count; ++i) {
+            positions << Vec3(distrib(rng), distrib(rng), distrib(rng));
+            rotations << Quaternion<>::from_euler(distrib(rng), distrib(rng), distrib(rng));
+            transforms << Transform<>(positions.last(), rotations.last(), Vec3(1.0f + std::abs(distrib(rng))));
+        }
+    }
+};
+
+y_bench_func("Math") {
+    const MathData data;
+    Vector<Matrix4<>> matrices(count, Matrix4<>());
+    Vector<Vec3> points(count, Vec3());
+
+    bench.run("Matrix4 multiply 1k", [&] {
+        for(usize i = 0; i != count; ++i) {
+            matrices[i] = data.transforms[i] * data.transforms[(i + 1) % count];
+        }
+        do_not_optimize(matrices.data());
+    });
+
+    bench.run("Matrix4 inverse 1k", [&] {
+        for(usize i = 0; i != count; ++i) {
+            matrices[i] = data.transforms[i].inverse();
+        }
+        do_not_optimize(matrices.data());
+    });
+
+    bench.run("Transform from pos/rot/scale 1k", [&] {
+        for(usize i = 0; i != count; ++i) {
+            matrices[i] = Transform<>(data.positions[i], data.rotations[i], Vec3(2.0f));
+        }
+        do_not_optimize(matrices.data());
+    });
+
+    bench.run("Transform decompose 1k", [&] {
+        for(usize i = 0; i != count; ++i) {
+            points[i] = std::get<0>(data.transforms[i].decompose());
+        }
+        do_not_optimize(points.data());
+    });
+
+    bench.run("Transform point 1k", [&] {
+        for(usize i = 0; i != count; ++i) {
+            points[i] = data.transforms[i].transform_point(data.positions[(i + 1) % count]);
+        }
+        do_not_optimize(points.data());
+    });
+
+    bench.run("Quaternion rotate 1k", [&] {
+        for(usize i = 0; i != count; ++i) {
+            points[i] = data.rotations[i](data.positions[i]);
+        }
+        do_not_optimize(points.data());
+    });
+}
+
+}
+
@@ -0,0 +1,167 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/benchmark.h>
+
+#include <y/io2/Buffer.h>
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/io2/Compressed.h>
+#include <y/serde3/archives.h>
+
+#include <y/core/String.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+namespace {
+using namespace y;
+using namespace y::core;
+using namespace y::test;
+
+struct Vertex {
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+    u32 normal = 0;
+    u32 uv = 0;
+
+    y_reflect(Vertex, x, y, z, normal, uv)
+};
+
+struct Node {
+    String name;
+    u64 id = 0;
+    Vector<u32> children;
+
+    y_reflect(Node, name, id, children)
+};
+
+struct Scene {
+    Vector<Vertex> vertices;
+    Vector<Node> nodes;
+
+    y_reflect(Scene, vertices, nodes)
+};
+
+static Scene create_scene() {
+    Scene scene;
+    for(u32 i = 0; i != 50000; ++i) {
+        scene.vertices << Vertex{float(i % 100), float(i / 100), 0.0f, i % 7, i % 13};
+    }
+    for(u32 i = 0; i != 1000; ++i) {
+        Node& node = scene.nodes.emplace_back();
+        node.name = fmt("node number {}", i);
+        node.id = i;
+        for(u32 c = 0; c != i % 8; ++c) {
+            node.children << c;
+        }
+    }
+    return scene;
+}
+
+y_bench_func("serde3") {
+    const Scene scene = create_scene();
+
+    io2::Buffer buffer;
+    bench.run("serialize scene", [&] {
+        buffer.clear();
+        const bool ok = serde3::WritableArchive(buffer).serialize(scene).is_ok();
+        do_not_optimize(ok);
+    });
+
+    buffer.clear();
+    serde3::WritableArchive(buffer).serialize(scene).ignore();
+
+    bench.run("deserialize scene", [&] {
+        buffer.reset();
+        Scene loaded;
+        const bool ok = serde3::ReadableArchive(buffer).deserialize(loaded).is_ok();
+        do_not_optimize(ok);
+    });
+
+    const usize size = buffer.size();
+    Vector<u8> compressed(io2::max_compressed_size(size), u8(0));
+    usize compressed_size = 0;
+
+    bench.run(fmt("compress_block {}KB", size / 1024), [&] {
+        compressed_size = io2::compress_block(buffer.data(), size, compressed.data(), compressed.size());
+        do_not_optimize(compressed_size);
+    });
+
+    Vector<u8> decompressed(size, u8(0));
+    bench.run(fmt("decompress_block {}KB", size / 1024), [&] {
+        const bool ok = io2::decompress_block(compressed.data(), compressed_size, decompressed.data(), decompressed.size());
+        do_not_optimize(ok);
+    });
+
+    if(compressed_size) {
+        log_msg(fmt("serde3 scene: {}KB, compression ratio {:.2f}", size / 1024, double(size) / double(compressed_size)), Log::Perf);
+    }
+}
+
+// Files are read from the page cache: a cold read would require dropping the OS caches between iterations
+y_bench_func("Files") {
+    const usize size = 16 * 1024 * 1024;
+    const Vector<u8> data(size, u8(7));
+
+    const String name = (std::filesystem::temp_directory_path() / fmt("y_serde_bench_{}", std::random_device()())).string();
+    {
+        auto file = io2::File::create(name);
+        if(file.is_error() || file.unwrap().write(data.data(), data.size()).is_error()) {
+            log_msg(fmt("Unable to create \"{}\"", name), Log::Error);
+            return;
+        }
+    }
+    y_defer(std::remove(name.data()));
+
+    Vector<u8> content;
+    bench.run("File read_all 16MB", [&] {
+        content.make_empty();
+        auto file = io2::File::open(name);
+        const bool ok = file.is_ok() && file.unwrap().read_all(content).is_ok();
+        do_not_optimize(ok);
+    });
+
+    bench.run("MappedFile read_all 16MB", [&] {
+        content.make_empty();
+        auto file = io2::MappedFile::open(name);
+        const bool ok = file.is_ok() && file.unwrap().read_all(content).is_ok();
+        do_not_optimize(ok);
+    });
+
+    bench.run("MappedFile read_view 16MB", [&] {
+        auto file = io2::MappedFile::open(name);
+        u64 sum = 0;
+        if(const u8* view = file.is_ok() ? file.unwrap().read_view(size) : nullptr) {
+            for(usize i = 0; i < size; i += 4096) {
+                sum += view[i];
+            }
+        }
+        do_not_optimize(sum);
+    });
+}
+
+}
+
@@ -0,0 +1,98 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/test/benchmark.h>
+
+#include <y/core/String.h>
+#include <y/utils/format.h>
+
+namespace {
+using namespace y;
+using namespace y::core;
+using namespace y::test;
+
+static_assert(String::max_short_size >= 15);
+
+y_bench_func("String") {
+    const char* short_str = "short string";
+    const char* long_str = "a string that is definitely too long for the small string optimization";
+
+    bench.run("construct short", [=] {
+        const String str(short_str);
+        do_not_optimize(str);
+    });
+
+    bench.run("construct long", [=] {
+        const String str(long_str);
+        do_not_optimize(str);
+    });
+
+    const String short_src = short_str;
+    const String long_src = long_str;
+
+    bench.run("copy short", [&] {
+        const String str = short_src;
+        do_not_optimize(str);
+    });
+
+    bench.run("copy long", [&] {
+        const String str = long_src;
+        do_not_optimize(str);
+    });
+
+    bench.run("compare long", [&] {
+        const bool eq = long_src == std::string_view(long_str);
+        do_not_optimize(eq);
+    });
+
+    bench.run("append 100 chars", [] {
+        String str;
+        for(usize i = 0; i != 100; ++i) {
+            str += "a";
+        }
+        do_not_optimize(str);
+    });
+}
+
+y_bench_func("Format") {
+    bench.run("fmt int", [] {
+        const std::string_view str = fmt("{}", 123456789);
+        do_not_optimize(str);
+    });
+
+    bench.run("fmt float", [] {
+        const std::string_view str = fmt("{:.3f}", 3.14159f);
+        do_not_optimize(str);
+    });
+
+    bench.run("fmt mixed", [] {
+        const std::string_view str = fmt("{} ({}): {:.2f}ms", "pass name", 42, 1.25);
+        do_not_optimize(str);
+    });
+
+    bench.run("fmt_to_owned long", [] {
+        const String str = fmt_to_owned("{} {} {}", "a string that is long enough", 123456789, "to need an heap allocation");
+        do_not_optimize(str);
+    });
+}
+
+}
+
@@ -0,0 +1,95 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/core/BitSet.h>
+#include <y/test/test.h>
+
+#include <random>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+y_test_func("BitSet set/reset") {
+    BitSet bits;
+    y_test_assert(!bits.test(0));
+    y_test_assert(!bits.test(1000));
+
+    bits.set(3);
+    bits.set(64);
+    bits.set(1000);
+    y_test_assert(bits.test(3));
+    y_test_assert(bits.test(64));
+    y_test_assert(bits.test(1000));
+    y_test_assert(!bits.test(4));
+    y_test_assert(bits.count() == 3);
+    y_test_assert(bits.size() >= 1001);
+
+    bits.reset(64);
+    bits.reset(5000);
+    y_test_assert(!bits.test(64));
+    y_test_assert(bits.count() == 2);
+
+    bits.make_empty();
+    y_test_assert(!bits.test(3));
+    y_test_assert(bits.count() == 0);
+}
+
+y_test_func("BitSet match") {
+    std::mt19937 rng(17);
+
+    BitSet a;
+    BitSet b;
+    BitSet c;
+    for(usize i = 0; i != 10000; ++i) {
+        if(rng() % 2) {
+            a.set(i);
+        }
+        if(rng() % 3) {
+            b.set(i);
+        }
+        if(i < 7000 && rng() % 5 == 0) {
+            c.set(i);
+        }
+    }
+    b.set(20000);
+
+    const std::array includes = {&std::as_const(a), &std::as_const(b)};
+    const std::array excludes = {&std::as_const(c)};
+
+    Vector<u32> indices;
+    BitSet::match(includes, excludes, indices);
+
+    Vector<u32> expected;
+    for(u32 i = 0; i != 20001; ++i) {
+        if(a.test(i) && b.test(i) && !c.test(i)) {
+            expected << i;
+        }
+    }
+    y_test_assert(indices == expected);
+
+    indices.make_empty();
+    BitSet::match({}, excludes, indices);
+    y_test_assert(indices.is_empty());
+}
+
+}
+
@@ -0,0 +1,206 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/io2/Compressed.h>
+#include <y/serde3/archives.h>
+#include <y/test/test.h>
+
+#include <y/core/String.h>
+
+#include <array>
+#include <random>
+#include <cstring>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+struct CompressedData {
+    u32 magic = 0;
+    Vector<u32> values;
+    String name;
+
+    y_reflect(CompressedData, magic, values, name)
+};
+
+static bool roundtrip(const Vector<u8>& data) {
+    Vector<u8> compressed(io2::max_compressed_size(data.size()), u8(0));
+    const usize size = io2::compress_block(data.data(), data.size(), compressed.data(), compressed.size());
+    if(!size) {
+        return false;
+    }
+
+    Vector<u8> decompressed(data.size(), u8(0));
+    return io2::decompress_block(compressed.data(), size, decompressed.data(), decompressed.size()) && decompressed == data;
+}
+
+y_test_func("Compressed block roundtrip") {
+    std::mt19937 rng(7);
+
+    Vector<u8> random;
+    for(usize i = 0; i != 100000; ++i) {
+        random << u8(rng());
+    }
+    y_test_assert(roundtrip(random));
+
+    Vector<u8> repetitive;
+    for(usize i = 0; i != 100000; ++i) {
+        repetitive << u8((i / 7) % 13);
+    }
+    y_test_assert(roundtrip(repetitive));
+
+    Vector<u8> runs(70000, u8(0xAB));
+    y_test_assert(roundtrip(runs));
+
+    y_test_assert(roundtrip(Vector<u8>()));
+    y_test_assert(roundtrip(Vector<u8>(3, u8(1))));
+
+    Vector<u8> compressed(io2::max_compressed_size(runs.size()), u8(0));
+    const usize size = io2::compress_block(runs.data(), runs.size(), compressed.data(), compressed.size());
+    y_test_assert(size && size < runs.size() / 100);
+
+    Vector<u8> decompressed(runs.size(), u8(0));
+    y_test_assert(!io2::decompress_block(compressed.data(), size - 1, decompressed.data(), decompressed.size()));
+}
+
+y_test_func("Compressed serde3 roundtrip") {
+    CompressedData data;
+    data.magic = 0xCAFE;
+    data.name = "compressed";
+    for(u32 i = 0; i != 100000; ++i) {
+        data.values << i % 1000;
+    }
+
+    auto buffer = std::make_unique<io2::Buffer>();
+    {
+        io2::CompressedWriter writer(*buffer, 64 * 1024);
+        y_test_assert(serde3::WritableArchive(writer).serialize(data).is_ok());
+        y_test_assert(writer.flush().is_ok());
+    }
+
+    y_test_assert(buffer->size() < data.values.size() * sizeof(u32) / 2);
+
+    buffer->reset();
+    y_test_assert(io2::CompressedReader::is_compressed(*buffer));
+    y_test_assert(buffer->tell() == 0);
+
+    auto reader = io2::CompressedReader::open(std::move(buffer));
+    y_test_assert(reader.is_ok());
+
+    CompressedData loaded;
+    y_test_assert(serde3::ReadableArchive(reader.unwrap()).deserialize(loaded).is_ok());
+    y_test_assert(loaded.magic == data.magic);
+    y_test_assert(loaded.name == data.name);
+    y_test_assert(loaded.values == data.values);
+    y_test_assert(reader.unwrap().at_end());
+}
+
+y_test_func("Compressed reader seek") {
+    Vector<u32> data;
+    for(u32 i = 0; i != 10000; ++i) {
+        data << i;
+    }
+
+    auto buffer = std::make_unique<io2::Buffer>();
+    {
+        io2::CompressedWriter writer(*buffer, 1024);
+        y_test_assert(writer.write_array(data.data(), data.size()).is_ok());
+    }
+
+    buffer->reset();
+    auto reader = io2::CompressedReader::open(std::move(buffer));
+    y_test_assert(reader.is_ok());
+    y_test_assert(reader.unwrap().size() == data.size() * sizeof(u32));
+
+    reader.unwrap().seek(5000 * sizeof(u32));
+    y_test_assert(reader.unwrap().read_one<u32>().unwrap() == 5000);
+
+    reader.unwrap().seek(17 * sizeof(u32));
+    y_test_assert(reader.unwrap().read_one<u32>().unwrap() == 17);
+
+    Vector<u8> rest;
+    y_test_assert(reader.unwrap().read_all(rest).unwrap() == (data.size() - 18) * sizeof(u32));
+    y_test_assert(std::memcmp(rest.data(), data.data() + 18, rest.size()) == 0);
+
+    auto invalid = std::make_unique<io2::Buffer>();
+    invalid->write_one(u64(0)).ignore();
+    invalid->reset();
+    y_test_assert(io2::CompressedReader::open(std::move(invalid)).is_error());
+}
+
+y_test_func("Compressed writer streams blocks and patches") {
+    Vector<u32> data;
+    for(u32 i = 0; i != 10000; ++i) {
+        data << i;
+    }
+
+    auto buffer = std::make_unique<io2::Buffer>();
+    {
+        io2::CompressedWriter writer(*buffer, 1024);
+        y_test_assert(writer.write_array(data.data(), data.size()).is_ok());
+
+        // Complete blocks are written before flushing
+        y_test_assert(buffer->size() > 1024);
+
+        // Patch already written blocks, including across a block boundary
+        const u32 patch = 0xFFFFFFFF;
+        writer.seek(3 * sizeof(u32));
+        y_test_assert(writer.write_one(patch).is_ok());
+        data[3] = patch;
+
+        const std::array<u32, 2> boundary = {0xAAAAAAAA, 0xBBBBBBBB};
+        writer.seek(1024 - sizeof(u32));
+        y_test_assert(writer.write_array(boundary.data(), boundary.size()).is_ok());
+        data[255] = boundary[0];
+        data[256] = boundary[1];
+
+        writer.seek(data.size() * sizeof(u32));
+        y_test_assert(writer.flush().is_ok());
+    }
+
+    buffer->reset();
+    auto reader = io2::CompressedReader::open(std::move(buffer));
+    y_test_assert(reader.is_ok());
+    y_test_assert(reader.unwrap().size() == data.size() * sizeof(u32));
+
+    Vector<u8> loaded;
+    y_test_assert(reader.unwrap().read_all(loaded).is_ok());
+    y_test_assert(loaded.size() == data.size() * sizeof(u32));
+    y_test_assert(std::memcmp(loaded.data(), data.data(), loaded.size()) == 0);
+}
+
+y_test_func("Compressed reader rejects invalid block size") {
+    auto buffer = std::make_unique<io2::Buffer>();
+    {
+        io2::CompressedWriter writer(*buffer, 1024);
+        y_test_assert(writer.write_one(u64(7)).is_ok());
+    }
+
+    // Patch the block size in the header
+    buffer->seek(sizeof(u32));
+    buffer->write_one(u32(0xFFFFFFF0)).ignore();
+    buffer->reset();
+
+    y_test_assert(io2::CompressedReader::is_compressed(*buffer));
+    y_test_assert(io2::CompressedReader::open(std::move(buffer)).is_error());
+}
+
+}
@@ -0,0 +1,110 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/core/FrameArena.h>
+#include <y/test/test.h>
+
+#include <thread>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+y_test_func("FrameArena bump allocation") {
+    FrameArena arena(256);
+
+    u8* a = static_cast<u8*>(arena.allocate(3, 1));
+    u8* b = static_cast<u8*>(arena.allocate(8, 8));
+    y_test_assert(b > a);
+    y_test_assert(reinterpret_cast<usize>(b) % 8 == 0);
+    y_test_assert(arena.allocated_size() == 11);
+    y_test_assert(arena.reserved_size() == 256);
+
+    u8* big = static_cast<u8*>(arena.allocate(1000, 16));
+    y_test_assert(reinterpret_cast<usize>(big) % 16 == 0);
+    y_test_assert(arena.reserved_size() > 256);
+
+    const usize reserved = arena.reserved_size();
+    arena.reset();
+    y_test_assert(arena.allocated_size() == 0);
+    y_test_assert(arena.reserved_size() == reserved);
+
+    // Blocks have been merged, so everything fits in the first one
+    u8* first = static_cast<u8*>(arena.allocate(1000, 1));
+    u8* second = static_cast<u8*>(arena.allocate(200, 1));
+    y_test_assert(second == first + 1000);
+}
+
+y_test_func("FrameArena frame lifetime") {
+    FrameArena::next_frame();
+
+    u32* data = static_cast<u32*>(FrameArena::thread_arena().allocate(sizeof(u32), alignof(u32)));
+    *data = 0xDEADBEEF;
+
+    const FrameArena::FrameStats stats = FrameArena::next_frame();
+    y_test_assert(stats.allocations == 1);
+    y_test_assert(stats.allocated_bytes == sizeof(u32));
+    y_test_assert(FrameArena::last_frame_stats().allocations == 1);
+
+    // Still alive during the next frame
+    FrameArena::thread_arena().allocate(64);
+    y_test_assert(*data == 0xDEADBEEF);
+    y_test_assert(FrameArena::thread_arena().allocated_size() == 64);
+
+    FrameArena::next_frame();
+    y_test_assert(FrameArena::thread_arena().allocated_size() == 0);
+}
+
+y_test_func("FrameArena containers") {
+    FrameArena::next_frame();
+
+    FrameVector<u32> vec;
+    for(u32 i = 0; i != 1000; ++i) {
+        vec << i;
+    }
+    for(u32 i = 0; i != 1000; ++i) {
+        y_test_assert(vec[i] == i);
+    }
+
+    FrameHashMap<u32, u32> map;
+    for(u32 i = 0; i != 1000; ++i) {
+        map[i] = i * 2;
+    }
+    y_test_assert(map.size() == 1000);
+    for(u32 i = 0; i != 1000; ++i) {
+        y_test_assert(map.find(i)->second == i * 2);
+    }
+
+    map.erase(map.find(7));
+    y_test_assert(map.find(7) == map.end());
+
+    usize thread_allocated = 0;
+    std::thread([&] {
+        FrameVector<u64> other;
+        other << 1 << 2 << 3;
+        thread_allocated = FrameArena::thread_arena().allocated_size();
+    }).join();
+    y_test_assert(thread_allocated > 0);
+
+    y_test_assert(FrameArena::next_frame().allocations > 2);
+}
+
+}
@@ -42,6 +42,12 @@ using namespace y::core;
 template<typename K, typename V, typename H = Hash<K>>
 using DefaultImpl = FlatHashMap<K, V, H>;
 
+template<typename K, typename V, typename H = Hash<K>>
+using QuadraticImpl = FlatHashMap<K, V, H, std::equal_to<K>, core::detail::ProbingStrategy::Quadratic>;
+
+template<typename K, typename V, typename H = Hash<K>>
+using GroupImpl = FlatHashMap<K, V, H, std::equal_to<K>, core::detail::ProbingStrategy::Group>;
+
 struct RaiiCounter : NonCopyable {
     RaiiCounter(usize* ptr) : counter(ptr) {
     }
@@ -186,13 +192,41 @@ y_test_func("HashMap fuzz") {
     const usize fuzz_count = 25000;
     const auto m0 = fuzz<std::unordered_map<i32, i32>>(fuzz_count, seed);
 
-    const auto m2 = fuzz<FlatHashMap<i32, i32>>(fuzz_count, seed);
-    /*const auto m3 = fuzz<FlatHashMap<i32, i32>>(fuzz_count, seed);
-    const auto m4 = fuzz<HashMap<i32, i32>>(fuzz_count, seed);*/
+    const auto m2 = fuzz<QuadraticImpl<i32, i32>>(fuzz_count, seed);
+    const auto m3 = fuzz<GroupImpl<i32, i32>>(fuzz_count, seed);
+    const auto m4 = fuzz<GroupImpl<i32, i32, BadHash<7>>>(fuzz_count, seed);
 
     y_test_assert(to_vector(m0) == to_vector(m2));
-    /*y_test_assert(to_vector(m0) == to_vector(m3));
-    y_test_assert(to_vector(m0) == to_vector(m4));*/
+    y_test_assert(to_vector(m0) == to_vector(m3));
+    y_test_assert(to_vector(m0) == to_vector(m4));
+}
+
+y_test_func("HashMap group erase") {
+    static constexpr int max_key = 5000;
+    GroupImpl<int, int> map;
+
+    for(int round = 0; round != 4; ++round) {
+        for(int i = 0; i != max_key; ++i) {
+            map.emplace(i, i + round);
+        }
+        y_test_assert(map.size() == max_key);
+
+        for(int i = 0; i != max_key; ++i) {
+            if(i % 4 != round) {
+                map.erase(i);
+            }
+        }
+
+        y_test_assert(map.size() == max_key / 4);
+        y_test_assert(usize(std::distance(map.begin(), map.end())) == map.size());
+
+        for(int i = 0; i != max_key; ++i) {
+            const auto it = map.find(i);
+            y_test_assert((it != map.end()) == (i % 4 == round));
+        }
+
+        map.make_empty();
+    }
 }
 
 
@@ -0,0 +1,133 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/serde3/archives.h>
+#include <y/test/test.h>
+
+#include <y/core/String.h>
+#include <y/utils/format.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <random>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+struct MappedData {
+    u32 magic = 0;
+    Vector<u32> values;
+    Vector<u8> bytes;
+
+    y_reflect(MappedData, magic, values, bytes)
+};
+
+static String temp_file_name() {
+    static u32 index = 0;
+    return (std::filesystem::temp_directory_path() / fmt("y_mapped_file_test_{}_{}", std::random_device()(), index++)).string();
+}
+
+static String write_temp_file(const void* data, usize size) {
+    const String name = temp_file_name();
+    auto file = io2::File::create(name);
+    if(file.is_error() || file.unwrap().write(data, size).is_error()) {
+        return {};
+    }
+    return name;
+}
+
+y_test_func("MappedFile read") {
+    Vector<u32> data(1024, u32(0));
+    std::iota(data.begin(), data.end(), 7);
+
+    const String name = write_temp_file(data.data(), data.size() * sizeof(u32));
+    y_test_assert(!name.is_empty());
+    y_defer(std::remove(name.data()));
+
+    auto r = io2::MappedFile::open(name);
+    y_test_assert(r.is_ok());
+
+    io2::MappedFile& file = r.unwrap();
+    y_test_assert(file.is_open());
+    y_test_assert(file.size() == data.size() * sizeof(u32));
+
+    u32 first = 0;
+    y_test_assert(file.read_one(first).is_ok());
+    y_test_assert(first == 7);
+
+    const u8* view = file.read_view(sizeof(u32));
+    y_test_assert(view == file.data() + sizeof(u32));
+    y_test_assert(file.tell() == 2 * sizeof(u32));
+
+    y_test_assert(!file.read_view(file.size()));
+    y_test_assert(file.tell() == 2 * sizeof(u32));
+
+    Vector<u8> rest;
+    y_test_assert(file.read_all(rest).unwrap() == file.size() - 2 * sizeof(u32));
+    y_test_assert(file.at_end());
+    y_test_assert(std::memcmp(rest.data(), data.data() + 2, rest.size()) == 0);
+}
+
+y_test_func("MappedFile empty") {
+    const String name = write_temp_file(nullptr, 0);
+    y_test_assert(!name.is_empty());
+    y_defer(std::remove(name.data()));
+
+    auto r = io2::MappedFile::open(name);
+    y_test_assert(r.is_ok());
+    y_test_assert(r.unwrap().is_open());
+    y_test_assert(r.unwrap().at_end());
+
+    u8 byte = 0;
+    y_test_assert(r.unwrap().read_one(byte).is_error());
+}
+
+y_test_func("MappedFile serde3 collections") {
+    MappedData data;
+    data.magic = 0xCAFE;
+    for(u32 i = 0; i != 4097; ++i) {
+        data.values << i * 3;
+        data.bytes << u8(i);
+    }
+
+    const String name = temp_file_name();
+    y_defer(std::remove(name.data()));
+    {
+        auto file = io2::File::create(name);
+        y_test_assert(file.is_ok());
+        y_test_assert(serde3::WritableArchive(file.unwrap()).serialize(data).is_ok());
+    }
+
+    auto file = io2::MappedFile::open(name);
+    y_test_assert(file.is_ok());
+
+    MappedData loaded;
+    y_test_assert(serde3::ReadableArchive(file.unwrap()).deserialize(loaded).is_ok());
+    y_test_assert(loaded.magic == data.magic);
+    y_test_assert(loaded.values == data.values);
+    y_test_assert(loaded.bytes == data.bytes);
+}
+
+}
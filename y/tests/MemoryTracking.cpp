@@ -0,0 +1,134 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/utils/memory_tracking.h>
+#include <y/test/test.h>
+
+#include <thread>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+using namespace y;
+
+y_test_func("Memory tracking tags") {
+    y_test_assert(memory_tracking::current_tag() == MemoryTag::Untagged);
+    {
+        y_memory_tag(MemoryTag::Assets);
+        y_test_assert(memory_tracking::current_tag() == MemoryTag::Assets);
+        {
+            y_memory_tag(MemoryTag::Scripting);
+            y_test_assert(memory_tracking::current_tag() == MemoryTag::Scripting);
+        }
+        y_test_assert(memory_tracking::current_tag() == MemoryTag::Assets);
+    }
+    y_test_assert(memory_tracking::current_tag() == MemoryTag::Untagged);
+}
+
+y_test_func("Memory tracking counters") {
+    const MemoryTag tag = MemoryTag::FrameGraph;
+    const memory_tracking::TagStats before = memory_tracking::tag_stats(tag);
+
+    y_test_assert(memory_tracking::on_alloc(100, tag));
+    y_test_assert(memory_tracking::on_alloc(28, tag));
+
+    {
+        const memory_tracking::TagStats stats = memory_tracking::tag_stats(tag);
+        y_test_assert(stats.live_bytes == before.live_bytes + 128);
+        y_test_assert(stats.live_allocations == before.live_allocations + 2);
+        y_test_assert(stats.total_allocations == before.total_allocations + 2);
+    }
+
+    // Freed from another thread
+    std::thread([=] { memory_tracking::on_free(100, tag); }).join();
+    memory_tracking::on_free(28, tag);
+
+    {
+        const memory_tracking::TagStats stats = memory_tracking::tag_stats(tag);
+        y_test_assert(stats.live_bytes == before.live_bytes);
+        y_test_assert(stats.live_allocations == before.live_allocations);
+        y_test_assert(stats.total_allocations == before.total_allocations + 2);
+    }
+
+    const usize big = memory_tracking::flush_threshold * 4;
+    y_test_assert(memory_tracking::on_alloc(big, tag));
+    memory_tracking::on_free(big, tag);
+
+    const memory_tracking::TagStats stats = memory_tracking::tag_stats(tag);
+    y_test_assert(stats.live_bytes == before.live_bytes);
+    y_test_assert(stats.peak_bytes >= before.live_bytes + big);
+}
+
+y_test_func("Memory tracking budgets") {
+    const MemoryTag tag = MemoryTag::Ecs;
+    const u64 live = memory_tracking::tag_stats(tag).live_bytes;
+
+    memory_tracking::set_budget(tag, live + 1024, memory_tracking::BudgetAction::Fail);
+    y_test_assert(memory_tracking::on_alloc(1000, tag));
+    y_test_assert(!memory_tracking::on_alloc(1000, tag));
+    y_test_assert(memory_tracking::tag_stats(tag).live_bytes == live + 1000);
+
+    memory_tracking::set_budget(tag, live + 1024, memory_tracking::BudgetAction::Log);
+    y_test_assert(memory_tracking::on_alloc(1000, tag));
+
+    memory_tracking::set_budget(tag, 0);
+    memory_tracking::on_free(1000, tag);
+    memory_tracking::on_free(1000, tag);
+    y_test_assert(memory_tracking::tag_stats(tag).live_bytes == live);
+}
+
+y_test_func("Memory tracking allocations") {
+    const MemoryTag tag = MemoryTag::Assets;
+    const memory_tracking::TagStats before = memory_tracking::tag_stats(tag);
+
+    void* ptr = nullptr;
+    void* aligned = nullptr;
+    {
+        y_memory_tag(tag);
+        ptr = memory_tracking::tracked_alloc(100);
+        aligned = memory_tracking::tracked_alloc(64, 256);
+    }
+    y_test_assert(reinterpret_cast<usize>(ptr) % max_alignment == 0);
+    y_test_assert(reinterpret_cast<usize>(aligned) % 256 == 0);
+    std::memset(aligned, 0xFF, 64);
+
+    y_test_assert(memory_tracking::tag_stats(tag).live_bytes == before.live_bytes + 164);
+
+    memory_tracking::tracked_free(ptr);
+    memory_tracking::tracked_free(aligned);
+    memory_tracking::tracked_free(nullptr);
+
+    y_test_assert(memory_tracking::tag_stats(tag).live_bytes == before.live_bytes);
+}
+
+y_test_func("Memory tracking stack sampling") {
+    memory_tracking::set_stack_sampling_rate(1);
+    y_test_assert(memory_tracking::on_alloc(64, MemoryTag::Editor));
+    memory_tracking::set_stack_sampling_rate(0);
+    memory_tracking::on_free(64, MemoryTag::Editor);
+
+    const auto samples = memory_tracking::stack_samples();
+    y_test_assert(std::any_of(samples.begin(), samples.end(), [](const memory_tracking::StackSample& sample) {
+        return sample.size == 64 && sample.tag == MemoryTag::Editor;
+    }));
+}
+
+}
@@ -0,0 +1,128 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/io2/File.h>
+#include <y/io2/ReadQueue.h>
+#include <y/test/test.h>
+
+#include <y/utils/format.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <random>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+static String temp_file_name() {
+    static u32 index = 0;
+    return (std::filesystem::temp_directory_path() / fmt("y_read_queue_test_{}_{}", std::random_device()(), index++)).string();
+}
+
+static String write_temp_file(core::Span<u32> data) {
+    const String name = temp_file_name();
+    auto file = io2::File::create(name);
+    if(file.is_error() || file.unwrap().write_array(data.data(), data.size()).is_error()) {
+        return {};
+    }
+    return name;
+}
+
+static bool test_backend(io2::ReadQueue::Backend backend) {
+    Vector<u32> data(64 * 1024, u32(0));
+    std::iota(data.begin(), data.end(), 1);
+
+    const String name = write_temp_file(data);
+    if(name.is_empty()) {
+        return false;
+    }
+    y_defer(std::remove(name.data()));
+
+    auto file = io2::AsyncFile::open(name);
+    if(file.is_error() || file.unwrap().size() != data.size() * sizeof(u32)) {
+        return false;
+    }
+
+    const usize chunk_count = 64;
+    const usize chunk_size = data.size() / chunk_count;
+
+    Vector<u32> chunks(data.size(), u32(0));
+    Vector<u32> scattered(data.size(), u32(0));
+    std::atomic<usize> ok_count = 0;
+    std::atomic<usize> err_count = 0;
+
+    {
+        io2::ReadQueue queue(16, backend);
+
+        const auto on_done = [&](io2::ReadResult r) {
+            ++(r.is_ok() ? ok_count : err_count);
+        };
+
+        for(usize i = 0; i != chunk_count; ++i) {
+            const usize offset = i * chunk_size;
+            const MutableSpan<u8> dst(reinterpret_cast<u8*>(chunks.data() + offset), chunk_size * sizeof(u32));
+            queue.read(file.unwrap(), offset * sizeof(u32), dst, on_done);
+        }
+
+        {
+            // Scatter the whole file in 3 uneven pieces
+            u8* bytes = reinterpret_cast<u8*>(scattered.data());
+            const usize total = scattered.size() * sizeof(u32);
+            const std::array<MutableSpan<u8>, 3> buffers = {
+                MutableSpan<u8>(bytes, 7),
+                MutableSpan<u8>(bytes + 7, total / 2),
+                MutableSpan<u8>(bytes + 7 + total / 2, total - 7 - total / 2),
+            };
+            queue.read_scatter(file.unwrap(), 0, buffers, on_done);
+        }
+
+        u32 past_end = 0;
+        queue.read(file.unwrap(), file.unwrap().size(), MutableSpan<u8>(reinterpret_cast<u8*>(&past_end), sizeof(past_end)), on_done);
+
+        queue.wait_until_idle();
+        if(queue.pending_requests()) {
+            return false;
+        }
+    }
+
+    return ok_count == chunk_count + 1 && err_count == 1 && chunks == data && scattered == data;
+}
+
+y_test_func("ReadQueue threaded") {
+    y_test_assert(test_backend(io2::ReadQueue::Backend::Threaded));
+}
+
+y_test_func("ReadQueue native") {
+    y_test_assert(test_backend(io2::ReadQueue::Backend::Native));
+}
+
+y_test_func("ReadQueue invalid file") {
+    io2::ReadQueue queue(4, io2::ReadQueue::Backend::Threaded);
+
+    bool failed = false;
+    u32 value = 0;
+    queue.read(io2::AsyncFile(), 0, MutableSpan<u8>(reinterpret_cast<u8*>(&value), sizeof(value)), [&](io2::ReadResult r) { failed = r.is_error(); });
+    y_test_assert(failed);
+}
+
+}
@@ -0,0 +1,199 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/core/TLSFAllocator.h>
+#include <y/test/test.h>
+
+#include <random>
+#include <algorithm>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+struct Range {
+    u64 offset;
+    u64 size;
+};
+
+y_test_func("TLSFAllocator basic") {
+    TLSFAllocator allocator(1024);
+    y_test_assert(allocator.available() == 1024);
+    y_test_assert(allocator.free_blocks() == 1);
+
+    const u64 a = allocator.alloc(100).unwrap();
+    const u64 b = allocator.alloc(200).unwrap();
+    const u64 c = allocator.alloc(300).unwrap();
+    y_test_assert(allocator.available() == 424);
+    y_test_assert(allocator.alloc(1000).is_error());
+
+    allocator.free(b);
+    y_test_assert(allocator.free_blocks() == 2);
+
+    allocator.free(a);
+    y_test_assert(allocator.free_blocks() == 2);
+
+    allocator.free(c);
+    y_test_assert(allocator.free_blocks() == 1);
+    y_test_assert(allocator.available() == 1024);
+    y_test_assert(allocator.largest_free_block() == 1024);
+    y_test_assert(allocator.alloc(1024).unwrap() == 0);
+}
+
+y_test_func("TLSFAllocator alignment") {
+    TLSFAllocator allocator(1 << 20);
+
+    y_test_assert(allocator.alloc(3).unwrap() == 0);
+    const u64 aligned = allocator.alloc(100, 256).unwrap();
+    y_test_assert(aligned == 256);
+
+    const u64 small = allocator.alloc(10).unwrap();
+    y_test_assert(small < 256);
+
+    allocator.free(aligned);
+    allocator.free(small);
+    allocator.free(0);
+    y_test_assert(allocator.free_blocks() == 1);
+    y_test_assert(allocator.allocation_count() == 0);
+}
+
+y_test_func("TLSFAllocator random") {
+    const u64 size = 1 << 24;
+    TLSFAllocator allocator(size);
+
+    std::mt19937 rng(11);
+    Vector<Range> ranges;
+
+    for(usize i = 0; i != 20000; ++i) {
+        if(ranges.is_empty() || rng() % 3) {
+            const u64 alloc_size = 1 + rng() % (rng() % 8 ? 512 : 65536);
+            const u64 alignment = u64(1) << (rng() % 9);
+            if(auto r = allocator.alloc(alloc_size, alignment)) {
+                y_test_assert(r.unwrap() % alignment == 0);
+                ranges.emplace_back(r.unwrap(), alloc_size);
+            }
+        } else {
+            const usize index = rng() % ranges.size();
+            allocator.free(ranges[index].offset);
+            ranges.erase_unordered(ranges.begin() + index);
+        }
+    }
+
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a.offset < b.offset; });
+    u64 allocated = 0;
+    for(usize i = 0; i != ranges.size(); ++i) {
+        y_test_assert(ranges[i].offset + ranges[i].size <= size);
+        y_test_assert(i == 0 || ranges[i - 1].offset + ranges[i - 1].size <= ranges[i].offset);
+        allocated += ranges[i].size;
+    }
+    y_test_assert(allocator.available() == size - allocated);
+    y_test_assert(allocator.allocation_count() == ranges.size());
+
+    for(const Range& range : ranges) {
+        allocator.free(range.offset);
+    }
+
+    y_test_assert(allocator.available() == size);
+    y_test_assert(allocator.free_blocks() == 1);
+    y_test_assert(allocator.largest_free_block() == size);
+}
+
+y_test_func("TLSFAllocator defragmentation") {
+    const u64 size = 1 << 16;
+    TLSFAllocator allocator(size);
+
+    // Every allocation writes its own offset in the simulated memory
+    Vector<u64> memory(size, u64(0));
+    Vector<Range> ranges;
+
+    std::mt19937 rng(5);
+    for(;;) {
+        const u64 alloc_size = 1 + rng() % 64;
+        auto r = allocator.alloc(alloc_size);
+        if(!r) {
+            break;
+        }
+        ranges.emplace_back(r.unwrap(), alloc_size);
+    }
+
+    Vector<Range> kept;
+    for(const Range& range : ranges) {
+        if(rng() % 2) {
+            allocator.free(range.offset);
+        } else {
+            std::fill_n(memory.begin() + range.offset, range.size, range.offset);
+            kept << range;
+        }
+    }
+
+    const float initial = allocator.fragmentation();
+    y_test_assert(initial > 0.5f);
+
+    for(usize pass = 0; pass != 100; ++pass) {
+        const auto moves = allocator.plan_defragmentation(1024);
+        if(moves.is_empty()) {
+            break;
+        }
+
+        u64 moved = 0;
+        for(const auto& move : moves) {
+            y_test_assert(move.dst < move.src);
+            std::copy_n(memory.begin() + move.src, move.size, memory.begin() + move.dst);
+            allocator.free(move.src);
+
+            auto it = std::find_if(kept.begin(), kept.end(), [&](const Range& r) { return r.offset == move.src; });
+            y_test_assert(it != kept.end() && it->size == move.size);
+            it->offset = move.dst;
+            moved += move.size;
+        }
+        y_test_assert(moved <= 1024);
+    }
+
+    y_test_assert(allocator.fragmentation() < initial);
+    y_test_assert(allocator.allocation_count() == kept.size());
+
+    for(const Range& range : kept) {
+        const u64 tag = memory[range.offset];
+        y_test_assert(std::all_of(memory.begin() + range.offset, memory.begin() + range.offset + range.size, [=](u64 v) { return v == tag; }));
+        allocator.free(range.offset);
+    }
+    y_test_assert(allocator.free_blocks() == 1);
+}
+
+y_test_func("TLSFAllocator defragmentation plan is not recomputed when unchanged") {
+    TLSFAllocator allocator(1024);
+
+    const u64 a = allocator.alloc(512).unwrap();
+    const u64 b = allocator.alloc(256).unwrap();
+    allocator.alloc(256).unwrap();
+    allocator.free(a);
+
+    // Budget is too small to move anything: the plan stays empty until something is freed
+    y_test_assert(allocator.plan_defragmentation(128).is_empty());
+    y_test_assert(allocator.plan_defragmentation(128).is_empty());
+
+    allocator.free(b);
+    const auto moves = allocator.plan_defragmentation(1024);
+    y_test_assert(moves.size() == 1);
+    y_test_assert(moves[0].src == 768 && moves[0].dst == 0);
+}
+
+}
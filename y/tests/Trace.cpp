@@ -0,0 +1,130 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/utils/trace.h>
+#include <y/io2/Buffer.h>
+#include <y/concurrent/concurrent.h>
+#include <y/test/test.h>
+
+#include <thread>
+#include <algorithm>
+
+namespace {
+using namespace y;
+
+static const trace::ThreadTrace* find_thread(const core::Vector<trace::ThreadTrace>& traces, u32 thread_id) {
+    const auto it = std::find_if(traces.begin(), traces.end(), [&](const trace::ThreadTrace& t) { return t.thread_id == thread_id; });
+    return it == traces.end() ? nullptr : &*it;
+}
+
+y_test_func("Trace zones") {
+    trace::clear();
+
+    {
+        const trace::Zone disabled("disabled");
+    }
+
+    trace::set_enabled(true);
+    {
+        const trace::Zone outer("outer");
+        {
+            const trace::Zone inner(trace::dynamic_name, "a very long dynamic zone name that will get truncated");
+        }
+        trace::plot("value", -12);
+        trace::message("hello");
+    }
+    trace::frame_mark();
+
+    u32 other_thread = 0;
+    std::thread([&] {
+        other_thread = concurrent::thread_id();
+        const trace::Zone zone("thread");
+    }).join();
+    trace::set_enabled(false);
+
+    const core::Vector<trace::ThreadTrace> traces = trace::collect();
+    const trace::ThreadTrace* main_trace = find_thread(traces, concurrent::thread_id());
+    y_test_assert(main_trace);
+
+    const auto& events = main_trace->events;
+    y_test_assert(events.size() == 5);
+    y_test_assert(events[0].name == "outer" && events[0].type == trace::EventType::Zone);
+    y_test_assert(events[1].name.size() == trace::max_dynamic_name_size);
+    y_test_assert(events[1].begin_ns >= events[0].begin_ns && events[1].end_ns <= events[0].end_ns);
+    y_test_assert(events[2].type == trace::EventType::Plot && events[2].value == -12);
+    y_test_assert(events[3].type == trace::EventType::Message && events[3].name == "hello");
+    y_test_assert(events[4].type == trace::EventType::Frame);
+
+    const trace::ThreadTrace* thread_trace = find_thread(traces, other_thread);
+    y_test_assert(thread_trace && thread_trace->events.size() == 1);
+}
+
+y_test_func("Trace ring buffer") {
+    trace::clear();
+    trace::set_enabled(true);
+    for(usize i = 0; i != trace::max_events_per_thread + 10; ++i) {
+        trace::plot("i", i64(i));
+    }
+    trace::set_enabled(false);
+
+    const core::Vector<trace::ThreadTrace> traces = trace::collect();
+    const trace::ThreadTrace* main_trace = find_thread(traces, concurrent::thread_id());
+    y_test_assert(main_trace && main_trace->events.size() == trace::max_events_per_thread);
+    y_test_assert(main_trace->events.first().value == 10);
+}
+
+y_test_func("Trace export") {
+    trace::clear();
+    trace::set_enabled(true);
+    {
+        const trace::Zone zone("\"quoted\"");
+        trace::plot("plot", 7);
+    }
+    trace::set_enabled(false);
+
+    core::Vector<trace::ThreadTrace> traces = trace::collect();
+
+    io2::Buffer binary;
+    y_test_assert(trace::write_binary(binary, traces).is_ok());
+    binary.reset();
+
+    auto loaded = trace::read_binary(binary);
+    y_test_assert(loaded.is_ok());
+    y_test_assert(loaded.unwrap().size() == traces.size());
+    for(usize i = 0; i != traces.size(); ++i) {
+        const auto& a = traces[i].events;
+        const auto& b = loaded.unwrap()[i].events;
+        y_test_assert(a.size() == b.size());
+        for(usize e = 0; e != a.size(); ++e) {
+            y_test_assert(a[e].name == b[e].name && a[e].begin_ns == b[e].begin_ns && a[e].end_ns == b[e].end_ns && a[e].value == b[e].value);
+        }
+    }
+
+    io2::Buffer json;
+    y_test_assert(trace::write_chrome_trace(json, traces).is_ok());
+    const std::string_view text(reinterpret_cast<const char*>(json.data()), json.size());
+    y_test_assert(text.starts_with("{\"displayTimeUnit\""));
+    y_test_assert(text.find("\"name\":\"\\\"quoted\\\"\"") != std::string_view::npos);
+    y_test_assert(text.find("\"ph\":\"C\"") != std::string_view::npos);
+    y_test_assert(text.find("\"args\":{\"value\":7}") != std::string_view::npos);
+}
+
+}
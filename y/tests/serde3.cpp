@@ -0,0 +1,111 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <y/io2/Buffer.h>
+#include <y/serde3/archives.h>
+#include <y/test/test.h>
+
+#include <y/core/String.h>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+struct Inner {
+    u32 a = 0;
+    float b = 0.0f;
+
+    bool operator==(const Inner&) const = default;
+
+    y_reflect(Inner, a, b)
+};
+
+struct Outer {
+    Inner inner;
+    u64 c = 0;
+    i16 d = 0;
+
+    bool operator==(const Outer&) const = default;
+
+    y_reflect(Outer, inner, c, d)
+};
+
+struct WithCollection {
+    Vector<Outer> values;
+    String name;
+
+    y_reflect(WithCollection, values, name)
+};
+
+static_assert(serde3::detail::use_static_layout<Outer>);
+static_assert(!serde3::detail::use_static_layout<WithCollection>);
+
+static WithCollection create_data() {
+    WithCollection data;
+    data.name = "static";
+    for(u32 i = 0; i != 100; ++i) {
+        data.values << Outer{Inner{i, i * 0.5f}, u64(i) << 40, i16(-i)};
+    }
+    return data;
+}
+
+y_test_func("serde3 static layout") {
+    const WithCollection data = create_data();
+
+    io2::Buffer buffer;
+    y_test_assert(serde3::WritableArchive(buffer).serialize(data).is_ok());
+    buffer.reset();
+
+    WithCollection loaded;
+    y_test_assert(serde3::ReadableArchive(buffer).deserialize(loaded).unwrap() == serde3::Success::Full);
+    y_test_assert(loaded.name == data.name);
+    y_test_assert(loaded.values == data.values);
+}
+
+y_test_func("serde3 static layout mismatch") {
+    const WithCollection data = create_data();
+
+    io2::Buffer buffer;
+    y_test_assert(serde3::WritableArchive(buffer).serialize(data).is_ok());
+
+    // Change the members hash of every Inner, as if it was written by another version of the type
+    Vector<u8> bytes;
+    bytes.push_back(buffer.data(), buffer.data() + buffer.size());
+
+    const u32 members_hash = serde3::detail::build_members_header<Inner>().member_hash;
+    usize patched = 0;
+    for(usize i = 0; i + sizeof(u32) <= bytes.size(); ++i) {
+        if(std::memcmp(&bytes[i], &members_hash, sizeof(u32)) == 0) {
+            bytes[i] ^= 0xFF;
+            ++patched;
+        }
+    }
+    y_test_assert(patched == data.values.size());
+
+    io2::Buffer patched_buffer(std::move(bytes));
+
+    WithCollection loaded;
+    y_test_assert(serde3::ReadableArchive(patched_buffer).deserialize(loaded).is_ok());
+    y_test_assert(loaded.name == data.name);
+    y_test_assert(loaded.values == data.values);
+}
+
+}
@@ -22,11 +22,14 @@ SOFTWARE.
 
 #include <y/utils.h>
 #include <y/utils/traits.h>
+#include <y/utils/sort.h>
 
 #include <y/test/test.h>
 
 #include <y/core/Vector.h>
 
+#include <random>
+
 namespace {
 using namespace y;
 
@@ -56,5 +59,30 @@ y_test_func("utils do_not_destroy") {
     }
     y_test_assert(i == 1);
 }
+y_test_func("utils radix_sort") {
+    std::mt19937_64 rng(7);
+
+    core::Vector<u64> keys;
+    core::Vector<u32> values;
+    for(u32 i = 0; i != 10000; ++i) {
+        // only touch a few bytes so that some passes are skipped
+        keys << ((rng() & 0xFF00FF) | (u64(rng() % 3) << 48));
+        values << i;
+    }
+
+    core::Vector<u64> expected(keys);
+    std::stable_sort(expected.begin(), expected.end());
+
+    core::Vector<u64> keys_buffer(keys.size(), u64(0));
+    core::Vector<u32> values_buffer(values.size(), u32(0));
+    const core::Vector<u64> original(keys);
+    radix_sort(keys.data(), values.data(), keys.size(), keys_buffer.data(), values_buffer.data());
+
+    y_test_assert(keys == expected);
+    for(usize i = 0; i != keys.size(); ++i) {
+        y_test_assert(original[values[i]] == keys[i]);
+        y_test_assert(!i || keys[i - 1] != keys[i] || values[i - 1] < values[i]);
+    }
+}
 }
 
@@ -0,0 +1,151 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "BitSet.h"
+#include "FrameArena.h"
+
+#include <bit>
+
+#if defined(__AVX2__)
+#define Y_BITSET_AVX2
+#include <immintrin.h>
+#endif
+
+namespace y {
+namespace core {
+
+static constexpr usize block_words = 4;
+
+// Words [w, w + 4), zero padded past the end of the set
+static inline const u64* load_block(const BitSet* set, usize w, u64 (&padded)[block_words]) {
+    const core::Span<u64> words = set->words();
+    if(w + block_words <= words.size()) {
+        return words.data() + w;
+    }
+
+    for(usize i = 0; i != block_words; ++i) {
+        padded[i] = w + i < words.size() ? words[w + i] : 0;
+    }
+    return padded;
+}
+
+template<typename V>
+static inline void push_indices(const u64* block, usize w, V& indices) {
+    for(usize i = 0; i != block_words; ++i) {
+        u64 word = block[i];
+        while(word) {
+            indices << u32((w + i) * BitSet::bits_per_word + std::countr_zero(word));
+            word &= word - 1;
+        }
+    }
+}
+
+
+void BitSet::clear() {
+    _words.clear();
+}
+
+void BitSet::make_empty() {
+    _words.make_empty();
+}
+
+void BitSet::swap(BitSet& other) {
+    _words.swap(other._words);
+}
+
+usize BitSet::count() const {
+    usize total = 0;
+    for(const u64 word : _words) {
+        total += std::popcount(word);
+    }
+    return total;
+}
+
+template<typename V>
+static void match_indices(core::Span<const BitSet*> includes, core::Span<const BitSet*> excludes, V& indices) {
+    if(includes.is_empty()) {
+        return;
+    }
+
+    usize word_count = includes[0]->words().size();
+    for(const BitSet* set : includes) {
+        word_count = std::min(word_count, set->words().size());
+    }
+
+    u64 padded[block_words] = {};
+
+    for(usize w = 0; w < word_count; w += block_words) {
+#ifdef Y_BITSET_AVX2
+        __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(load_block(includes[0], w, padded)));
+        for(usize i = 1; i != includes.size(); ++i) {
+            acc = _mm256_and_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(load_block(includes[i], w, padded))));
+        }
+        for(const BitSet* set : excludes) {
+            acc = _mm256_andnot_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(load_block(set, w, padded))), acc);
+        }
+
+        if(_mm256_testz_si256(acc, acc)) {
+            continue;
+        }
+
+        alignas(32) u64 block[block_words];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(block), acc);
+#else
+        u64 block[block_words];
+        {
+            const u64* first = load_block(includes[0], w, padded);
+            std::copy_n(first, block_words, block);
+        }
+        for(usize i = 1; i != includes.size(); ++i) {
+            const u64* words = load_block(includes[i], w, padded);
+            for(usize k = 0; k != block_words; ++k) {
+                block[k] &= words[k];
+            }
+        }
+        for(const BitSet* set : excludes) {
+            const u64* words = load_block(set, w, padded);
+            for(usize k = 0; k != block_words; ++k) {
+                block[k] &= ~words[k];
+            }
+        }
+
+        if(!(block[0] | block[1] | block[2] | block[3])) {
+            continue;
+        }
+#endif
+
+        // The last block can extend past word_count, but padded words are 0 for at least one include
+        push_indices(block, w, indices);
+    }
+}
+
+void BitSet::match(core::Span<const BitSet*> includes, core::Span<const BitSet*> excludes, core::Vector<u32>& indices) {
+    match_indices(includes, excludes, indices);
+}
+
+void BitSet::match(core::Span<const BitSet*> includes, core::Span<const BitSet*> excludes, core::FrameVector<u32>& indices) {
+    match_indices(includes, excludes, indices);
+}
+
+}
+}
+
@@ -0,0 +1,88 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CORE_BITSET_H
+#define Y_CORE_BITSET_H
+
+#include "Vector.h"
+
+namespace y {
+namespace core {
+
+template<typename T>
+class FrameAllocator;
+
+// Growable bit set, bits past the end read as 0
+class BitSet {
+    public:
+        static constexpr usize bits_per_word = 64;
+
+        BitSet() = default;
+
+        BitSet(BitSet&&) = default;
+        BitSet& operator=(BitSet&&) = default;
+
+        inline bool test(usize index) const {
+            const usize word = index / bits_per_word;
+            return word < _words.size() && (_words[word] >> (index % bits_per_word)) & 1;
+        }
+
+        inline void set(usize index) {
+            const usize word = index / bits_per_word;
+            _words.set_min_size(word + 1, u64(0));
+            _words[word] |= u64(1) << (index % bits_per_word);
+        }
+
+        inline void reset(usize index) {
+            const usize word = index / bits_per_word;
+            if(word < _words.size()) {
+                _words[word] &= ~(u64(1) << (index % bits_per_word));
+            }
+        }
+
+        inline usize size() const {
+            return _words.size() * bits_per_word;
+        }
+
+        inline core::Span<u64> words() const {
+            return _words;
+        }
+
+        void clear();
+        void make_empty();
+        void swap(BitSet& other);
+
+        usize count() const;
+
+        // Appends the index of every bit set in all of includes and in none of excludes, in increasing order.
+        // Words are processed 256 bits at a time, using AVX2 when available.
+        static void match(core::Span<const BitSet*> includes, core::Span<const BitSet*> excludes, core::Vector<u32>& indices);
+        static void match(core::Span<const BitSet*> includes, core::Span<const BitSet*> excludes, core::Vector<u32, FrameAllocator<u32>>& indices);
+
+    private:
+        core::Vector<u64> _words;
+};
+
+}
+}
+
+#endif // Y_CORE_BITSET_H
+
@@ -0,0 +1,170 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FrameArena.h"
+
+#include <atomic>
+#include <array>
+#include <bit>
+
+namespace y {
+namespace core {
+
+static std::atomic<u64> current_frame = 0;
+
+static std::atomic<u64> frame_allocations = 0;
+static std::atomic<u64> frame_allocated_bytes = 0;
+
+static std::atomic<u64> last_frame_allocations = 0;
+static std::atomic<u64> last_frame_allocated_bytes = 0;
+
+static std::atomic<usize> reserved_bytes = 0;
+
+struct ThreadArenas {
+    std::array<FrameArena, 2> arenas;
+    u64 frame = 0;
+};
+
+
+FrameArena::FrameArena(usize block_size) : _block_size(block_size) {
+}
+
+FrameArena::~FrameArena() {
+    reserved_bytes -= reserved_size();
+}
+
+void* FrameArena::allocate(usize size, usize alignment) {
+    y_debug_assert(std::has_single_bit(alignment));
+
+    u8* data = reinterpret_cast<u8*>(align_up_to(reinterpret_cast<usize>(_begin), alignment));
+    if(!_begin || data + size > _end) {
+        while(++_block_index < _blocks.size()) {
+            _begin = _blocks[_block_index].data.get();
+            _end = _begin + _blocks[_block_index].size;
+            data = reinterpret_cast<u8*>(align_up_to(reinterpret_cast<usize>(_begin), alignment));
+            if(data + size <= _end) {
+                break;
+            }
+        }
+
+        if(_block_index >= _blocks.size()) {
+            add_block(size + alignment);
+            data = reinterpret_cast<u8*>(align_up_to(reinterpret_cast<usize>(_begin), alignment));
+        }
+    }
+
+    y_debug_assert(data + size <= _end);
+
+    _begin = data + size;
+    _allocated += size;
+
+    frame_allocations.fetch_add(1, std::memory_order_relaxed);
+    frame_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    return data;
+}
+
+void FrameArena::reset() {
+    if(_blocks.size() > 1) {
+        // Merge everything into one block to avoid growing again next time
+        const usize total_size = reserved_size();
+        reserved_bytes -= total_size;
+        _blocks.clear();
+        add_block(total_size);
+    }
+
+    _block_index = 0;
+    _begin = _blocks.is_empty() ? nullptr : _blocks[0].data.get();
+    _end = _begin ? _begin + _blocks[0].size : nullptr;
+    _allocated = 0;
+}
+
+void FrameArena::add_block(usize min_size) {
+    const usize size = std::max(min_size, _block_size);
+
+    Block& block = _blocks.emplace_back();
+    block.data = std::make_unique_for_overwrite<u8[]>(size);
+    block.size = size;
+
+    _block_index = _blocks.size() - 1;
+    _begin = block.data.get();
+    _end = _begin + size;
+
+    reserved_bytes += size;
+}
+
+usize FrameArena::allocated_size() const {
+    return _allocated;
+}
+
+usize FrameArena::reserved_size() const {
+    usize size = 0;
+    for(const Block& block : _blocks) {
+        size += block.size;
+    }
+    return size;
+}
+
+FrameArena& FrameArena::thread_arena() {
+    static thread_local ThreadArenas thread_arenas;
+
+    const u64 frame = current_frame.load(std::memory_order_acquire);
+    FrameArena& arena = thread_arenas.arenas[frame % 2];
+    if(thread_arenas.frame != frame) {
+        // Whatever is in this arena was allocated two or more frames ago
+        thread_arenas.frame = frame;
+        arena.reset();
+    }
+
+    return arena;
+}
+
+FrameArena::FrameStats FrameArena::next_frame() {
+    FrameStats stats;
+    stats.allocations = frame_allocations.exchange(0, std::memory_order_relaxed);
+    stats.allocated_bytes = frame_allocated_bytes.exchange(0, std::memory_order_relaxed);
+
+    last_frame_allocations.store(stats.allocations, std::memory_order_relaxed);
+    last_frame_allocated_bytes.store(stats.allocated_bytes, std::memory_order_relaxed);
+
+    current_frame.fetch_add(1, std::memory_order_release);
+
+    return stats;
+}
+
+FrameArena::FrameStats FrameArena::last_frame_stats() {
+    FrameStats stats;
+    stats.allocations = last_frame_allocations.load(std::memory_order_relaxed);
+    stats.allocated_bytes = last_frame_allocated_bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+u64 FrameArena::frame_index() {
+    return current_frame.load(std::memory_order_acquire);
+}
+
+usize FrameArena::total_reserved_size() {
+    return reserved_bytes.load(std::memory_order_relaxed);
+}
+
+}
+}
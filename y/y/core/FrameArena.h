@@ -0,0 +1,122 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CORE_FRAMEARENA_H
+#define Y_CORE_FRAMEARENA_H
+
+#include "Vector.h"
+#include "HashMap.h"
+
+#include <y/utils/memory.h>
+
+namespace y {
+namespace core {
+
+// Linear allocator for short lived scratch data: allocations are a pointer bump and memory is only released in bulk by reset().
+class FrameArena : NonMovable {
+    public:
+        static constexpr usize default_block_size = 1024 * 1024;
+
+        struct FrameStats {
+            u64 allocations = 0;
+            u64 allocated_bytes = 0;
+        };
+
+        FrameArena(usize block_size = default_block_size);
+        ~FrameArena();
+
+        // alignment must be a power of two
+        void* allocate(usize size, usize alignment = max_alignment);
+
+        // Invalidates all allocations. Blocks are kept, and merged into a single one if the arena had to grow.
+        void reset();
+
+        usize allocated_size() const;
+        usize reserved_size() const;
+
+
+        // Arena of the calling thread for the current frame.
+        // Every thread has two arenas used on alternate frames: memory allocated during a frame stays valid until next_frame() has been called twice.
+        static FrameArena& thread_arena();
+
+        // Starts a new frame and returns the stats of the one that just ended
+        static FrameStats next_frame();
+
+        static FrameStats last_frame_stats();
+        static u64 frame_index();
+
+        // Total memory owned by all the thread arenas
+        static usize total_reserved_size();
+
+    private:
+        struct Block {
+            std::unique_ptr<u8[]> data;
+            usize size = 0;
+        };
+
+        void add_block(usize min_size);
+
+        core::Vector<Block> _blocks;
+        usize _block_index = 0;
+
+        u8* _begin = nullptr;
+        u8* _end = nullptr;
+
+        usize _allocated = 0;
+        usize _block_size = 0;
+};
+
+
+// Allocates from the calling thread's frame arena, deallocate is a no-op.
+template<typename T>
+class FrameAllocator {
+    public:
+        using value_type = T;
+
+        inline FrameAllocator() = default;
+
+        template<typename U>
+        inline FrameAllocator(const FrameAllocator<U>&) {
+        }
+
+        inline T* allocate(usize n) {
+            return static_cast<T*>(FrameArena::thread_arena().allocate(n * sizeof(T), alignof(T)));
+        }
+
+        inline void deallocate(T*, usize) {
+        }
+
+        template<typename U>
+        inline bool operator==(const FrameAllocator<U>&) const {
+            return true;
+        }
+};
+
+template<typename T>
+using FrameVector = Vector<T, FrameAllocator<T>>;
+
+template<typename Key, typename Value, typename Hasher = Hash<Key>, typename Equal = std::equal_to<Key>>
+using FrameHashMap = FlatHashMap<Key, Value, Hasher, Equal, detail::default_hash_map_probing_strategy, FrameAllocator<u8>>;
+
+}
+}
+
+#endif // Y_CORE_FRAMEARENA_H
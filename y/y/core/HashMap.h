@@ -29,9 +29,13 @@ SOFTWARE.
 #include <y/utils/traits.h>
 
 #include <functional>
+#include <memory>
+#include <bit>
 
-
-Y_TODO("Implement trick from here: https://www.youtube.com/watch?v=ncHmEUmJZf4")
+#if defined(__SSE2__) || defined(_M_X64)
+#define Y_HASHMAP_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace y {
 namespace core {
@@ -72,10 +76,43 @@ static constexpr double default_hash_map_max_load_factor = 2.0 / 3.0;
 
 enum class ProbingStrategy {
     Linear,
-    Quadratic
+    Quadratic,
+
+    // Swiss table style: probes groups of 16 states at once (quadratically across groups)
+    // https://www.youtube.com/watch?v=ncHmEUmJZf4
+    Group
 };
 
-static constexpr ProbingStrategy default_hash_map_probing_strategy = ProbingStrategy::Quadratic;
+static constexpr ProbingStrategy default_hash_map_probing_strategy = ProbingStrategy::Group;
+
+static constexpr usize hash_map_group_size = 16;
+
+// Bit i is set if group[i] == byte
+inline u32 group_match(const u8* group, u8 byte) {
+#ifdef Y_HASHMAP_SSE2
+    const __m128i states = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(states, _mm_set1_epi8(char(byte)))));
+#else
+    u32 mask = 0;
+    for(usize i = 0; i != hash_map_group_size; ++i) {
+        mask |= u32(group[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
+// Bit i is set if the high bit of group[i] is set
+inline u32 group_match_high_bit(const u8* group) {
+#ifdef Y_HASHMAP_SSE2
+    return u32(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+    u32 mask = 0;
+    for(usize i = 0; i != hash_map_group_size; ++i) {
+        mask |= u32(group[i] >> 7) << i;
+    }
+    return mask;
+#endif
+}
 
 // http://research.cs.vt.edu/AVresearch/hashing/quadratic.php
 template<ProbingStrategy Strategy = default_hash_map_probing_strategy>
@@ -86,11 +123,87 @@ inline constexpr usize probing_offset(usize i) {
         return (i * i + i) / 2;
     }
 }
+
+// Owning array of default constructed elements, allocated with a rebound Allocator
+template<typename T, typename Allocator>
+class HashMapArray : NonCopyable, std::allocator_traits<Allocator>::template rebind_alloc<T> {
+    using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    public:
+        inline HashMapArray() = default;
+
+        inline HashMapArray(usize size) : _data(allocator_traits::allocate(allocator(), size)), _size(size) {
+            for(usize i = 0; i != _size; ++i) {
+                ::new(_data + i) T();
+            }
+        }
+
+        inline HashMapArray(HashMapArray&& other) {
+            swap(other);
+        }
+
+        inline HashMapArray& operator=(HashMapArray&& other) {
+            swap(other);
+            return *this;
+        }
+
+        inline ~HashMapArray() {
+            if(_data) {
+                for(usize i = 0; i != _size; ++i) {
+                    _data[i].~T();
+                }
+                allocator_traits::deallocate(allocator(), _data, _size);
+            }
+        }
+
+        inline void swap(HashMapArray& other) {
+            if(&other != this) {
+                std::swap(allocator(), other.allocator());
+                std::swap(_data, other._data);
+                std::swap(_size, other._size);
+            }
+        }
+
+        inline usize size() const {
+            return _size;
+        }
+
+        inline T* data() {
+            return _data;
+        }
+
+        inline const T* data() const {
+            return _data;
+        }
+
+        inline T& operator[](usize i) {
+            y_debug_assert(i < _size);
+            return _data[i];
+        }
+
+        inline const T& operator[](usize i) const {
+            y_debug_assert(i < _size);
+            return _data[i];
+        }
+
+        static inline constexpr usize max_size() {
+            return usize(-1) / sizeof(T);
+        }
+
+    private:
+        inline allocator_type& allocator() {
+            return *this;
+        }
+
+        T* _data = nullptr;
+        usize _size = 0;
+};
 }
 
 
 namespace swiss {
-template<typename Key, typename Value, typename Hasher = Hash<Key>, typename Equal = std::equal_to<Key>>
+template<typename Key, typename Value, typename Hasher = Hash<Key>, typename Equal = std::equal_to<Key>, detail::ProbingStrategy Strategy = detail::default_hash_map_probing_strategy, typename Allocator = std::allocator<u8>>
 class FlatHashMap : Hasher, Equal {
     public:
         using key_type = std::remove_cvref_t<Key>;
@@ -100,6 +213,8 @@ class FlatHashMap : Hasher, Equal {
         static constexpr double max_load_factor = detail::default_hash_map_max_load_factor;
         static constexpr usize min_capacity = 16;
 
+        static_assert(min_capacity % detail::hash_map_group_size == 0);
+
     private:
         using pair_type = std::pair<key_type, mapped_type>;
 
@@ -117,10 +232,14 @@ class FlatHashMap : Hasher, Equal {
 
             u8 bits = 0;
 
+            // Top 7 bits of the hash, the low bits are used to find the bucket
+            static inline u8 hash_bits(usize hash) {
+                return u8(hash >> (sizeof(usize) * 8 - 7)) | has_hash_bit;
+            }
 
             inline void set_hash(usize hash) {
                 y_debug_assert(!is_full());
-                bits = u8(hash & 0xFF) | has_hash_bit;
+                bits = hash_bits(hash);
             }
 
             inline void make_empty() {
@@ -132,8 +251,8 @@ class FlatHashMap : Hasher, Equal {
                 return (bits & has_hash_bit) != 0;
             }
 
-            inline bool matches_hash(usize) const {
-                return is_full();
+            inline bool matches_hash(usize hash) const {
+                return bits == hash_bits(hash);
             }
 
             inline bool is_empty_strict() const {
@@ -308,8 +427,15 @@ class FlatHashMap : Hasher, Equal {
                 }
 
                 inline void find_next() {
-                    for(;_index < _parent->bucket_count() && !_parent->_states[_index].is_full(); ++_index) {
-                        // nothing
+                    const usize buckets = _parent->bucket_count();
+                    while(_index < buckets && !_parent->_states[_index].is_full()) {
+                        if(_index % detail::hash_map_group_size == 0) {
+                            // bucket_count is a multiple of the group size, so we can skip whole groups
+                            const u32 full = detail::group_match_high_bit(_parent->state_bytes(_index));
+                            _index += full ? usize(std::countr_zero(full)) : detail::hash_map_group_size;
+                        } else {
+                            ++_index;
+                        }
                     }
                     y_debug_assert(_index <= _parent->bucket_count());
                     y_debug_assert(at_end() || _parent->_states[_index].is_full());
@@ -329,6 +455,14 @@ class FlatHashMap : Hasher, Equal {
                 using pointer = value_type*;
         };
 
+        inline const u8* state_bytes(usize index) const {
+            return reinterpret_cast<const u8*>(_states.data() + index);
+        }
+
+        inline usize group_count() const {
+            return bucket_count() / detail::hash_map_group_size;
+        }
+
         inline bool should_expand() const {
             return bucket_count() * max_load_factor <= _size;
         }
@@ -351,6 +485,10 @@ class FlatHashMap : Hasher, Equal {
 
         template<typename K>
         Bucket find_bucket_for_insert(const K& key, usize h) {
+            if constexpr(Strategy == detail::ProbingStrategy::Group) {
+                return find_bucket_for_insert_group(key, h);
+            }
+
             const usize buckets = bucket_count();
             const usize hash_mask = buckets - 1;
             usize probes = 0;
@@ -359,7 +497,7 @@ class FlatHashMap : Hasher, Equal {
             {
                 usize best_index = invalid_index;
                 for(; probes <= _max_probe_len; ++probes) {
-                    const usize index = (h + detail::probing_offset<>(probes)) & hash_mask;
+                    const usize index = (h + detail::probing_offset<Strategy>(probes)) & hash_mask;
                     const State& state = _states[index];
                     if(!state.is_full()) {
                         if(state.is_empty_strict()) {
@@ -379,7 +517,7 @@ class FlatHashMap : Hasher, Equal {
             }
 
             for(; probes < buckets; ++probes) {
-                const usize index = (h + detail::probing_offset<>(probes)) & hash_mask;
+                const usize index = (h + detail::probing_offset<Strategy>(probes)) & hash_mask;
                 if(!_states[index].is_full()) {
                     _max_probe_len = probes;
                     return {index, h};
@@ -389,6 +527,64 @@ class FlatHashMap : Hasher, Equal {
             y_fatal("Internal error: unable to find empty bucket");
         }
 
+        template<typename K>
+        Bucket find_bucket_for_insert_group(const K& key, usize h) {
+            const usize group_mask = group_count() - 1;
+            usize best_index = invalid_index;
+
+            y_debug_assert(bucket_count());
+
+            for(usize probes = 0; probes <= group_mask; ++probes) {
+                const usize first = ((h + detail::probing_offset<detail::ProbingStrategy::Quadratic>(probes)) & group_mask) * detail::hash_map_group_size;
+                const u8* group = state_bytes(first);
+
+                for(u32 matches = detail::group_match(group, State::hash_bits(h)); matches; matches &= matches - 1) {
+                    const usize index = first + std::countr_zero(matches);
+                    if(equal(_entries[index].key(), key)) {
+                        return {index, h};
+                    }
+                }
+
+                if(best_index == invalid_index) {
+                    if(const u32 available = ~detail::group_match_high_bit(group) & 0xFFFF) {
+                        best_index = first + std::countr_zero(available);
+                    }
+                }
+
+                // The key can not be further than a group with an empty state
+                if(detail::group_match(group, State::empty_bits)) {
+                    break;
+                }
+            }
+
+            if(best_index != invalid_index) {
+                return {best_index, h};
+            }
+
+            y_fatal("Internal error: unable to find empty bucket");
+        }
+
+        template<typename K>
+        usize find_bucket_group(const K& key, usize h) const {
+            const usize group_mask = group_count() - 1;
+            for(usize probes = 0; probes <= group_mask; ++probes) {
+                const usize first = ((h + detail::probing_offset<detail::ProbingStrategy::Quadratic>(probes)) & group_mask) * detail::hash_map_group_size;
+                const u8* group = state_bytes(first);
+
+                for(u32 matches = detail::group_match(group, State::hash_bits(h)); matches; matches &= matches - 1) {
+                    const usize index = first + std::countr_zero(matches);
+                    if(equal(_entries[index].key(), key)) {
+                        return index;
+                    }
+                }
+
+                if(detail::group_match(group, State::empty_bits)) {
+                    return invalid_index;
+                }
+            }
+            return invalid_index;
+        }
+
         template<typename K>
         usize find_bucket(const K& key) const {
             if(is_empty()) {
@@ -396,9 +592,14 @@ class FlatHashMap : Hasher, Equal {
             }
 
             const usize h = hash(key);
+
+            if constexpr(Strategy == detail::ProbingStrategy::Group) {
+                return find_bucket_group(key, h);
+            }
+
             const usize hash_mask = bucket_count() - 1;
             for(usize i = 0; i <= _max_probe_len; ++i) {
-                const usize index = (h + detail::probing_offset<>(i)) & hash_mask;
+                const usize index = (h + detail::probing_offset<Strategy>(i)) & hash_mask;
                 const State& state = _states[index];
                 if(state.matches_hash(h)) {
                     if(equal(_entries[index].key(), key)) {
@@ -421,8 +622,8 @@ class FlatHashMap : Hasher, Equal {
                 return;
             }
 
-            auto old_states = std::exchange(_states, FixedArray<State>(new_size));
-            auto old_entries = std::exchange(_entries, std::make_unique_for_overwrite<Entry[]>(new_size));
+            auto old_states = std::exchange(_states, detail::HashMapArray<State, Allocator>(new_size));
+            auto old_entries = std::exchange(_entries, detail::HashMapArray<Entry, Allocator>(new_size));
             _max_probe_len = 0;
 
             if(_size) {
@@ -448,8 +649,8 @@ class FlatHashMap : Hasher, Equal {
             expand(bucket_count() == 0 ? min_capacity : 2 * bucket_count());
         }
 
-        FixedArray<State> _states;
-        std::unique_ptr<Entry[]> _entries;
+        detail::HashMapArray<State, Allocator> _states;
+        detail::HashMapArray<Entry, Allocator> _entries;
         usize _size = 0;
         usize _max_probe_len = 0;
 
@@ -476,8 +677,8 @@ class FlatHashMap : Hasher, Equal {
 
         inline void swap(FlatHashMap& other) {
             if(&other != this) {
-                std::swap(_states, other._states);
-                std::swap(_entries, other._entries);
+                _states.swap(other._states);
+                _entries.swap(other._entries);
                 std::swap(_size, other._size);
                 std::swap(_max_probe_len, other._max_probe_len);
             }
@@ -503,8 +704,8 @@ class FlatHashMap : Hasher, Equal {
 
         inline void clear() {
             make_empty();
-            _states.clear();
-            _entries = nullptr;
+            _states = {};
+            _entries = {};
         }
 
         inline iterator begin() {
@@ -628,7 +829,18 @@ class FlatHashMap : Hasher, Equal {
             y_debug_assert(_states[index].is_full());
 
             _entries[index].clear();
-            _states[index].make_empty();
+
+            if constexpr(Strategy == detail::ProbingStrategy::Group) {
+                // Lookups never go past a group with an empty state, so no tombstone is needed
+                const usize first = index - index % detail::hash_map_group_size;
+                if(detail::group_match(state_bytes(first), State::empty_bits)) {
+                    _states[index] = State();
+                } else {
+                    _states[index].make_empty();
+                }
+            } else {
+                _states[index].make_empty();
+            }
 
             --_size;
         }
@@ -0,0 +1,339 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "TLSFAllocator.h"
+
+#include <bit>
+#include <algorithm>
+
+namespace y {
+namespace core {
+
+static u64 align_up(u64 offset, u64 alignment) {
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+TLSFAllocator::TLSFAllocator(u64 size) : _size(size), _free(size) {
+    if(size) {
+        insert_free(create_block(0, size));
+    }
+}
+
+TLSFAllocator::BinIndex TLSFAllocator::bin_index(u64 size) {
+    if(size < sl_count) {
+        return {0, u32(size)};
+    }
+
+    const u32 msb = 63 - u32(std::countl_zero(size));
+    return {
+        msb - sl_log2 + 1,
+        u32(size >> (msb - sl_log2)) - sl_count
+    };
+}
+
+// Any block in the bin of the rounded size is big enough
+u64 TLSFAllocator::round_up_to_bin(u64 size) {
+    if(size < sl_count) {
+        return size;
+    }
+
+    const u32 msb = 63 - u32(std::countl_zero(size));
+    return size + (u64(1) << (msb - sl_log2)) - 1;
+}
+
+u32 TLSFAllocator::create_block(u64 offset, u64 size) {
+    Block block;
+    block.offset = offset;
+    block.size = size;
+
+    if(!_unused_blocks.is_empty()) {
+        const u32 index = _unused_blocks.pop();
+        _blocks[index] = block;
+        return index;
+    }
+
+    _blocks << block;
+    return u32(_blocks.size() - 1);
+}
+
+void TLSFAllocator::destroy_block(u32 index) {
+    _unused_blocks << index;
+}
+
+void TLSFAllocator::insert_free(u32 index) {
+    Block& block = _blocks[index];
+    const BinIndex bin = bin_index(block.size);
+
+    const bool has_head = (_sl_bitmaps[bin.fl] >> bin.sl) & 1;
+    const u32 head = has_head ? _heads[bin.fl][bin.sl] : null_block;
+
+    block.is_free = true;
+    block.prev_free = null_block;
+    block.next_free = head;
+    if(head != null_block) {
+        _blocks[head].prev_free = index;
+    }
+
+    _heads[bin.fl][bin.sl] = index;
+    _sl_bitmaps[bin.fl] |= u32(1) << bin.sl;
+    _fl_bitmap |= u64(1) << bin.fl;
+
+    ++_free_blocks;
+}
+
+void TLSFAllocator::remove_free(u32 index) {
+    Block& block = _blocks[index];
+    y_debug_assert(block.is_free);
+
+    if(block.prev_free != null_block) {
+        _blocks[block.prev_free].next_free = block.next_free;
+    } else {
+        const BinIndex bin = bin_index(block.size);
+        _heads[bin.fl][bin.sl] = block.next_free;
+        if(block.next_free == null_block) {
+            _sl_bitmaps[bin.fl] &= ~(u32(1) << bin.sl);
+            if(!_sl_bitmaps[bin.fl]) {
+                _fl_bitmap &= ~(u64(1) << bin.fl);
+            }
+        }
+    }
+
+    if(block.next_free != null_block) {
+        _blocks[block.next_free].prev_free = block.prev_free;
+    }
+
+    block.is_free = false;
+    block.prev_free = null_block;
+    block.next_free = null_block;
+
+    --_free_blocks;
+}
+
+u32 TLSFAllocator::find_free(u64 size) const {
+    BinIndex bin = bin_index(round_up_to_bin(size));
+    if(bin.fl >= fl_count) {
+        return null_block;
+    }
+
+    u32 sl_map = _sl_bitmaps[bin.fl] & (~u32(0) << bin.sl);
+    if(!sl_map) {
+        const u64 fl_map = bin.fl + 1 < 64 ? _fl_bitmap & (~u64(0) << (bin.fl + 1)) : 0;
+        if(!fl_map) {
+            return null_block;
+        }
+
+        bin.fl = u32(std::countr_zero(fl_map));
+        sl_map = _sl_bitmaps[bin.fl];
+    }
+
+    y_debug_assert(sl_map);
+    bin.sl = u32(std::countr_zero(sl_map));
+    return _heads[bin.fl][bin.sl];
+}
+
+// Shrinks the block to size and returns the index of the new block holding the rest
+u32 TLSFAllocator::split(u32 index, u64 size) {
+    y_debug_assert(_blocks[index].size > size);
+
+    const u64 offset = _blocks[index].offset;
+    const u64 rest = _blocks[index].size - size;
+    const u32 next = _blocks[index].next_phys;
+
+    const u32 back = create_block(offset + size, rest);
+
+    Block& block = _blocks[index];
+    block.size = size;
+    block.next_phys = back;
+
+    _blocks[back].prev_phys = index;
+    _blocks[back].next_phys = next;
+    if(next != null_block) {
+        _blocks[next].prev_phys = back;
+    }
+
+    return back;
+}
+
+core::Result<u64> TLSFAllocator::alloc(u64 size, u64 alignment) {
+    y_debug_assert(std::has_single_bit(alignment));
+
+    size = std::max(size, u64(1));
+
+    u32 index = find_free(size);
+    if(index != null_block && align_up(_blocks[index].offset, alignment) + size > _blocks[index].offset + _blocks[index].size) {
+        index = find_free(size + alignment - 1);
+    }
+
+    if(index == null_block) {
+        return core::Err();
+    }
+
+    remove_free(index);
+
+    const u64 aligned = align_up(_blocks[index].offset, alignment);
+    if(aligned != _blocks[index].offset) {
+        const u32 back = split(index, aligned - _blocks[index].offset);
+        insert_free(index);
+        index = back;
+    }
+
+    if(_blocks[index].size > size) {
+        insert_free(split(index, size));
+    }
+
+    y_debug_assert(_blocks[index].offset == aligned);
+    y_debug_assert(_blocks[index].size == size);
+
+    _blocks[index].alignment = alignment;
+
+    _free -= size;
+    _allocated.emplace(aligned, index);
+    ++_revision;
+
+    return core::Ok(aligned);
+}
+
+void TLSFAllocator::free(u64 offset) {
+    const auto it = _allocated.find(offset);
+    y_always_assert(it != _allocated.end(), "Offset has not been allocated");
+
+    u32 index = it->second;
+    _allocated.erase(it);
+    ++_revision;
+
+    _free += _blocks[index].size;
+
+    if(const u32 prev = _blocks[index].prev_phys; prev != null_block && _blocks[prev].is_free) {
+        remove_free(prev);
+
+        const u32 next = _blocks[index].next_phys;
+        _blocks[prev].size += _blocks[index].size;
+        _blocks[prev].next_phys = next;
+        if(next != null_block) {
+            _blocks[next].prev_phys = prev;
+        }
+
+        destroy_block(index);
+        index = prev;
+    }
+
+    if(const u32 next = _blocks[index].next_phys; next != null_block && _blocks[next].is_free) {
+        remove_free(next);
+
+        const u32 next_next = _blocks[next].next_phys;
+        _blocks[index].size += _blocks[next].size;
+        _blocks[index].next_phys = next_next;
+        if(next_next != null_block) {
+            _blocks[next_next].prev_phys = index;
+        }
+
+        destroy_block(next);
+    }
+
+    insert_free(index);
+}
+
+u64 TLSFAllocator::size() const {
+    return _size;
+}
+
+u64 TLSFAllocator::available() const {
+    return _free;
+}
+
+usize TLSFAllocator::free_blocks() const {
+    return _free_blocks;
+}
+
+usize TLSFAllocator::allocation_count() const {
+    return _allocated.size();
+}
+
+u64 TLSFAllocator::largest_free_block() const {
+    if(!_fl_bitmap) {
+        return 0;
+    }
+
+    const u32 fl = 63 - u32(std::countl_zero(_fl_bitmap));
+    const u32 sl = 31 - u32(std::countl_zero(_sl_bitmaps[fl]));
+
+    u64 largest = 0;
+    for(u32 index = _heads[fl][sl]; index != null_block; index = _blocks[index].next_free) {
+        largest = std::max(largest, _blocks[index].size);
+    }
+    return largest;
+}
+
+float TLSFAllocator::fragmentation() const {
+    if(!_free) {
+        return 0.0f;
+    }
+    return 1.0f - float(largest_free_block()) / float(_free);
+}
+
+core::Vector<TLSFAllocator::Move> TLSFAllocator::plan_defragmentation(u64 max_size) {
+    // Planning is O(n log n), don't redo it every frame when nothing can be moved anyway
+    if(_revision == _empty_plan_revision) {
+        return {};
+    }
+
+    core::Vector<u32> candidates = core::Vector<u32>::with_capacity(_allocated.size());
+    for(const auto& [offset, index] : _allocated) {
+        candidates << index;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [&](u32 a, u32 b) {
+        return _blocks[a].offset > _blocks[b].offset;
+    });
+
+    core::Vector<Move> moves;
+    u64 moved = 0;
+    for(const u32 index : candidates) {
+        const u64 size = _blocks[index].size;
+        if(moved + size > max_size) {
+            continue;
+        }
+
+        const u64 src = _blocks[index].offset;
+        const auto dst = alloc(size, _blocks[index].alignment);
+        if(!dst) {
+            continue;
+        }
+
+        if(dst.unwrap() > src) {
+            free(dst.unwrap());
+            continue;
+        }
+
+        moves.emplace_back(src, dst.unwrap(), size);
+        moved += size;
+    }
+
+    if(moves.is_empty()) {
+        _empty_plan_revision = _revision;
+    }
+
+    return moves;
+}
+
+}
+}
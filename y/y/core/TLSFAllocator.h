@@ -0,0 +1,132 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CORE_TLSFALLOCATOR_H
+#define Y_CORE_TLSFALLOCATOR_H
+
+#include "Vector.h"
+#include "HashMap.h"
+#include "Result.h"
+
+#include <array>
+
+namespace y {
+namespace core {
+
+// Two level segregated fit allocator over an abstract [0, size) range, it never touches the memory it manages.
+// Allocation and free are O(1): free blocks are merged with their neighbours immediately.
+class TLSFAllocator : NonCopyable {
+    public:
+        // Planned relocation of an allocation, size is in the same unit as offsets
+        struct Move {
+            u64 src = 0;
+            u64 dst = 0;
+            u64 size = 0;
+        };
+
+        TLSFAllocator() = default;
+        TLSFAllocator(u64 size);
+
+        TLSFAllocator(TLSFAllocator&&) = default;
+        TLSFAllocator& operator=(TLSFAllocator&&) = default;
+
+        // alignment must be a power of two
+        core::Result<u64> alloc(u64 size, u64 alignment = 1);
+
+        // offset must have been returned by alloc
+        void free(u64 offset);
+
+        u64 size() const;
+        u64 available() const;
+
+        usize free_blocks() const;
+        usize allocation_count() const;
+
+        // Size of the biggest allocation that can succeed with an alignment of 1
+        u64 largest_free_block() const;
+
+        // 0 when all the free space is in a single block, tends toward 1 as it gets split in small blocks
+        float fragmentation() const;
+
+        // Moves the highest allocations into free space below them, until max_size has been moved.
+        // Destinations are allocated and sources are kept: they must be freed once the data has been copied.
+        // Returns immediately if nothing has been allocated or freed since the last plan that found no move.
+        core::Vector<Move> plan_defragmentation(u64 max_size);
+
+    private:
+        static constexpr u32 sl_log2 = 5;
+        static constexpr u32 sl_count = 1 << sl_log2;
+        static constexpr u32 fl_count = 64 - sl_log2 + 1;
+
+        static constexpr u32 null_block = u32(-1);
+
+        struct Block {
+            u64 offset = 0;
+            u64 size = 0;
+
+            u32 prev_phys = null_block;
+            u32 next_phys = null_block;
+
+            u32 prev_free = null_block;
+            u32 next_free = null_block;
+
+            u64 alignment = 1;
+
+            bool is_free = false;
+        };
+
+        struct BinIndex {
+            u32 fl = 0;
+            u32 sl = 0;
+        };
+
+        static BinIndex bin_index(u64 size);
+        static u64 round_up_to_bin(u64 size);
+
+        u32 create_block(u64 offset, u64 size);
+        void destroy_block(u32 index);
+
+        void insert_free(u32 index);
+        void remove_free(u32 index);
+        u32 find_free(u64 size) const;
+
+        u32 split(u32 index, u64 size);
+
+        core::Vector<Block> _blocks;
+        core::Vector<u32> _unused_blocks;
+        core::FlatHashMap<u64, u32> _allocated;
+
+        u64 _fl_bitmap = 0;
+        std::array<u32, fl_count> _sl_bitmaps = {};
+        std::array<std::array<u32, sl_count>, fl_count> _heads = {};
+
+        u64 _size = 0;
+        u64 _free = 0;
+        usize _free_blocks = 0;
+
+        u64 _revision = 0;
+        u64 _empty_plan_revision = u64(-1);
+};
+
+}
+}
+
+#endif // Y_CORE_TLSFALLOCATOR_H
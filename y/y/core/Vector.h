@@ -225,7 +225,15 @@ class Vector : Allocator, detail::SBOStorage<Elem, SBOCapacity::value> {
         template<typename It>
         inline void push_back(It beg_it, It end_it) {
             set_min_capacity(size() + std::distance(beg_it, end_it));
-            std::copy(beg_it, end_it, std::back_inserter(*this));
+            if constexpr(std::is_pointer_v<It> && std::is_trivially_copyable_v<data_type> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<It>>, data_type>) {
+                const usize count = usize(end_it - beg_it);
+                if(count) {
+                    std::memcpy(static_cast<void*>(_data_end), beg_it, count * sizeof(data_type));
+                    _data_end += count;
+                }
+            } else {
+                std::copy(beg_it, end_it, std::back_inserter(*this));
+            }
         }
 
         template<typename... Args>
@@ -29,6 +29,9 @@ Buffer::Buffer(usize size) {
     _buffer.set_min_capacity(size);
 }
 
+Buffer::Buffer(core::Vector<u8> data) : _buffer(std::move(data)) {
+}
+
 Buffer::~Buffer() {
 }
 
@@ -92,6 +95,15 @@ ReadUpToResult Buffer::read_all(core::Vector<u8>& data) {
     return core::Ok(r);
 }
 
+const u8* Buffer::read_view(usize bytes) {
+    if(remaining() < bytes) {
+        return nullptr;
+    }
+    const u8* view = _buffer.data() + _cursor;
+    _cursor += bytes;
+    return view;
+}
+
 WriteResult Buffer::write(const void* data, usize bytes) {
     const u8* data_bytes = static_cast<const u8*>(data);
     if(at_end()) {
@@ -30,6 +30,7 @@ namespace io2 {
 class Buffer final : public Reader, public Writer {
     public:
         Buffer(usize size = 0);
+        Buffer(core::Vector<u8> data);
         ~Buffer() override;
 
         bool at_end() const override;
@@ -46,6 +47,8 @@ class Buffer final : public Reader, public Writer {
         ReadUpToResult read_up_to(void* data, usize max_bytes) override;
         ReadUpToResult read_all(core::Vector<u8>& data) override;
 
+        const u8* read_view(usize bytes) override;
+
         WriteResult write(const void* data, usize bytes) override;
 
         FlushResult flush() override;
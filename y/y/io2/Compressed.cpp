@@ -0,0 +1,692 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "Compressed.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace y {
+namespace io2 {
+
+namespace lz {
+static constexpr usize min_match = 4;
+static constexpr usize last_literals = 5;
+static constexpr usize match_find_limit = 12;
+static constexpr usize max_offset = 0xFFFF;
+static constexpr usize hash_log = 14;
+static constexpr usize skip_trigger = 6;
+
+static inline u32 read_u32(const u8* p) {
+    u32 v = 0;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline u32 hash(u32 v) {
+    return (v * 2654435761u) >> (32 - hash_log);
+}
+
+static inline bool write_length(u8*& op, const u8* op_end, usize len) {
+    for(; len >= 255; len -= 255) {
+        if(op == op_end) {
+            return false;
+        }
+        *op++ = 255;
+    }
+    if(op == op_end) {
+        return false;
+    }
+    *op++ = u8(len);
+    return true;
+}
+
+static inline bool read_length(const u8*& ip, const u8* ip_end, usize& len) {
+    u8 b = 0;
+    do {
+        if(ip == ip_end) {
+            return false;
+        }
+        b = *ip++;
+        len += b;
+    } while(b == 255);
+    return true;
+}
+
+static bool write_sequence(u8*& op, const u8* op_end, const u8* literals, usize literal_len, usize offset, usize match_len) {
+    if(op == op_end) {
+        return false;
+    }
+
+    u8* token = op++;
+    *token = u8(std::min(literal_len, usize(15)) << 4);
+    if(literal_len >= 15 && !write_length(op, op_end, literal_len - 15)) {
+        return false;
+    }
+
+    if(usize(op_end - op) < literal_len) {
+        return false;
+    }
+    std::memcpy(op, literals, literal_len);
+    op += literal_len;
+
+    if(!match_len) {
+        return true;
+    }
+
+    if(op_end - op < 2) {
+        return false;
+    }
+    *op++ = u8(offset & 0xFF);
+    *op++ = u8(offset >> 8);
+
+    const usize len = match_len - min_match;
+    *token |= u8(std::min(len, usize(15)));
+    return len < 15 || write_length(op, op_end, len - 15);
+}
+}
+
+usize max_compressed_size(usize src_size) {
+    return src_size + src_size / 255 + 16;
+}
+
+usize compress_block(const u8* src, usize src_size, u8* dst, usize dst_capacity) {
+    u8* op = dst;
+    const u8* op_end = dst + dst_capacity;
+
+    usize anchor = 0;
+
+    if(src_size > lz::match_find_limit) {
+        u32 table[usize(1) << lz::hash_log] = {};
+
+        const usize match_limit = src_size - lz::last_literals;
+        const usize ip_limit = src_size - lz::match_find_limit;
+
+        usize ip = 0;
+        while(ip < ip_limit) {
+            const u32 sequence = lz::read_u32(src + ip);
+            const u32 h = lz::hash(sequence);
+            const usize candidate = table[h];
+            table[h] = u32(ip);
+
+            if(candidate >= ip || ip - candidate > lz::max_offset || lz::read_u32(src + candidate) != sequence) {
+                // Skip faster through data that doesn't compress
+                ip += 1 + ((ip - anchor) >> lz::skip_trigger);
+                continue;
+            }
+
+            usize len = lz::min_match;
+            while(ip + len < match_limit && src[candidate + len] == src[ip + len]) {
+                ++len;
+            }
+
+            if(!lz::write_sequence(op, op_end, src + anchor, ip - anchor, ip - candidate, len)) {
+                return 0;
+            }
+
+            ip += len;
+            anchor = ip;
+
+            if(ip < ip_limit) {
+                table[lz::hash(lz::read_u32(src + ip - 2))] = u32(ip - 2);
+            }
+        }
+    }
+
+    if(!lz::write_sequence(op, op_end, src + anchor, src_size - anchor, 0, 0)) {
+        return 0;
+    }
+
+    return usize(op - dst);
+}
+
+bool decompress_block(const u8* src, usize src_size, u8* dst, usize dst_size) {
+    const u8* ip = src;
+    const u8* ip_end = src + src_size;
+    u8* op = dst;
+    u8* op_end = dst + dst_size;
+
+    for(;;) {
+        if(ip == ip_end) {
+            return false;
+        }
+
+        const u8 token = *ip++;
+
+        usize literal_len = token >> 4;
+        if(literal_len == 15 && !lz::read_length(ip, ip_end, literal_len)) {
+            return false;
+        }
+
+        if(usize(ip_end - ip) < literal_len || usize(op_end - op) < literal_len) {
+            return false;
+        }
+        std::memcpy(op, ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+
+        if(ip == ip_end) {
+            break;
+        }
+
+        if(ip_end - ip < 2) {
+            return false;
+        }
+        const usize offset = usize(ip[0]) | (usize(ip[1]) << 8);
+        ip += 2;
+
+        if(!offset || offset > usize(op - dst)) {
+            return false;
+        }
+
+        usize match_len = token & 0x0F;
+        if(match_len == 15 && !lz::read_length(ip, ip_end, match_len)) {
+            return false;
+        }
+        match_len += lz::min_match;
+
+        if(usize(op_end - op) < match_len) {
+            return false;
+        }
+
+        const u8* match = op - offset;
+        if(offset >= match_len) {
+            std::memcpy(op, match, match_len);
+            op += match_len;
+        } else {
+            // Overlapping copy, used for runs
+            for(usize i = 0; i != match_len; ++i) {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return op == op_end;
+}
+
+
+
+
+namespace detail {
+// Streams written before blocks were flushed one at a time store the block table right after the header
+static constexpr u32 table_compressed_magic = 0x015A4C79;
+static constexpr u32 compressed_magic = 0x025A4C79;
+static constexpr u32 raw_block_bit = 0x80000000;
+
+static_assert(CompressedWriter::max_block_size < raw_block_bit);
+
+struct CompressedHeader {
+    u32 magic = compressed_magic;
+    u32 block_size = 0;
+};
+
+struct TableHeader {
+    u64 size = 0;
+    u64 block_count = 0;
+};
+
+// Last bytes of the stream, after the block table, the patches and the patch data
+struct CompressedTrailer {
+    u64 size = 0;
+    u64 block_count = 0;
+    u64 patch_count = 0;
+    u64 patch_data_size = 0;
+    u32 magic = compressed_magic;
+    u32 padding = 0;
+};
+
+struct StoredPatch {
+    u64 offset = 0;
+    u64 size = 0;
+};
+
+static u64 block_count(u64 size, u64 block_size) {
+    return size / block_size + (size % block_size != 0);
+}
+}
+
+
+CompressedWriter::CompressedWriter(Writer& dst, usize block_size) :
+        _dst(dst),
+        _block_size(std::clamp(block_size, min_block_size, max_block_size)),
+        _block(_block_size),
+        _compressed(max_compressed_size(_block_size)) {
+
+    detail::CompressedHeader header;
+    header.block_size = u32(_block_size);
+    _failed = _dst.write_one(header).is_error();
+}
+
+CompressedWriter::~CompressedWriter() {
+    flush().ignore();
+}
+
+void CompressedWriter::seek(usize byte) {
+    _cursor = byte;
+}
+
+usize CompressedWriter::tell() const {
+    return _cursor;
+}
+
+bool CompressedWriter::write_block(usize size) {
+    const usize written = compress_block(_block.data(), size, _compressed.data(), size);
+    if(written) {
+        _block_sizes << u32(written);
+        return _dst.write(_compressed.data(), written).is_ok();
+    }
+
+    // Didn't compress, store as is
+    _block_sizes << u32(size | detail::raw_block_bit);
+    return _dst.write(_block.data(), size).is_ok();
+}
+
+bool CompressedWriter::next_block() {
+    if(!write_block(_block_size)) {
+        return false;
+    }
+
+    _block_begin += _block_size;
+    std::fill_n(_block.data(), _block_size, u8(0));
+    return true;
+}
+
+WriteResult CompressedWriter::write(const void* data, usize bytes) {
+    if(_flushed || _failed) {
+        return core::Err<usize>(0);
+    }
+
+    const u8* src = static_cast<const u8*>(data);
+    usize done = 0;
+    while(done != bytes) {
+        if(_cursor < _block_begin) {
+            // The block has already been written, patches never cross block boundaries
+            const usize block_end = (_cursor / _block_size + 1) * _block_size;
+            const usize len = std::min(bytes - done, block_end - _cursor);
+            _patches.emplace_back(u64(_cursor), u64(len));
+            _patch_data.push_back(src + done, src + done + len);
+            done += len;
+            _cursor += len;
+            continue;
+        }
+
+        const usize in_block = _cursor - _block_begin;
+        if(in_block >= _block_size) {
+            if(!next_block()) {
+                _failed = true;
+                return core::Err(done);
+            }
+            continue;
+        }
+
+        const usize len = std::min(bytes - done, _block_size - in_block);
+        std::memcpy(_block.data() + in_block, src + done, len);
+        done += len;
+        _cursor += len;
+    }
+
+    _size = std::max(_size, _cursor);
+    return core::Ok();
+}
+
+FlushResult CompressedWriter::flush() {
+    if(_flushed) {
+        if(_failed) {
+            return core::Err();
+        }
+        return core::Ok();
+    }
+    _flushed = true;
+
+    if(_failed || (_size > _block_begin && !write_block(_size - _block_begin))) {
+        _failed = true;
+        return core::Err();
+    }
+
+    detail::CompressedTrailer trailer;
+    trailer.size = _size;
+    trailer.block_count = _block_sizes.size();
+    trailer.patch_count = _patches.size();
+    trailer.patch_data_size = _patch_data.size();
+
+    if(!_dst.write_array(_block_sizes.data(), _block_sizes.size()) ||
+       !_dst.write_array(_patches.data(), _patches.size()) ||
+       !_dst.write(_patch_data.data(), _patch_data.size()) ||
+       !_dst.write_one(trailer)) {
+        _failed = true;
+        return core::Err();
+    }
+
+    return _dst.flush();
+}
+
+
+
+
+CompressedReader::CompressedReader(CompressedReader&& other) {
+    swap(other);
+}
+
+CompressedReader& CompressedReader::operator=(CompressedReader&& other) {
+    swap(other);
+    return *this;
+}
+
+void CompressedReader::swap(CompressedReader& other) {
+    std::swap(_src, other._src);
+    std::swap(_block_offsets, other._block_offsets);
+    std::swap(_block_sizes, other._block_sizes);
+    std::swap(_patches, other._patches);
+    std::swap(_patch_data, other._patch_data);
+    std::swap(_block_size, other._block_size);
+    std::swap(_size, other._size);
+    _block.swap(other._block);
+    _compressed.swap(other._compressed);
+    std::swap(_block_index, other._block_index);
+    std::swap(_cursor, other._cursor);
+}
+
+core::Result<CompressedReader> CompressedReader::open(ReaderPtr src) {
+    if(!src) {
+        return core::Err();
+    }
+
+    // The block size is used to allocate the decompression buffers, don't trust it
+    detail::CompressedHeader header;
+    if(!src->read_one(header) || !header.block_size || header.block_size > CompressedWriter::max_block_size) {
+        return core::Err();
+    }
+
+    switch(header.magic) {
+        case detail::compressed_magic:
+            return open_with_trailer(std::move(src), header.block_size);
+
+        case detail::table_compressed_magic: {
+            detail::TableHeader table;
+            if(!src->read_one(table)) {
+                return core::Err();
+            }
+            return open_with_table(std::move(src), header.block_size, table.size, table.block_count);
+        }
+
+        default:
+            return core::Err();
+    }
+}
+
+core::Result<CompressedReader> CompressedReader::open_with_table(ReaderPtr src, usize block_size, u64 size, u64 block_count) {
+    if(detail::block_count(size, block_size) != block_count || block_count > src->remaining() / sizeof(u32)) {
+        return core::Err();
+    }
+
+    CompressedReader reader;
+    reader._block_sizes = core::Vector<u32>(usize(block_count), u32(0));
+    if(!src->read_array(reader._block_sizes.data(), reader._block_sizes.size())) {
+        return core::Err();
+    }
+
+    const u64 begin = src->tell();
+    const u64 end = begin + src->remaining();
+
+    reader._src = std::move(src);
+    reader._block_size = block_size;
+    reader._size = usize(size);
+
+    if(!reader.init_blocks(begin, end)) {
+        return core::Err();
+    }
+
+    return core::Ok(std::move(reader));
+}
+
+core::Result<CompressedReader> CompressedReader::open_with_trailer(ReaderPtr src, usize block_size) {
+    const u64 begin = src->tell();
+    const u64 end = begin + src->remaining();
+
+    detail::CompressedTrailer trailer;
+    if(end - begin < sizeof(trailer)) {
+        return core::Err();
+    }
+
+    src->seek(usize(end - sizeof(trailer)));
+    if(!src->read_one(trailer) || trailer.magic != detail::compressed_magic) {
+        return core::Err();
+    }
+
+    // Check every count against the stream size before using them
+    const u64 capacity = end - begin - sizeof(trailer);
+    if(detail::block_count(trailer.size, block_size) != trailer.block_count ||
+       trailer.block_count > capacity / sizeof(u32) ||
+       trailer.patch_count > capacity / sizeof(detail::StoredPatch) ||
+       trailer.patch_data_size > capacity) {
+        return core::Err();
+    }
+
+    const u64 footer_size = trailer.block_count * sizeof(u32) + trailer.patch_count * sizeof(detail::StoredPatch) + trailer.patch_data_size;
+    if(footer_size > capacity) {
+        return core::Err();
+    }
+
+    const u64 footer_begin = end - sizeof(trailer) - footer_size;
+    src->seek(usize(footer_begin));
+
+    CompressedReader reader;
+    reader._block_sizes = core::Vector<u32>(usize(trailer.block_count), u32(0));
+    auto patches = core::Vector<detail::StoredPatch>(usize(trailer.patch_count), detail::StoredPatch{});
+    reader._patch_data = core::Vector<u8>(usize(trailer.patch_data_size), u8(0));
+
+    if(!src->read_array(reader._block_sizes.data(), reader._block_sizes.size()) ||
+       !src->read_array(patches.data(), patches.size()) ||
+       !src->read(reader._patch_data.data(), reader._patch_data.size())) {
+        return core::Err();
+    }
+
+    usize data_offset = 0;
+    reader._patches.set_min_capacity(patches.size());
+    for(const detail::StoredPatch& patch : patches) {
+        const bool in_stream = patch.size && patch.size <= trailer.size && patch.offset <= trailer.size - patch.size;
+        if(!in_stream || patch.offset / block_size != (patch.offset + patch.size - 1) / block_size || patch.size > reader._patch_data.size() - data_offset) {
+            return core::Err();
+        }
+
+        reader._patches.emplace_back(patch.offset, usize(patch.size), data_offset);
+        data_offset += usize(patch.size);
+    }
+
+    if(data_offset != reader._patch_data.size()) {
+        return core::Err();
+    }
+
+    std::stable_sort(reader._patches.begin(), reader._patches.end(), [=](const Patch& a, const Patch& b) {
+        return a.offset / block_size < b.offset / block_size;
+    });
+
+    reader._src = std::move(src);
+    reader._block_size = block_size;
+    reader._size = usize(trailer.size);
+
+    if(!reader.init_blocks(begin, footer_begin)) {
+        return core::Err();
+    }
+
+    return core::Ok(std::move(reader));
+}
+
+bool CompressedReader::init_blocks(u64 begin, u64 end) {
+    const usize max_stored_size = max_compressed_size(_block_size);
+
+    u64 offset = begin;
+    _block_offsets.set_min_capacity(_block_sizes.size());
+    for(const u32 block_size : _block_sizes) {
+        const usize stored_size = block_size & ~detail::raw_block_bit;
+        if(stored_size > max_stored_size) {
+            return false;
+        }
+
+        _block_offsets << offset;
+        offset += stored_size;
+    }
+
+    if(offset > end) {
+        return false;
+    }
+
+    _block = core::FixedArray<u8>(_block_size);
+    return true;
+}
+
+bool CompressedReader::is_compressed(Reader& src) {
+    const usize pos = src.tell();
+    u32 magic = 0;
+    const bool compressed = src.read_one(magic).is_ok() && (magic == detail::compressed_magic || magic == detail::table_compressed_magic);
+    src.seek(pos);
+    return compressed;
+}
+
+usize CompressedReader::size() const {
+    return _size;
+}
+
+bool CompressedReader::at_end() const {
+    return _cursor >= _size;
+}
+
+usize CompressedReader::remaining() const {
+    return at_end() ? 0 : _size - _cursor;
+}
+
+void CompressedReader::seek(usize byte) {
+    _cursor = std::min(byte, _size);
+}
+
+usize CompressedReader::tell() const {
+    return _cursor;
+}
+
+usize CompressedReader::block_byte_size(usize index) const {
+    return std::min(_block_size, _size - index * _block_size);
+}
+
+bool CompressedReader::load_block(usize index) {
+    if(index == _block_index) {
+        return true;
+    }
+
+    if(index >= _block_sizes.size()) {
+        return false;
+    }
+
+    _block_index = usize(-1);
+
+    const bool raw = _block_sizes[index] & detail::raw_block_bit;
+    const usize stored_size = _block_sizes[index] & ~detail::raw_block_bit;
+    const usize size = block_byte_size(index);
+
+    _src->seek(usize(_block_offsets[index]));
+
+    const u8* stored = _src->read_view(stored_size);
+    if(!stored) {
+        if(_compressed.size() < stored_size) {
+            _compressed = core::FixedArray<u8>(std::max(stored_size, max_compressed_size(_block_size)));
+        }
+        if(!_src->read(_compressed.data(), stored_size)) {
+            return false;
+        }
+        stored = _compressed.data();
+    }
+
+    if(raw) {
+        if(stored_size != size) {
+            return false;
+        }
+        std::memcpy(_block.data(), stored, size);
+    } else if(!decompress_block(stored, stored_size, _block.data(), size)) {
+        return false;
+    }
+
+    const u64 block_begin = u64(index) * _block_size;
+    auto it = std::lower_bound(_patches.begin(), _patches.end(), index, [this](const Patch& patch, usize i) {
+        return patch.offset / _block_size < i;
+    });
+    for(; it != _patches.end() && it->offset / _block_size == index; ++it) {
+        std::memcpy(_block.data() + (it->offset - block_begin), _patch_data.data() + it->data_offset, it->size);
+    }
+
+    _block_index = index;
+    return true;
+}
+
+ReadResult CompressedReader::read(void* data, usize bytes) {
+    if(remaining() < bytes) {
+        return core::Err<usize>(0);
+    }
+
+    u8* out = static_cast<u8*>(data);
+    usize done = 0;
+    while(done < bytes) {
+        const usize index = _cursor / _block_size;
+        if(!load_block(index)) {
+            return core::Err(done);
+        }
+
+        const usize in_block = _cursor - index * _block_size;
+        const usize len = std::min(bytes - done, block_byte_size(index) - in_block);
+        std::memcpy(out + done, _block.data() + in_block, len);
+
+        done += len;
+        _cursor += len;
+    }
+
+    return core::Ok();
+}
+
+ReadUpToResult CompressedReader::read_up_to(void* data, usize max_bytes) {
+    const usize bytes = std::min(max_bytes, remaining());
+    if(auto r = read(data, bytes); r.is_error()) {
+        return core::Err(r.error());
+    }
+    return core::Ok(bytes);
+}
+
+ReadUpToResult CompressedReader::read_all(core::Vector<u8>& data) {
+    const usize bytes = remaining();
+    const usize size = data.size();
+    data.set_min_size(size + bytes);
+    return read_up_to(data.data() + size, bytes);
+}
+
+const u8* CompressedReader::read_view(usize bytes) {
+    if(!bytes || remaining() < bytes) {
+        return nullptr;
+    }
+
+    const usize index = _cursor / _block_size;
+    const usize in_block = _cursor - index * _block_size;
+    if(in_block + bytes > block_byte_size(index) || !load_block(index)) {
+        return nullptr;
+    }
+
+    _cursor += bytes;
+    return _block.data() + in_block;
+}
+
+}
+}
@@ -0,0 +1,154 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_IO2_COMPRESSED_H
+#define Y_IO2_COMPRESSED_H
+
+#include "Buffer.h"
+
+#include <y/core/FixedArray.h>
+
+namespace y {
+namespace io2 {
+
+// LZ4 block format codec.
+// compress_block returns the compressed size, or 0 if the data didn't fit in dst.
+usize compress_block(const u8* src, usize src_size, u8* dst, usize dst_capacity);
+bool decompress_block(const u8* src, usize src_size, u8* dst, usize dst_size);
+usize max_compressed_size(usize src_size);
+
+
+// Compresses everything written to it in independent blocks.
+// Blocks are compressed and written to dst as soon as they are complete, so only one block is kept in memory.
+// Writing into a block that has already been written (after seeking back) stores the data as a patch that gets applied when reading.
+class CompressedWriter final : public Writer {
+    public:
+        static constexpr usize default_block_size = 256 * 1024;
+        static constexpr usize min_block_size = 1024;
+        static constexpr usize max_block_size = 64 * 1024 * 1024;
+
+        CompressedWriter(Writer& dst, usize block_size = default_block_size);
+        ~CompressedWriter() override;
+
+        void seek(usize byte) override;
+        usize tell() const override;
+
+        FlushResult flush() override;
+        WriteResult write(const void* data, usize bytes) override;
+
+    private:
+        struct Patch {
+            u64 offset = 0;
+            u64 size = 0;
+        };
+
+        bool write_block(usize size);
+        bool next_block();
+
+        Writer& _dst;
+        usize _block_size = 0;
+
+        core::FixedArray<u8> _block;
+        core::FixedArray<u8> _compressed;
+        usize _block_begin = 0;
+
+        core::Vector<u32> _block_sizes;
+
+        core::Vector<Patch> _patches;
+        core::Vector<u8> _patch_data;
+
+        usize _cursor = 0;
+        usize _size = 0;
+
+        bool _failed = false;
+        bool _flushed = false;
+};
+
+
+// Reads data written by a CompressedWriter.
+// Blocks are decompressed on demand, seeking only decompresses the block that contains the target.
+class CompressedReader final : public Reader {
+    public:
+        CompressedReader() = default;
+
+        CompressedReader(CompressedReader&& other);
+        CompressedReader& operator=(CompressedReader&& other);
+
+        static core::Result<CompressedReader> open(ReaderPtr src);
+
+        // Checks the stream header without moving the cursor of src
+        static bool is_compressed(Reader& src);
+
+        usize size() const;
+
+        bool at_end() const override;
+        usize remaining() const override;
+
+        void seek(usize byte) override;
+        usize tell() const override;
+
+        ReadResult read(void* data, usize bytes) override;
+        ReadUpToResult read_up_to(void* data, usize max_bytes) override;
+        ReadUpToResult read_all(core::Vector<u8>& data) override;
+
+        // Views point into the current block and are only valid until the next call on the reader
+        const u8* read_view(usize bytes) override;
+
+    private:
+        struct Patch {
+            u64 offset = 0;
+            usize size = 0;
+            usize data_offset = 0;
+        };
+
+        static core::Result<CompressedReader> open_with_table(ReaderPtr src, usize block_size, u64 size, u64 block_count);
+        static core::Result<CompressedReader> open_with_trailer(ReaderPtr src, usize block_size);
+
+        // Computes block offsets from begin and checks that all blocks end before end
+        bool init_blocks(u64 begin, u64 end);
+
+        bool load_block(usize index);
+        usize block_byte_size(usize index) const;
+
+        void swap(CompressedReader& other);
+
+        ReaderPtr _src;
+
+        core::Vector<u64> _block_offsets;
+        core::Vector<u32> _block_sizes;
+
+        // Sorted by block, in write order within a block
+        core::Vector<Patch> _patches;
+        core::Vector<u8> _patch_data;
+        usize _block_size = 0;
+        usize _size = 0;
+
+        core::FixedArray<u8> _block;
+        core::FixedArray<u8> _compressed;
+        usize _block_index = usize(-1);
+
+        usize _cursor = 0;
+};
+
+}
+}
+
+#endif // Y_IO2_COMPRESSED_H
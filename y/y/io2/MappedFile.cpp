@@ -0,0 +1,217 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "MappedFile.h"
+
+#include <cstring>
+
+#ifdef Y_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace y {
+namespace io2 {
+
+static void unmap(const u8* data, usize size) {
+    if(!data) {
+        return;
+    }
+#ifdef Y_OS_WIN
+    unused(size);
+    ::UnmapViewOfFile(data);
+#else
+    ::munmap(const_cast<u8*>(data), size);
+#endif
+}
+
+
+MappedFile::MappedFile(const u8* data, usize size) : _data(data), _size(size), _is_open(true) {
+}
+
+MappedFile::~MappedFile() {
+    unmap(_data, _size);
+}
+
+MappedFile::MappedFile(MappedFile&& other) {
+    swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    swap(other);
+    return *this;
+}
+
+void MappedFile::swap(MappedFile& other) {
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+    std::swap(_cursor, other._cursor);
+    std::swap(_is_open, other._is_open);
+}
+
+core::Result<MappedFile> MappedFile::open(const core::String& name) {
+#ifdef Y_OS_WIN
+    const HANDLE file = ::CreateFileA(name.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        return core::Err();
+    }
+    y_defer(::CloseHandle(file));
+
+    LARGE_INTEGER file_size = {};
+    if(!::GetFileSizeEx(file, &file_size)) {
+        return core::Err();
+    }
+
+    const usize size = usize(file_size.QuadPart);
+    if(!size) {
+        return core::Ok(MappedFile(nullptr, 0));
+    }
+
+    // The view keeps the mapping (and the file) alive, so both handles can be closed right away
+    const HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mapping) {
+        return core::Err();
+    }
+    y_defer(::CloseHandle(mapping));
+
+    const void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!data) {
+        return core::Err();
+    }
+
+    return core::Ok(MappedFile(static_cast<const u8*>(data), size));
+#else
+    const int fd = ::open(name.data(), O_RDONLY);
+    if(fd < 0) {
+        return core::Err();
+    }
+    y_defer(::close(fd));
+
+    struct stat st = {};
+    if(::fstat(fd, &st) != 0) {
+        return core::Err();
+    }
+
+    const usize size = usize(st.st_size);
+    if(!size) {
+        return core::Ok(MappedFile(nullptr, 0));
+    }
+
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(data == MAP_FAILED) {
+        return core::Err();
+    }
+
+    ::madvise(data, size, MADV_SEQUENTIAL);
+
+    return core::Ok(MappedFile(static_cast<const u8*>(data), size));
+#endif
+}
+
+void MappedFile::prefetch() const {
+    if(!_data) {
+        return;
+    }
+#ifdef Y_OS_WIN
+    WIN32_MEMORY_RANGE_ENTRY range = {};
+    range.VirtualAddress = const_cast<u8*>(_data);
+    range.NumberOfBytes = _size;
+    ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+#else
+    ::madvise(const_cast<u8*>(_data), _size, MADV_WILLNEED);
+#endif
+}
+
+usize MappedFile::size() const {
+    return _size;
+}
+
+usize MappedFile::remaining() const {
+    y_debug_assert(_cursor <= _size);
+    return _size - _cursor;
+}
+
+const u8* MappedFile::data() const {
+    return _data;
+}
+
+bool MappedFile::is_open() const {
+    return _is_open;
+}
+
+bool MappedFile::at_end() const {
+    return _cursor == _size;
+}
+
+void MappedFile::seek(usize byte) {
+    _cursor = std::min(_size, byte);
+}
+
+usize MappedFile::tell() const {
+    return _cursor;
+}
+
+void MappedFile::reset() {
+    seek(0);
+}
+
+ReadResult MappedFile::read(void* data, usize bytes) {
+    if(remaining() < bytes) {
+        return core::Err<usize>(0);
+    }
+    std::memcpy(data, _data + _cursor, bytes);
+    _cursor += bytes;
+    return core::Ok();
+}
+
+ReadUpToResult MappedFile::read_up_to(void* data, usize max_bytes) {
+    const usize max = std::min(max_bytes, remaining());
+    if(max) {
+        std::memcpy(data, _data + _cursor, max);
+        _cursor += max;
+    }
+    return core::Ok(max);
+}
+
+ReadUpToResult MappedFile::read_all(core::Vector<u8>& data) {
+    const usize left = remaining();
+    if(left) {
+        data.push_back(_data + _cursor, _data + _size);
+        _cursor = _size;
+    }
+    return core::Ok(left);
+}
+
+const u8* MappedFile::read_view(usize bytes) {
+    if(!_data || remaining() < bytes) {
+        return nullptr;
+    }
+    const u8* view = _data + _cursor;
+    _cursor += bytes;
+    return view;
+}
+
+}
+}
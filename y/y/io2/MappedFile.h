@@ -0,0 +1,81 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_IO2_MAPPEDFILE_H
+#define Y_IO2_MAPPEDFILE_H
+
+#include "io.h"
+
+#include <y/core/String.h>
+
+namespace y {
+namespace io2 {
+
+// Read only file backed by a memory mapping.
+// read_view returns pointers directly into the mapping, which stay valid for the lifetime of the MappedFile.
+class MappedFile final : public Reader {
+
+    public:
+        MappedFile() = default;
+        ~MappedFile() override;
+
+        MappedFile(MappedFile&& other);
+        MappedFile& operator=(MappedFile&& other);
+
+        static core::Result<MappedFile> open(const core::String& name);
+
+        usize size() const;
+        usize remaining() const override;
+
+        const u8* data() const;
+
+        bool is_open() const;
+        bool at_end() const override;
+
+        void seek(usize byte) override;
+        usize tell() const override;
+
+        void reset();
+
+        ReadResult read(void* data, usize bytes) override;
+        ReadUpToResult read_up_to(void* data, usize max_bytes) override;
+        ReadUpToResult read_all(core::Vector<u8>& data) override;
+
+        const u8* read_view(usize bytes) override;
+
+        // Hints the OS to start paging in the whole file
+        void prefetch() const;
+
+    private:
+        MappedFile(const u8* data, usize size);
+
+        void swap(MappedFile& other);
+
+        const u8* _data = nullptr;
+        usize _size = 0;
+        usize _cursor = 0;
+        bool _is_open = false;
+};
+
+}
+}
+
+#endif // Y_IO2_MAPPEDFILE_H
@@ -0,0 +1,548 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "ReadQueue.h"
+
+#include <y/concurrent/concurrent.h>
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <cerrno>
+
+#ifdef Y_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#if defined(Y_OS_LINUX) && defined(__NR_io_uring_setup)
+#define Y_IO2_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+namespace y {
+namespace io2 {
+
+AsyncFile::~AsyncFile() {
+#ifdef Y_OS_WIN
+    if(_handle) {
+        ::CloseHandle(_handle);
+    }
+#else
+    if(_fd >= 0) {
+        ::close(_fd);
+    }
+#endif
+}
+
+AsyncFile::AsyncFile(AsyncFile&& other) {
+    swap(other);
+}
+
+AsyncFile& AsyncFile::operator=(AsyncFile&& other) {
+    swap(other);
+    return *this;
+}
+
+void AsyncFile::swap(AsyncFile& other) {
+#ifdef Y_OS_WIN
+    std::swap(_handle, other._handle);
+#else
+    std::swap(_fd, other._fd);
+#endif
+    std::swap(_size, other._size);
+}
+
+core::Result<AsyncFile> AsyncFile::open(const core::String& name) {
+    AsyncFile file;
+#ifdef Y_OS_WIN
+    const HANDLE handle = ::CreateFileA(name.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(handle == INVALID_HANDLE_VALUE) {
+        return core::Err();
+    }
+    file._handle = handle;
+
+    LARGE_INTEGER size = {};
+    if(!::GetFileSizeEx(handle, &size)) {
+        return core::Err();
+    }
+    file._size = usize(size.QuadPart);
+#else
+    file._fd = ::open(name.data(), O_RDONLY | O_CLOEXEC);
+    if(file._fd < 0) {
+        return core::Err();
+    }
+
+    struct stat st = {};
+    if(::fstat(file._fd, &st) != 0) {
+        return core::Err();
+    }
+    file._size = usize(st.st_size);
+#endif
+    return core::Ok(std::move(file));
+}
+
+usize AsyncFile::size() const {
+    return _size;
+}
+
+bool AsyncFile::is_open() const {
+#ifdef Y_OS_WIN
+    return _handle;
+#else
+    return _fd >= 0;
+#endif
+}
+
+
+
+
+struct ReadQueue::Request {
+#ifdef Y_OS_WIN
+    void* handle = nullptr;
+#else
+    int fd = -1;
+#endif
+    usize offset = 0;
+    usize total_size = 0;
+
+    core::SmallVector<core::MutableSpan<u8>, 4> buffers;
+#ifdef Y_IO2_IO_URING
+    core::SmallVector<iovec, 4> iovecs;
+#endif
+
+    Callback on_done;
+};
+
+
+#ifdef Y_IO2_IO_URING
+// Minimal io_uring wrapper using the raw syscalls, so we don't depend on liburing
+struct ReadQueue::Ring : NonMovable {
+    int fd = -1;
+    u32 entries = 0;
+
+    void* sq_ptr = nullptr;
+    usize sq_size = 0;
+    void* cq_ptr = nullptr;
+    usize cq_size = 0;
+
+    io_uring_sqe* sqes = nullptr;
+    usize sqes_size = 0;
+
+    u32* sq_head = nullptr;
+    u32* sq_tail = nullptr;
+    u32* sq_array = nullptr;
+    u32 sq_mask = 0;
+
+    u32* cq_head = nullptr;
+    u32* cq_tail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    u32 cq_mask = 0;
+
+    ~Ring() {
+        if(sqes) {
+            ::munmap(sqes, sqes_size);
+        }
+        if(cq_ptr && cq_ptr != sq_ptr) {
+            ::munmap(cq_ptr, cq_size);
+        }
+        if(sq_ptr) {
+            ::munmap(sq_ptr, sq_size);
+        }
+        if(fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    bool init(u32 depth) {
+        io_uring_params params = {};
+        fd = int(::syscall(__NR_io_uring_setup, depth, &params));
+        if(fd < 0) {
+            return false;
+        }
+
+        entries = params.sq_entries;
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if(single_mmap) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+
+        sq_ptr = ::mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if(sq_ptr == MAP_FAILED) {
+            sq_ptr = nullptr;
+            return false;
+        }
+
+        if(single_mmap) {
+            cq_ptr = sq_ptr;
+        } else {
+            cq_ptr = ::mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if(cq_ptr == MAP_FAILED) {
+                cq_ptr = nullptr;
+                return false;
+            }
+        }
+
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes_ptr = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if(sqes_ptr == MAP_FAILED) {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqes_ptr);
+
+        u8* sq = static_cast<u8*>(sq_ptr);
+        sq_head = reinterpret_cast<u32*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<u32*>(sq + params.sq_off.tail);
+        sq_array = reinterpret_cast<u32*>(sq + params.sq_off.array);
+        sq_mask = *reinterpret_cast<u32*>(sq + params.sq_off.ring_mask);
+
+        u8* cq = static_cast<u8*>(cq_ptr);
+        cq_head = reinterpret_cast<u32*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<u32*>(cq + params.cq_off.tail);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        cq_mask = *reinterpret_cast<u32*>(cq + params.cq_off.ring_mask);
+
+        return true;
+    }
+
+    void push(Request* request) {
+        const u32 tail = *sq_tail;
+        const u32 index = tail & sq_mask;
+
+        request->iovecs.make_empty();
+        for(core::MutableSpan<u8> buffer : request->buffers) {
+            request->iovecs.push_back(iovec{buffer.data(), buffer.size()});
+        }
+
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = request->fd;
+        sqe.addr = u64(request->iovecs.data());
+        sqe.len = u32(request->iovecs.size());
+        sqe.off = u64(request->offset);
+        sqe.user_data = u64(request);
+
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    bool submit_and_wait(u32 min_complete) {
+        const u32 to_submit = *sq_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+        for(;;) {
+            const int r = int(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0));
+            if(r >= 0) {
+                return true;
+            }
+            if(errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                return false;
+            }
+        }
+    }
+
+    // Gives back the requests that have been pushed but not consumed by the kernel yet
+    template<typename F>
+    usize take_unsubmitted(F&& on_request) {
+        const u32 head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+        const u32 tail = *sq_tail;
+        for(u32 i = head; i != tail; ++i) {
+            on_request(reinterpret_cast<Request*>(sqes[sq_array[i & sq_mask]].user_data));
+        }
+        __atomic_store_n(sq_tail, head, __ATOMIC_RELEASE);
+        return tail - head;
+    }
+
+    template<typename F>
+    usize reap(F&& on_completion) {
+        u32 head = *cq_head;
+        const u32 tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+
+        usize count = 0;
+        for(; head != tail; ++head, ++count) {
+            const io_uring_cqe& cqe = cqes[head & cq_mask];
+            on_completion(reinterpret_cast<Request*>(cqe.user_data), cqe.res);
+        }
+
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+        return count;
+    }
+};
+#else
+struct ReadQueue::Ring : NonMovable {
+    u32 entries = 0;
+
+    bool init(u32) {
+        return false;
+    }
+};
+#endif
+
+
+
+
+ReadQueue::ReadQueue(usize queue_depth, Backend backend) {
+    queue_depth = std::max(queue_depth, usize(1));
+
+    if(backend == Backend::Native) {
+        auto ring = std::make_unique<Ring>();
+        if(ring->init(u32(queue_depth))) {
+            _ring = std::move(ring);
+        }
+    }
+
+    _native = _ring != nullptr;
+
+    if(_ring) {
+        _threads.emplace_back([this] {
+            concurrent::set_thread_name("IO ring thread");
+            native_worker();
+        });
+    } else {
+        const usize thread_count = std::min(queue_depth, usize(4));
+        for(usize i = 0; i != thread_count; ++i) {
+            _threads.emplace_back([this] {
+                concurrent::set_thread_name("IO thread");
+                threaded_worker();
+            });
+        }
+    }
+}
+
+ReadQueue::~ReadQueue() {
+    wait_until_idle();
+
+    {
+        _run = false;
+        const auto lock = std::unique_lock(_lock);
+        _condition.notify_all();
+    }
+
+    for(auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void ReadQueue::read(const AsyncFile& file, usize offset, core::MutableSpan<u8> dst, Callback on_done) {
+    read_scatter(file, offset, core::Span<core::MutableSpan<u8>>(&dst, 1), std::move(on_done));
+}
+
+void ReadQueue::read_scatter(const AsyncFile& file, usize offset, core::Span<core::MutableSpan<u8>> dst, Callback on_done) {
+    if(!file.is_open()) {
+        if(on_done) {
+            on_done(core::Err<usize>(0));
+        }
+        return;
+    }
+
+    auto request = std::make_unique<Request>();
+#ifdef Y_OS_WIN
+    request->handle = file._handle;
+#else
+    request->fd = file._fd;
+#endif
+    request->offset = offset;
+    request->on_done = std::move(on_done);
+    for(const core::MutableSpan<u8> buffer : dst) {
+        request->buffers.push_back(buffer);
+        request->total_size += buffer.size();
+    }
+
+    enqueue(std::move(request));
+}
+
+void ReadQueue::wait_until_idle() {
+    auto lock = std::unique_lock(_lock);
+    _idle_condition.wait(lock, [this] { return !_pending; });
+}
+
+usize ReadQueue::pending_requests() const {
+    return _pending;
+}
+
+bool ReadQueue::is_native() const {
+    return _native;
+}
+
+void ReadQueue::enqueue(std::unique_ptr<Request> request) {
+    ++_pending;
+    {
+        const auto lock = std::unique_lock(_lock);
+        _queue.push_back(std::move(request));
+    }
+    _condition.notify_one();
+}
+
+void ReadQueue::on_completed(usize count) {
+    if(count && _pending.fetch_sub(count) == count) {
+        const auto lock = std::unique_lock(_lock);
+        _idle_condition.notify_all();
+    }
+}
+
+void ReadQueue::complete(Request& request, ReadResult result) {
+    if(request.on_done) {
+        request.on_done(std::move(result));
+    }
+}
+
+// Reads everything past the first already_read bytes, used by the threaded backend and to finish short reads
+ReadResult ReadQueue::process_blocking(Request& request, usize already_read) {
+    usize offset = request.offset;
+    usize done = 0;
+    for(core::MutableSpan<u8> buffer : request.buffers) {
+        usize read = 0;
+        if(done + buffer.size() <= already_read) {
+            read = buffer.size();
+        } else if(done < already_read) {
+            read = already_read - done;
+        }
+        offset += read;
+        done += read;
+
+        while(read < buffer.size()) {
+            u8* dst = buffer.data() + read;
+            const usize max_bytes = buffer.size() - read;
+#ifdef Y_OS_WIN
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = DWORD(offset & 0xFFFFFFFF);
+            overlapped.OffsetHigh = DWORD(u64(offset) >> 32);
+            DWORD bytes = 0;
+            if(!::ReadFile(request.handle, dst, DWORD(std::min(max_bytes, usize(0x7FFFFFFF))), &bytes, &overlapped) || !bytes) {
+                return core::Err(done);
+            }
+            const usize r = usize(bytes);
+#else
+            const ssize_t bytes = ::pread(request.fd, dst, max_bytes, off_t(offset));
+            if(bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            if(bytes <= 0) {
+                return core::Err(done);
+            }
+            const usize r = usize(bytes);
+#endif
+            read += r;
+            offset += r;
+            done += r;
+        }
+    }
+    return core::Ok();
+}
+
+void ReadQueue::threaded_worker() {
+    for(;;) {
+        std::unique_ptr<Request> request;
+        {
+            auto lock = std::unique_lock(_lock);
+            _condition.wait(lock, [this] { return !_queue.is_empty() || !_run; });
+            if(_queue.is_empty()) {
+                break;
+            }
+            request = std::move(_queue.first());
+            _queue.pop_front();
+        }
+
+        complete(*request, process_blocking(*request, 0));
+        on_completed(1);
+    }
+}
+
+void ReadQueue::native_worker() {
+#ifdef Y_IO2_IO_URING
+    Ring& ring = *_ring;
+    usize in_flight = 0;
+
+    for(;;) {
+        {
+            auto lock = std::unique_lock(_lock);
+            if(!in_flight) {
+                _condition.wait(lock, [this] { return !_queue.is_empty() || !_run; });
+                if(_queue.is_empty()) {
+                    break;
+                }
+            }
+
+            // Everything queued since the last submission goes in the same batch
+            while(!_queue.is_empty() && in_flight < ring.entries) {
+                ring.push(_queue.first().release());
+                _queue.pop_front();
+                ++in_flight;
+            }
+        }
+
+        const auto on_completion = [](Request* request_ptr, i32 res) {
+            std::unique_ptr<Request> request(request_ptr);
+            if(res < 0) {
+                complete(*request, process_blocking(*request, 0));
+            } else if(usize(res) < request->total_size) {
+                complete(*request, process_blocking(*request, usize(res)));
+            } else {
+                complete(*request, core::Ok());
+            }
+        };
+
+        if(!ring.submit_and_wait(1)) {
+            const int error = errno;
+            log_msg(fmt("io_uring_enter failed ({}), falling back to blocking reads", error), Log::Warning);
+            _native = false;
+
+            // Requests the kernel didn't take are read here, the ones already submitted will still complete
+            const usize taken = ring.take_unsubmitted([](Request* request_ptr) {
+                std::unique_ptr<Request> request(request_ptr);
+                complete(*request, process_blocking(*request, 0));
+            });
+            in_flight -= taken;
+            on_completed(taken);
+
+            while(in_flight) {
+                const usize completed = ring.reap(on_completion);
+                if(!completed) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                in_flight -= completed;
+                on_completed(completed);
+            }
+
+            threaded_worker();
+            return;
+        }
+
+        const usize completed = ring.reap(on_completion);
+
+        in_flight -= completed;
+        on_completed(completed);
+    }
+#else
+    y_fatal("Native IO backend is not supported");
+#endif
+}
+
+}
+}
@@ -0,0 +1,125 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_IO2_READQUEUE_H
+#define Y_IO2_READQUEUE_H
+
+#include "io.h"
+
+#include <y/core/String.h>
+#include <y/core/RingQueue.h>
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace y {
+namespace io2 {
+
+// File opened for positional reads through a ReadQueue
+class AsyncFile final : NonCopyable {
+    public:
+        AsyncFile() = default;
+        ~AsyncFile();
+
+        AsyncFile(AsyncFile&& other);
+        AsyncFile& operator=(AsyncFile&& other);
+
+        static core::Result<AsyncFile> open(const core::String& name);
+
+        usize size() const;
+        bool is_open() const;
+
+    private:
+        friend class ReadQueue;
+
+        void swap(AsyncFile& other);
+
+#ifdef Y_OS_WIN
+        void* _handle = nullptr;
+#else
+        int _fd = -1;
+#endif
+        usize _size = 0;
+};
+
+
+// Batches reads and performs them off the calling thread.
+// Uses io_uring when available (Linux), a small pool of blocking reader threads otherwise.
+// If io_uring stops working, the ring thread finishes what was submitted and continues with blocking reads.
+// Callbacks are called from the queue's threads and delay every other read, they should only hand the data off.
+class ReadQueue : NonMovable {
+    public:
+        using Callback = std::function<void(ReadResult)>;
+
+        enum class Backend {
+            Native,
+            Threaded,
+        };
+
+        ReadQueue(usize queue_depth = 64, Backend backend = Backend::Native);
+        ~ReadQueue();
+
+        // Reads dst.size() bytes starting at offset.
+        // Both the file and the destination must stay alive until on_done has been called.
+        void read(const AsyncFile& file, usize offset, core::MutableSpan<u8> dst, Callback on_done);
+
+        // Reads consecutive bytes starting at offset, filling each buffer of dst in order.
+        void read_scatter(const AsyncFile& file, usize offset, core::Span<core::MutableSpan<u8>> dst, Callback on_done);
+
+        void wait_until_idle();
+
+        usize pending_requests() const;
+        bool is_native() const;
+
+    private:
+        struct Request;
+        struct Ring;
+
+        void native_worker();
+        void threaded_worker();
+
+        static ReadResult process_blocking(Request& request, usize already_read);
+        static void complete(Request& request, ReadResult result);
+
+        void enqueue(std::unique_ptr<Request> request);
+        void on_completed(usize count);
+
+        core::RingQueue<std::unique_ptr<Request>> _queue;
+
+        mutable std::mutex _lock;
+        std::condition_variable _condition;
+        std::condition_variable _idle_condition;
+
+        std::unique_ptr<Ring> _ring;
+        core::Vector<std::thread> _threads;
+
+        std::atomic<usize> _pending = 0;
+        std::atomic<bool> _run = true;
+        std::atomic<bool> _native = false;
+};
+
+}
+}
+
+#endif // Y_IO2_READQUEUE_H
@@ -31,6 +31,7 @@ namespace y {
 namespace io2 {
 
 class File;
+class MappedFile;
 class Buffer;
 
 using ReadUpToResult = core::Result<usize, usize>;
@@ -53,6 +54,13 @@ class Reader : NonCopyable {
         virtual void seek(usize byte) = 0;
         virtual usize tell() const = 0;
 
+        // Returns a pointer to the next "bytes" bytes and moves the cursor past them.
+        // Returns null (without moving the cursor) if the data can not be accessed in place.
+        virtual const u8* read_view(usize bytes) {
+            unused(bytes);
+            return nullptr;
+        }
+
         template<typename T>
         ReadResult read_one(T& t) {
             static_assert(std::is_trivially_copyable_v<T>);
@@ -32,6 +32,9 @@ SOFTWARE.
 
 #include <y/io2/io.h>
 
+#include <array>
+#include <bit>
+
 #define Y_SERDE3_BUFFER
 
 //#define Y_NO_ARCHIVES
@@ -76,6 +79,139 @@ static constexpr u16 compiler_id = 0x00;
 
 static constexpr u16 magic = 0x7966;
 static constexpr u16 version_id = 2 | (compiler_id << 12);
+
+
+
+// Reflected objects made only of PODs and other such objects have a serialized form of fixed size and layout.
+// Their members can be read in one go: all headers and sizes are checked at once against a compile time image
+// of the schema, and values are copied from known offsets.
+static constexpr usize max_static_layout_size = 4 * 1024;
+
+template<typename T, typename M>
+M member_type_helper(NamedMember<T, M>);
+
+template<typename T, usize I>
+using member_type_t = std::remove_cvref_t<decltype(member_type_helper(std::get<I>(list_members<T>())))>;
+
+template<typename T>
+consteval usize static_layout_size();
+
+template<typename T, usize I = 0>
+consteval usize static_members_size() {
+    if constexpr(I < member_count<T>()) {
+        const usize member_size = static_layout_size<member_type_t<T, I>>();
+        const usize next_size = static_members_size<T, I + 1>();
+        if(!member_size || next_size == usize(-1)) {
+            return usize(-1);
+        }
+        return sizeof(size_type) + member_size + next_size;
+    }
+    return 0;
+}
+
+// Returns 0 if T doesn't have a static layout
+template<typename T>
+consteval usize static_layout_size() {
+    if constexpr(is_property_v<T>) {
+        return 0;
+    } else if constexpr(has_serde3_v<T>) {
+        const usize members_size = static_members_size<T>();
+        return members_size == usize(-1) ? 0 : sizeof(ObjectHeader) + members_size;
+    } else if constexpr(has_serde3_ptr_poly_v<T> || has_serde3_poly_v<T> || is_tuple_v<T> || is_range_v<T>) {
+        return 0;
+    } else if constexpr(is_pod_v<T> && !std::is_pointer_v<T>) {
+        return sizeof(TrivialHeader) + sizeof(T);
+    }
+    return 0;
+}
+
+template<typename T>
+static constexpr bool use_static_layout =
+    has_serde3_v<T> &&
+    member_count<T>() != 0 &&
+    static_layout_size<T>() != 0 &&
+    static_layout_size<T>() <= max_static_layout_size;
+
+template<usize N>
+struct StaticSchema {
+    std::array<u8, N> bytes = {};
+    std::array<u8, N> mask = {};
+
+    template<typename V>
+    constexpr void write(usize offset, const V& value) {
+        const auto raw = std::bit_cast<std::array<u8, sizeof(V)>>(value);
+        for(usize i = 0; i != sizeof(V); ++i) {
+            bytes[offset + i] = raw[i];
+            mask[offset + i] = 0xFF;
+        }
+    }
+
+    inline bool matches(const u8* data) const {
+        u8 diff = 0;
+        for(usize i = 0; i != N; ++i) {
+            diff |= (data[i] ^ bytes[i]) & mask[i];
+        }
+        return !diff;
+    }
+};
+
+template<typename T, usize I = 0, usize N>
+constexpr void build_static_schema(StaticSchema<N>& schema, usize offset) {
+    if constexpr(I < member_count<T>()) {
+        using member_type = member_type_t<T, I>;
+        constexpr auto member = std::get<I>(list_members<T>());
+        constexpr usize member_size = static_layout_size<member_type>();
+
+        schema.write(offset, size_type(member_size));
+        offset += sizeof(size_type);
+
+        if constexpr(has_serde3_v<member_type>) {
+            schema.write(offset, ObjectHeader{build_type_header(member), build_members_header<member_type>()});
+            build_static_schema<member_type>(schema, offset + sizeof(ObjectHeader));
+        } else {
+            schema.write(offset, TrivialHeader{build_type_header(member)});
+        }
+
+        build_static_schema<T, I + 1>(schema, offset + member_size);
+    }
+}
+
+// Describes the members of T, the object header is not included
+template<typename T>
+struct StaticLayout {
+    static constexpr usize size = static_layout_size<T>() - sizeof(ObjectHeader);
+
+    static constexpr StaticSchema<size> schema = [] {
+        StaticSchema<size> s;
+        build_static_schema<T>(s, 0);
+        return s;
+    }();
+};
+
+template<typename T, usize I = 0>
+inline void read_static_members(T& object, const u8* data) {
+    unused(object, data);
+    if constexpr(I < member_count<T>()) {
+        using member_type = member_type_t<T, I>;
+        constexpr auto member = std::get<I>(list_members<T>());
+        member_type& value = member.get(object);
+
+        const u8* member_data = data + sizeof(size_type);
+        if constexpr(has_serde3_v<member_type>) {
+            read_static_members(value, member_data + sizeof(ObjectHeader));
+            if constexpr(has_serde3_post_deser_v<member_type>) {
+                value.post_deserialize();
+            }
+            if constexpr(has_serde3_post_deser_poly_v<member_type>) {
+                value.post_deserialize_poly();
+            }
+        } else {
+            std::memcpy(static_cast<void*>(&value), member_data + sizeof(TrivialHeader), sizeof(member_type));
+        }
+
+        read_static_members<T, I + 1>(object, member_data + static_layout_size<member_type>());
+    }
+}
 }
 
 
@@ -523,6 +659,19 @@ class ReadableArchive final {
             _storage = std::move(file);
         }
 
+        DeserializationFlags flags() const {
+            return _flags;
+        }
+
+        // Position in the file, lets callers try a format and go back if it doesn't match
+        usize tell() const {
+            return _file.tell();
+        }
+
+        void seek(usize offset) {
+            _file.seek(offset);
+        }
+
         template<typename T>
         inline Result deserialize(T& t) {
 #ifdef Y_NO_ARCHIVES
@@ -659,19 +808,7 @@ class ReadableArchive final {
                 if constexpr(detail::use_collection_fast_path<T>) {
                     if(collection_size) {
                         y_try_status(check_header(y_create_named_object(*object.object.begin(), detail::collection_version_string)));
-                        if constexpr(!IsRange) {
-                            if constexpr(has_resize_v<T>) {
-                                object.object.resize(collection_size);
-                            } else {
-                                if constexpr(has_reserve_v<T>) {
-                                    object.object.reserve(collection_size);
-                                }
-                                while(object.object.size() < collection_size) {
-                                    object.object.emplace_back();
-                                }
-                            }
-                        }
-                        if(!_file.read_array(object.object.begin(), collection_size)) {
+                        if(!read_collection_data<IsRange>(object.object, usize(collection_size))) {
                             return core::Err(Error(ErrorType::IOError, object.name.data()));
                         }
                     }
@@ -720,6 +857,51 @@ class ReadableArchive final {
             }
         }
 
+        template<bool IsRange, typename T>
+        inline bool read_collection_data(T& collection, usize size) {
+            using value_type = std::remove_cvref_t<decltype(*collection.begin())>;
+
+            if(size > usize(-1) / sizeof(value_type)) {
+                return false;
+            }
+
+            // Readers that expose their data in place (like io2::MappedFile) let us copy straight from the source,
+            // without going through the reader and (when possible) without value-initializing the collection first
+            if(const u8* view = _file.read_view(sizeof(value_type) * size)) {
+                if constexpr(!IsRange && !has_resize_v<T> && detail::has_push_back_range_v<T, const value_type*>) {
+                    if(reinterpret_cast<uintptr_t>(view) % alignof(value_type) == 0) {
+                        const value_type* values = reinterpret_cast<const value_type*>(view);
+                        collection.push_back(values, values + size);
+                        return true;
+                    }
+                }
+
+                resize_collection<IsRange>(collection, size);
+                std::memcpy(static_cast<void*>(collection.begin()), view, sizeof(value_type) * size);
+                return true;
+            }
+
+            resize_collection<IsRange>(collection, size);
+            return _file.read_array(collection.begin(), size).is_ok();
+        }
+
+        template<bool IsRange, typename T>
+        inline void resize_collection(T& collection, usize size) {
+            unused(collection, size);
+            if constexpr(!IsRange) {
+                if constexpr(has_resize_v<T>) {
+                    collection.resize(size);
+                } else {
+                    if constexpr(has_reserve_v<T>) {
+                        collection.reserve(size);
+                    }
+                    while(collection.size() < size) {
+                        collection.emplace_back();
+                    }
+                }
+            }
+        }
+
         // ------------------------------- POLY -------------------------------
         template<typename T>
         inline Result deserialize_poly(NamedObject<T> object) {
@@ -820,10 +1002,42 @@ class ReadableArchive final {
 #endif
                 return core::Err(Error(ErrorType::SignatureError, object.name.data()));
             } else {
+                if constexpr(detail::use_static_layout<T> && !force_safe) {
+                    return deserialize_static_members(object.object, header);
+                }
                 return deserialize_members<force_safe>(object.object, header);
             }
         }
 
+        template<typename T>
+        inline Result deserialize_static_members(T& object, const detail::ObjectHeader& header) {
+            using layout = detail::StaticLayout<T>;
+            const void* schema_id = &layout::schema;
+
+            // The schema is the same for every instance of T in the archive, so we only need to fail once
+            if(std::find(_mismatched_schemas.begin(), _mismatched_schemas.end(), schema_id) == _mismatched_schemas.end()) {
+                const usize begin = tell();
+
+                std::array<u8, layout::size> buffer;
+                const u8* data = _file.read_view(layout::size);
+                if(!data && _file.read(buffer.data(), buffer.size())) {
+                    data = buffer.data();
+                }
+
+                if(data) {
+                    if(layout::schema.matches(data)) {
+                        detail::read_static_members(object, data);
+                        return core::Ok(Success::Full);
+                    }
+                    _mismatched_schemas << schema_id;
+                }
+
+                seek(begin);
+            }
+
+            return deserialize_members<force_safe>(object, header);
+        }
+
         template<bool Safe, typename T>
         inline Result deserialize_members(T& object, const detail::ObjectHeader& header) {
             ObjectData data;
@@ -974,19 +1188,14 @@ class ReadableArchive final {
             return core::Ok(Success::Full);
         }
 
-        usize tell() const {
-            return _file.tell();
-        }
-
-        void seek(usize offset) {
-            _file.seek(offset);
-        }
 #endif
 
     private:
         File& _file;
         std::unique_ptr<File> _storage;
         DeserializationFlags _flags = DeserializationFlags::None;
+
+        core::Vector<const void*> _mismatched_schemas;
 };
 
 
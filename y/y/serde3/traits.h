@@ -100,6 +100,12 @@ constexpr bool use_collection_fast_path =
         !has_serde3_v<value_type> &&
         !std::is_pointer_v<value_type>;
 
+template<typename T, typename It>
+using has_push_back_range_t = decltype(std::declval<T&>().push_back(std::declval<It>(), std::declval<It>()));
+
+template<typename T, typename It>
+static constexpr bool has_push_back_range_v = is_detected_v<has_push_back_range_t, T, It>;
+
 template<typename T>
 static constexpr bool is_pod_base_v = std::is_trivially_copyable_v<std::remove_cvref_t<T>> && std::is_trivially_copy_constructible_v<std::remove_cvref_t<T>>;
 
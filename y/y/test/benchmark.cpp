@@ -0,0 +1,182 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "benchmark.h"
+
+#include <y/io2/File.h>
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace y {
+namespace test {
+namespace detail {
+
+static BenchmarkItem* first_benchmark = nullptr;
+
+void register_benchmark(BenchmarkItem* bench) {
+    bench->next = first_benchmark;
+    first_benchmark = bench;
+}
+
+}
+
+
+static double median(core::MutableSpan<double> values) {
+    y_debug_assert(!values.is_empty());
+    std::sort(values.begin(), values.end());
+    const usize half = values.size() / 2;
+    return values.size() % 2 ? values[half] : (values[half - 1] + values[half]) * 0.5;
+}
+
+static const char* format_time(double ns) {
+    if(ns < 1'000.0) {
+        return fmt_c_str("{:.2f}ns", ns);
+    }
+    if(ns < 1'000'000.0) {
+        return fmt_c_str("{:.2f}us", ns / 1'000.0);
+    }
+    return fmt_c_str("{:.2f}ms", ns / 1'000'000.0);
+}
+
+
+Benchmark::Benchmark(const char* group, const BenchmarkSettings& settings) : _group(group), _settings(settings) {
+    _settings.samples = std::max(_settings.samples, usize(1));
+}
+
+core::Vector<BenchmarkResult>&& Benchmark::results() && {
+    return std::move(_results);
+}
+
+void Benchmark::add_result(std::string_view name, u64 iterations, core::MutableSpan<double> samples) {
+    BenchmarkResult& result = _results.emplace_back();
+    result.name = fmt_to_owned("{}/{}", _group, name);
+    result.iterations = iterations;
+
+    double total = 0.0;
+    for(const double s : samples) {
+        total += s;
+    }
+    result.mean_ns = total / double(samples.size());
+    result.median_ns = median(samples);
+    result.min_ns = samples[0];
+
+    for(double& s : samples) {
+        s = std::abs(s - result.median_ns);
+    }
+    result.mad_ns = median(samples);
+
+    const double relative_mad = result.median_ns > 0.0 ? result.mad_ns / result.median_ns * 100.0 : 0.0;
+    std::cout << fmt("{:<56} {:>12} +-{:5.1f}%  min {:>12}  ({} x {})",
+        result.name, format_time(result.median_ns), relative_mad, format_time(result.min_ns), samples.size(), iterations) << std::endl;
+}
+
+
+
+core::Vector<BenchmarkResult> run_benchmarks(const BenchmarkSettings& settings) {
+    core::Vector<BenchmarkResult> results;
+    for(detail::BenchmarkItem* bench = detail::first_benchmark; bench; bench = bench->next) {
+        if(std::string_view(bench->name).find(settings.filter) == std::string_view::npos) {
+            continue;
+        }
+
+        Benchmark benchmark(bench->name, settings);
+        (bench->bench_func)(benchmark);
+        for(BenchmarkResult& result : std::move(benchmark).results()) {
+            results.emplace_back(std::move(result));
+        }
+    }
+    return results;
+}
+
+core::Result<void> save_results(const core::String& file_name, core::Span<BenchmarkResult> results) {
+    core::String text;
+    for(const BenchmarkResult& result : results) {
+        fmt_into(text, "{}\t{}\t{}\t{}\n", result.name, result.median_ns, result.mad_ns, result.iterations);
+    }
+
+    auto file = io2::File::create(file_name);
+    y_try_discard(file);
+    y_try_discard(file.unwrap().write_array(text.data(), text.size()));
+    y_try_discard(file.unwrap().flush());
+    return core::Ok();
+}
+
+core::Result<core::Vector<BenchmarkResult>> load_results(const core::String& file_name) {
+    auto text = io2::File::read_text_file(file_name);
+    y_try_discard(text);
+
+    core::Vector<BenchmarkResult> results;
+    std::string_view lines = text.unwrap();
+    while(!lines.empty()) {
+        const usize end = std::min(lines.find('\n'), lines.size());
+        const std::string_view line = lines.substr(0, end);
+        lines.remove_prefix(std::min(end + 1, lines.size()));
+
+        const usize tab = line.find('\t');
+        if(tab == std::string_view::npos) {
+            continue;
+        }
+
+        BenchmarkResult result;
+        result.name = line.substr(0, tab);
+        unsigned long long iterations = 0;
+        const core::String values = line.substr(tab + 1);
+        if(std::sscanf(values.data(), "%lf %lf %llu", &result.median_ns, &result.mad_ns, &iterations) != 3) {
+            return core::Err();
+        }
+        result.iterations = u64(iterations);
+        results.emplace_back(std::move(result));
+    }
+
+    return core::Ok(std::move(results));
+}
+
+usize compare_results(core::Span<BenchmarkResult> results, core::Span<BenchmarkResult> baseline, double threshold) {
+    usize regressions = 0;
+    for(const BenchmarkResult& result : results) {
+        const auto it = std::find_if(baseline.begin(), baseline.end(), [&](const BenchmarkResult& b) { return b.name == result.name; });
+        if(it == baseline.end() || it->median_ns <= 0.0) {
+            continue;
+        }
+
+        const double ratio = result.median_ns / it->median_ns;
+        const double noise = result.mad_ns + it->mad_ns;
+        const double delta = result.median_ns - it->median_ns;
+
+        if(ratio > 1.0 + threshold && delta > noise) {
+            ++regressions;
+            log_msg(fmt("{}: {} -> {} ({:+.1f}%)", result.name, format_time(it->median_ns), format_time(result.median_ns), (ratio - 1.0) * 100.0), Log::Error);
+        } else if(ratio < 1.0 - threshold && -delta > noise) {
+            log_msg(fmt("{}: {} -> {} ({:+.1f}%)", result.name, format_time(it->median_ns), format_time(result.median_ns), (ratio - 1.0) * 100.0), Log::Perf);
+        }
+    }
+    return regressions;
+}
+
+}
+}
+
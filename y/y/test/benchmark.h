@@ -0,0 +1,173 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_TEST_BENCHMARK_H
+#define Y_TEST_BENCHMARK_H
+
+#include <y/core/Chrono.h>
+#include <y/core/String.h>
+#include <y/core/Vector.h>
+#include <y/core/Result.h>
+
+namespace y {
+namespace test {
+
+struct BenchmarkSettings {
+    usize samples = 25;
+    usize warmup_samples = 3;
+
+    // Iterations per sample are doubled until a sample takes at least this long
+    double min_sample_ms = 2.0;
+
+    // Only benchmark groups whose name contains filter are run
+    std::string_view filter;
+};
+
+// All times are per iteration
+struct BenchmarkResult {
+    core::String name;
+    u64 iterations = 0;
+    double median_ns = 0.0;
+    double mad_ns = 0.0;
+    double min_ns = 0.0;
+    double mean_ns = 0.0;
+};
+
+class Benchmark : NonMovable {
+    public:
+        Benchmark(const char* group, const BenchmarkSettings& settings);
+
+        // Times repeated calls to func, every call is one iteration
+        template<typename F>
+        void run(std::string_view name, F&& func) {
+            measure(name, [&](u64 iterations) {
+                const core::Chrono timer;
+                for(u64 i = 0; i != iterations; ++i) {
+                    func();
+                }
+                return timer.elapsed().to_nanos();
+            });
+        }
+
+        // Same as run, but calls setup before every iteration. Only func is timed.
+        template<typename S, typename F>
+        void run_with_setup(std::string_view name, S&& setup, F&& func) {
+            measure(name, [&](u64 iterations) {
+                u64 total_ns = 0;
+                for(u64 i = 0; i != iterations; ++i) {
+                    setup();
+                    const core::Chrono timer;
+                    func();
+                    total_ns += timer.elapsed().to_nanos();
+                }
+                return total_ns;
+            });
+        }
+
+        core::Vector<BenchmarkResult>&& results() &&;
+
+    private:
+        template<typename F>
+        void measure(std::string_view name, F&& timed_loop) {
+            const u64 min_sample_ns = u64(_settings.min_sample_ms * 1'000'000.0);
+
+            u64 iterations = 1;
+            while(timed_loop(iterations) < min_sample_ns && iterations < max_iterations) {
+                iterations *= 2;
+            }
+
+            for(usize i = 0; i != _settings.warmup_samples; ++i) {
+                timed_loop(iterations);
+            }
+
+            core::Vector<double> samples = core::Vector<double>::with_capacity(_settings.samples);
+            for(usize i = 0; i != _settings.samples; ++i) {
+                samples << double(timed_loop(iterations)) / double(iterations);
+            }
+
+            add_result(name, iterations, samples);
+        }
+
+        void add_result(std::string_view name, u64 iterations, core::MutableSpan<double> samples);
+
+        static constexpr u64 max_iterations = u64(1) << 32;
+
+        const char* _group = nullptr;
+        BenchmarkSettings _settings;
+        core::Vector<BenchmarkResult> _results;
+};
+
+
+// Keeps the compiler from optimizing away the computation of value
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#ifdef Y_MSVC
+    static const void* volatile sink = nullptr;
+    sink = &value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+
+namespace detail {
+struct BenchmarkItem {
+    const char* name = "Unknown benchmark";
+    void (*bench_func)(Benchmark&) = nullptr;
+    BenchmarkItem* next = nullptr;
+};
+
+void register_benchmark(BenchmarkItem* bench);
+}
+
+core::Vector<BenchmarkResult> run_benchmarks(const BenchmarkSettings& settings = BenchmarkSettings());
+
+core::Result<void> save_results(const core::String& file_name, core::Span<BenchmarkResult> results);
+core::Result<core::Vector<BenchmarkResult>> load_results(const core::String& file_name);
+
+// A benchmark regressed if its median is more than threshold (relative) slower than in the baseline
+// and if the difference exceeds the combined noise (MAD) of both runs. Returns the number of regressions.
+usize compare_results(core::Span<BenchmarkResult> results, core::Span<BenchmarkResult> baseline, double threshold);
+
+}
+}
+
+
+#define Y_BENCH_FUNC y_create_name_with_prefix(bench_func)
+#define Y_BENCH_RUNNER y_create_name_with_prefix(bench_runner)
+
+// Declares a benchmark group, the body receives a y::test::Benchmark& named bench
+#define y_bench_func(name)                                                                              \
+static void Y_BENCH_FUNC(y::test::Benchmark&);                                                          \
+namespace {                                                                                             \
+    class Y_BENCH_RUNNER {                                                                              \
+        Y_BENCH_RUNNER() : bench_item({name, &Y_BENCH_FUNC, nullptr}) {                                 \
+            y::test::detail::register_benchmark(&bench_item);                                           \
+        }                                                                                               \
+        y::test::detail::BenchmarkItem bench_item;                                                      \
+        static Y_BENCH_RUNNER runner;                                                                   \
+    };                                                                                                  \
+    Y_BENCH_RUNNER Y_BENCH_RUNNER::runner = Y_BENCH_RUNNER();                                           \
+}                                                                                                       \
+void Y_BENCH_FUNC([[maybe_unused]] y::test::Benchmark& bench)
+
+#endif // Y_TEST_BENCHMARK_H
+
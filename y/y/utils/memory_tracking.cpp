@@ -0,0 +1,372 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "memory_tracking.h"
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <cstdlib>
+
+#if defined(Y_OS_WIN)
+#include <windows.h>
+#elif __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define Y_HAS_EXECINFO
+#endif
+
+namespace y {
+
+static constexpr usize tag_count = usize(MemoryTag::Max);
+
+static constinit thread_local MemoryTag thread_tag = MemoryTag::Untagged;
+
+std::string_view memory_tag_name(MemoryTag tag) {
+    switch(tag) {
+        case MemoryTag::Untagged:
+            return "Untagged";
+        case MemoryTag::Assets:
+            return "Assets";
+        case MemoryTag::Ecs:
+            return "ECS";
+        case MemoryTag::FrameGraph:
+            return "FrameGraph";
+        case MemoryTag::Scripting:
+            return "Scripting";
+        case MemoryTag::Editor:
+            return "Editor";
+
+        default:
+            return "Unknown";
+    }
+}
+
+MemoryTagScope::MemoryTagScope(MemoryTag tag) : _previous(thread_tag) {
+    y_debug_assert(tag < MemoryTag::Max);
+    thread_tag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope() {
+    thread_tag = _previous;
+}
+
+
+namespace memory_tracking {
+
+static constexpr usize max_stack_samples = 256;
+
+// Stored right before every tracked allocation, so that frees can be attributed to the tag of the allocation
+struct alignas(16) AllocHeader {
+    usize size = 0;
+    u32 offset = 0;
+    MemoryTag tag = MemoryTag::Untagged;
+};
+
+struct TagState {
+    std::atomic<i64> live_bytes = 0;
+    std::atomic<i64> peak_bytes = 0;
+    std::atomic<u64> budget = 0;
+    std::atomic<BudgetAction> budget_action = BudgetAction::Log;
+    std::atomic<bool> over_budget = false;
+};
+
+// Only ever written by their owning thread, and never freed so they can be read after the thread exits
+struct ThreadCounters {
+    std::array<std::atomic<i64>, tag_count> unflushed_bytes = {};
+    std::array<std::atomic<i64>, tag_count> live_allocations = {};
+    std::array<std::atomic<u64>, tag_count> total_allocations = {};
+    ThreadCounters* next = nullptr;
+};
+
+static constinit std::array<TagState, tag_count> tag_states = {};
+static constinit std::atomic<ThreadCounters*> all_thread_counters = nullptr;
+
+static constinit thread_local ThreadCounters* thread_counters = nullptr;
+static constinit thread_local bool in_tracking = false;
+static constinit thread_local u32 sample_countdown = 0;
+
+static constinit std::atomic<u32> sampling_rate = 0;
+static constinit std::mutex samples_lock;
+static constinit std::array<StackSample, max_stack_samples> samples = {};
+static constinit usize sample_count = 0;
+
+
+template<typename T>
+static void local_add(std::atomic<T>& counter, T value) {
+    // Only the owning thread writes to its counters, no need for a RMW
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static ThreadCounters& local_counters() {
+    if(!thread_counters) {
+        // Can't use operator new here since it is probably what is calling us
+        void* memory = std::malloc(sizeof(ThreadCounters));
+        y_always_assert(memory, "Unable to allocate memory tracking counters");
+
+        ThreadCounters* counters = ::new(memory) ThreadCounters();
+        counters->next = all_thread_counters.load(std::memory_order_relaxed);
+        while(!all_thread_counters.compare_exchange_weak(counters->next, counters, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        thread_counters = counters;
+    }
+    return *thread_counters;
+}
+
+static void flush(ThreadCounters& counters, usize index) {
+    TagState& state = tag_states[index];
+
+    const i64 delta = counters.unflushed_bytes[index].load(std::memory_order_relaxed);
+    const i64 live = state.live_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    counters.unflushed_bytes[index].store(0, std::memory_order_relaxed);
+
+    i64 peak = state.peak_bytes.load(std::memory_order_relaxed);
+    while(live > peak && !state.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+
+    if(live < i64(state.budget.load(std::memory_order_relaxed))) {
+        state.over_budget.store(false, std::memory_order_relaxed);
+    }
+}
+
+static bool check_budget(const ThreadCounters& counters, usize index, usize size) {
+    TagState& state = tag_states[index];
+
+    const u64 budget = state.budget.load(std::memory_order_relaxed);
+    if(!budget) {
+        return true;
+    }
+
+    const i64 projected = state.live_bytes.load(std::memory_order_relaxed) + counters.unflushed_bytes[index].load(std::memory_order_relaxed) + i64(size);
+    if(projected <= i64(budget)) {
+        return true;
+    }
+
+    if(state.budget_action.load(std::memory_order_relaxed) == BudgetAction::Fail) {
+        return false;
+    }
+
+    if(!in_tracking && !state.over_budget.exchange(true, std::memory_order_relaxed)) {
+        in_tracking = true;
+        log_msg(fmt("{} is over its memory budget: {} KB used out of {} KB", memory_tag_name(MemoryTag(index)), projected / 1024, budget / 1024), Log::Warning);
+        in_tracking = false;
+    }
+
+    return true;
+}
+
+static u32 capture_stack(void** frames, u32 max_frames) {
+#if defined(Y_OS_WIN)
+    return u32(::RtlCaptureStackBackTrace(0, DWORD(max_frames), frames, nullptr));
+#elif defined(Y_HAS_EXECINFO)
+    return u32(std::max(0, ::backtrace(frames, int(max_frames))));
+#else
+    unused(frames, max_frames);
+    return 0;
+#endif
+}
+
+static void sample_stack(usize size, MemoryTag tag) {
+    const u32 rate = sampling_rate.load(std::memory_order_relaxed);
+    if(!rate || in_tracking) {
+        return;
+    }
+
+    if(sample_countdown > 1) {
+        --sample_countdown;
+        return;
+    }
+    sample_countdown = rate;
+
+    in_tracking = true;
+
+    StackSample sample;
+    sample.tag = tag;
+    sample.size = size;
+    sample.frame_count = capture_stack(sample.frames.data(), u32(sample.frames.size()));
+
+    {
+        const auto lock = std::unique_lock(samples_lock);
+        samples[sample_count++ % max_stack_samples] = sample;
+    }
+
+    in_tracking = false;
+}
+
+
+
+MemoryTag current_tag() {
+    return thread_tag;
+}
+
+bool on_alloc(usize size, MemoryTag tag) {
+    const usize index = usize(tag);
+    y_debug_assert(index < tag_count);
+
+    ThreadCounters& counters = local_counters();
+    if(!check_budget(counters, index, size)) {
+        return false;
+    }
+
+    local_add(counters.total_allocations[index], u64(1));
+    local_add(counters.live_allocations[index], i64(1));
+    local_add(counters.unflushed_bytes[index], i64(size));
+
+    if(counters.unflushed_bytes[index].load(std::memory_order_relaxed) >= i64(flush_threshold)) {
+        flush(counters, index);
+    }
+
+    sample_stack(size, tag);
+
+    return true;
+}
+
+void on_free(usize size, MemoryTag tag) {
+    const usize index = usize(tag);
+    y_debug_assert(index < tag_count);
+
+    ThreadCounters& counters = local_counters();
+
+    local_add(counters.live_allocations[index], i64(-1));
+    local_add(counters.unflushed_bytes[index], -i64(size));
+
+    if(counters.unflushed_bytes[index].load(std::memory_order_relaxed) <= -i64(flush_threshold)) {
+        flush(counters, index);
+    }
+}
+
+TagStats tag_stats(MemoryTag tag) {
+    const usize index = usize(tag);
+    y_debug_assert(index < tag_count);
+
+    const TagState& state = tag_states[index];
+
+    i64 live_bytes = state.live_bytes.load(std::memory_order_relaxed);
+    i64 live_allocations = 0;
+    u64 total_allocations = 0;
+    for(const ThreadCounters* counters = all_thread_counters.load(std::memory_order_acquire); counters; counters = counters->next) {
+        live_bytes += counters->unflushed_bytes[index].load(std::memory_order_relaxed);
+        live_allocations += counters->live_allocations[index].load(std::memory_order_relaxed);
+        total_allocations += counters->total_allocations[index].load(std::memory_order_relaxed);
+    }
+
+    TagStats stats;
+    stats.live_bytes = u64(std::max(i64(0), live_bytes));
+    stats.peak_bytes = std::max(stats.live_bytes, u64(std::max(i64(0), state.peak_bytes.load(std::memory_order_relaxed))));
+    stats.live_allocations = u64(std::max(i64(0), live_allocations));
+    stats.total_allocations = total_allocations;
+    stats.budget = state.budget.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void* tracked_alloc(usize size, usize alignment) {
+    const MemoryTag tag = thread_tag;
+    if(!on_alloc(size, tag)) {
+        throw std::bad_alloc{};
+    }
+
+    const usize header_size = align_up_to(sizeof(AllocHeader), alignment);
+    const usize base_alignment = std::max(alignment, alignof(AllocHeader));
+
+    auto try_alloc = [=] {
+        #ifdef Y_MSVC
+            return _aligned_malloc(header_size + size, base_alignment);
+        #else
+            return std::aligned_alloc(base_alignment, header_size + size);
+        #endif
+    };
+
+    void* base = nullptr;
+    while((base = try_alloc()) == nullptr) {
+        std::new_handler nh = std::get_new_handler();
+        if(!nh) {
+            on_free(size, tag);
+            throw std::bad_alloc{};
+        }
+        nh();
+    }
+
+    void* ptr = static_cast<u8*>(base) + header_size;
+    AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+    header->size = size;
+    header->offset = u32(header_size);
+    header->tag = tag;
+
+    return ptr;
+}
+
+void tracked_free(void* ptr) {
+    if(!ptr) {
+        return;
+    }
+
+    const AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+    on_free(header->size, header->tag);
+
+    void* base = static_cast<u8*>(ptr) - header->offset;
+
+#ifdef Y_MSVC
+    _aligned_free(base);
+#else
+    std::free(base);
+#endif
+}
+
+void set_budget(MemoryTag tag, u64 bytes, BudgetAction action) {
+    const usize index = usize(tag);
+    y_debug_assert(index < tag_count);
+
+    TagState& state = tag_states[index];
+    state.budget_action.store(action, std::memory_order_relaxed);
+    state.budget.store(bytes, std::memory_order_relaxed);
+    state.over_budget.store(false, std::memory_order_relaxed);
+}
+
+void set_stack_sampling_rate(u32 rate) {
+    sampling_rate.store(rate, std::memory_order_relaxed);
+}
+
+core::Vector<StackSample> stack_samples() {
+    const auto lock = std::unique_lock(samples_lock);
+    const usize count = std::min(sample_count, max_stack_samples);
+    return core::Vector<StackSample>(samples.begin(), samples.begin() + count);
+}
+
+void log_report() {
+    for(usize i = 0; i != tag_count; ++i) {
+        const TagStats stats = tag_stats(MemoryTag(i));
+        if(!stats.total_allocations) {
+            continue;
+        }
+
+        log_msg(fmt("{}: {} KB live ({} allocations), {} KB peak, {} allocations total",
+            memory_tag_name(MemoryTag(i)),
+            stats.live_bytes / 1024, stats.live_allocations,
+            stats.peak_bytes / 1024, stats.total_allocations
+        ), Log::Perf);
+    }
+}
+
+}
+}
@@ -0,0 +1,113 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_UTILS_MEMORY_TRACKING_H
+#define Y_UTILS_MEMORY_TRACKING_H
+
+#include <y/core/Vector.h>
+#include <y/utils/memory.h>
+
+#include <array>
+#include <string_view>
+
+namespace y {
+
+enum class MemoryTag : u8 {
+    Untagged,
+    Assets,
+    Ecs,
+    FrameGraph,
+    Scripting,
+    Editor,
+
+    Max
+};
+
+std::string_view memory_tag_name(MemoryTag tag);
+
+// Allocations made by the calling thread are attributed to tag until the scope ends
+class MemoryTagScope : NonMovable {
+    public:
+        MemoryTagScope(MemoryTag tag);
+        ~MemoryTagScope();
+
+    private:
+        MemoryTag _previous;
+};
+
+#define y_memory_tag(tag) const y::MemoryTagScope y_create_name_with_prefix(memory_tag)(tag)
+
+
+// Lock free allocation accounting, fed by the global allocator (or anything that wants to report allocations).
+// Every thread counts in its own counters and only publishes its live byte delta once it exceeds a threshold,
+// so live bytes are exact when read but high water marks are only accurate to within flush_threshold per thread.
+namespace memory_tracking {
+
+static constexpr usize flush_threshold = 256 * 1024;
+static constexpr usize max_stack_frames = 16;
+
+enum class BudgetAction {
+    Log,
+    Fail
+};
+
+struct TagStats {
+    u64 live_bytes = 0;
+    u64 peak_bytes = 0;
+    u64 live_allocations = 0;
+    u64 total_allocations = 0;
+    u64 budget = 0;
+};
+
+struct StackSample {
+    MemoryTag tag = MemoryTag::Untagged;
+    usize size = 0;
+    u32 frame_count = 0;
+    std::array<void*, max_stack_frames> frames = {};
+};
+
+MemoryTag current_tag();
+
+// Returns false if the allocation would exceed a budget set with BudgetAction::Fail, in which case it should not be performed
+bool on_alloc(usize size, MemoryTag tag);
+void on_free(usize size, MemoryTag tag);
+
+TagStats tag_stats(MemoryTag tag);
+
+// Meant to back a global operator new: allocations are attributed to the current tag, and to the same tag when freed.
+// Throws std::bad_alloc on failure or if the allocation is over budget.
+void* tracked_alloc(usize size, usize alignment = max_alignment);
+void tracked_free(void* ptr);
+
+// A budget of 0 disables the check
+void set_budget(MemoryTag tag, u64 bytes, BudgetAction action = BudgetAction::Log);
+
+// Captures the call stack of one allocation every rate allocations (per thread), 0 disables sampling
+void set_stack_sampling_rate(u32 rate);
+core::Vector<StackSample> stack_samples();
+
+void log_report();
+
+}
+
+}
+
+#endif // Y_UTILS_MEMORY_TRACKING_H
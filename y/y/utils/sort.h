@@ -45,6 +45,58 @@ inline constexpr bool is_sorted(It b, It e, C comp = C()) {
     return true;
 }
 
+// Stable LSD radix sort of 64 bits keys, values are moved along with their key.
+// keys_buffer and values_buffer are used as scratch space and must hold at least size elements.
+// Passes where every key shares the same byte are skipped.
+template<typename V>
+void radix_sort(u64* keys, V* values, usize size, u64* keys_buffer, V* values_buffer) {
+    if(size <= 1) {
+        return;
+    }
+
+    std::array<std::array<usize, 256>, 8> histograms = {};
+    for(usize i = 0; i != size; ++i) {
+        const u64 key = keys[i];
+        for(usize b = 0; b != 8; ++b) {
+            ++histograms[b][(key >> (b * 8)) & 0xFF];
+        }
+    }
+
+    u64* src_keys = keys;
+    V* src_values = values;
+    u64* dst_keys = keys_buffer;
+    V* dst_values = values_buffer;
+
+    for(usize b = 0; b != 8; ++b) {
+        const usize shift = b * 8;
+        std::array<usize, 256>& offsets = histograms[b];
+        if(offsets[(src_keys[0] >> shift) & 0xFF] == size) {
+            continue;
+        }
+
+        usize total = 0;
+        for(usize& offset : offsets) {
+            const usize count = offset;
+            offset = total;
+            total += count;
+        }
+
+        for(usize i = 0; i != size; ++i) {
+            const usize dst = offsets[(src_keys[i] >> shift) & 0xFF]++;
+            dst_keys[dst] = src_keys[i];
+            dst_values[dst] = std::move(src_values[i]);
+        }
+
+        std::swap(src_keys, dst_keys);
+        std::swap(src_values, dst_values);
+    }
+
+    if(src_keys != keys) {
+        std::copy_n(src_keys, size, keys);
+        std::move(src_values, src_values + size, values);
+    }
+}
+
 namespace detail {
 template<typename T, usize N, typename C>
 static constexpr void ct_sort(std::array<T, N>& arr, usize left, usize right, C comp) {
@@ -0,0 +1,396 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "trace.h"
+
+#include <y/concurrent/concurrent.h>
+#include <y/io2/File.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+
+namespace y {
+namespace trace {
+
+namespace detail {
+constinit std::atomic<bool> enabled = false;
+}
+
+static constexpr u32 binary_magic = 0x43525459;  // "YTRC"
+static constexpr u32 binary_version = 1;
+
+struct RawEvent {
+    u64 begin = 0;
+    u64 end_or_value = 0;
+    const char* static_name = nullptr;
+    EventType type = EventType::Zone;
+    u8 name_size = 0;
+    char name[max_dynamic_name_size] = {};
+};
+
+static_assert(sizeof(RawEvent) == 64);
+
+// Only written by their owning thread, and never freed so they can be collected after the thread exits
+struct ThreadBuffer {
+    std::unique_ptr<RawEvent[]> events = std::make_unique<RawEvent[]>(max_events_per_thread);
+    std::atomic<u64> write_index = 0;
+    u32 thread_id = 0;
+    core::String thread_name;
+    ThreadBuffer* next = nullptr;
+};
+
+static constinit std::atomic<ThreadBuffer*> all_buffers = nullptr;
+static constinit thread_local ThreadBuffer* thread_buffer = nullptr;
+
+static ThreadBuffer& local_buffer() {
+    if(!thread_buffer) {
+        ThreadBuffer* buffer = new ThreadBuffer();
+        buffer->thread_id = concurrent::thread_id();
+        buffer->thread_name = concurrent::thread_name();
+        buffer->next = all_buffers.load(std::memory_order_relaxed);
+        while(!all_buffers.compare_exchange_weak(buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        thread_buffer = buffer;
+    }
+    return *thread_buffer;
+}
+
+static void push_event(EventType type, u64 begin, u64 end_or_value, const char* static_name, std::string_view dynamic_name = {}) {
+    ThreadBuffer& buffer = local_buffer();
+
+    const u64 index = buffer.write_index.load(std::memory_order_relaxed);
+    RawEvent& event = buffer.events[index % max_events_per_thread];
+    event.type = type;
+    event.begin = begin;
+    event.end_or_value = end_or_value;
+    event.static_name = static_name;
+    event.name_size = u8(std::min(dynamic_name.size(), sizeof(event.name)));
+    std::copy_n(dynamic_name.data(), event.name_size, event.name);
+
+    buffer.write_index.store(index + 1, std::memory_order_release);
+}
+
+
+void set_enabled(bool enabled) {
+    detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+u64 now_ns() {
+    return u64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Zone::Zone(const char* name) {
+    if(is_enabled()) {
+        _name = name;
+        _begin = now_ns();
+    }
+}
+
+Zone::Zone(dynamic_name_t, std::string_view name) {
+    if(is_enabled()) {
+        _dynamic_name_size = u8(std::min(name.size(), max_dynamic_name_size));
+        std::copy_n(name.data(), _dynamic_name_size, _dynamic_name);
+        _begin = now_ns();
+    }
+}
+
+Zone::~Zone() {
+    if(_begin) {
+        push_event(EventType::Zone, _begin, now_ns(), _name, std::string_view(_dynamic_name, _dynamic_name_size));
+    }
+}
+
+void frame_mark() {
+    if(is_enabled()) {
+        push_event(EventType::Frame, now_ns(), 0, "Frame");
+    }
+}
+
+void message(std::string_view msg) {
+    if(is_enabled()) {
+        push_event(EventType::Message, now_ns(), 0, nullptr, msg);
+    }
+}
+
+void plot(const char* name, i64 value) {
+    if(is_enabled()) {
+        push_event(EventType::Plot, now_ns(), u64(value), name);
+    }
+}
+
+core::Vector<ThreadTrace> collect() {
+    core::Vector<ThreadTrace> traces;
+    for(const ThreadBuffer* buffer = all_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        const u64 end = buffer->write_index.load(std::memory_order_acquire);
+        const u64 begin = end > max_events_per_thread ? end - max_events_per_thread : 0;
+        if(begin == end) {
+            continue;
+        }
+
+        ThreadTrace& trace = traces.emplace_back();
+        trace.thread_id = buffer->thread_id;
+        trace.thread_name = buffer->thread_name;
+        trace.events.set_min_capacity(usize(end - begin));
+
+        for(u64 i = begin; i != end; ++i) {
+            const RawEvent& raw = buffer->events[i % max_events_per_thread];
+
+            Event& event = trace.events.emplace_back();
+            event.type = raw.type;
+            event.begin_ns = raw.begin;
+            event.name = raw.static_name ? core::String(raw.static_name) : core::String(raw.name, raw.name_size);
+            if(raw.type == EventType::Plot) {
+                event.value = i64(raw.end_or_value);
+                event.end_ns = raw.begin;
+            } else {
+                event.end_ns = std::max(raw.begin, raw.end_or_value);
+            }
+        }
+
+        // Zones are pushed when they end, so nested zones come before their parents
+        std::stable_sort(trace.events.begin(), trace.events.end(), [](const Event& a, const Event& b) { return a.begin_ns < b.begin_ns; });
+    }
+
+    std::sort(traces.begin(), traces.end(), [](const ThreadTrace& a, const ThreadTrace& b) { return a.thread_id < b.thread_id; });
+    return traces;
+}
+
+void clear() {
+    for(ThreadBuffer* buffer = all_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        // Not synchronized with the owning thread: events recorded while clearing may be lost
+        buffer->write_index.store(0, std::memory_order_release);
+    }
+}
+
+
+
+static io2::WriteResult write_str(io2::Writer& writer, std::string_view str) {
+    return writer.write(str.data(), str.size());
+}
+
+static io2::WriteResult write_json_str(io2::Writer& writer, std::string_view str) {
+    y_try(write_str(writer, "\""));
+    for(const char c : str) {
+        switch(c) {
+            case '"':
+                y_try(write_str(writer, "\\\""));
+            break;
+
+            case '\\':
+                y_try(write_str(writer, "\\\\"));
+            break;
+
+            case '\n':
+                y_try(write_str(writer, "\\n"));
+            break;
+
+            default:
+                if(u8(c) < 0x20) {
+                    y_try(write_str(writer, " "));
+                } else {
+                    y_try(writer.write_one(c));
+                }
+        }
+    }
+    return write_str(writer, "\"");
+}
+
+static io2::WriteResult write_timestamp(io2::Writer& writer, u64 ns) {
+    // Chrome traces use microseconds
+    char buffer[32] = {};
+    const int len = std::snprintf(buffer, sizeof(buffer), "%llu.%03u", static_cast<unsigned long long>(ns / 1000), unsigned(ns % 1000));
+    return writer.write(buffer, usize(len));
+}
+
+static io2::WriteResult write_number(io2::Writer& writer, i64 value) {
+    char buffer[32] = {};
+    const int len = std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+    return writer.write(buffer, usize(len));
+}
+
+io2::WriteResult write_chrome_trace(io2::Writer& writer, core::Span<ThreadTrace> traces) {
+    u64 base = u64(-1);
+    for(const ThreadTrace& trace : traces) {
+        if(!trace.events.is_empty()) {
+            base = std::min(base, trace.events.first().begin_ns);
+        }
+    }
+
+    bool first = true;
+    auto begin_event = [&](const char* phase, std::string_view name, u32 tid, u64 ts) -> io2::WriteResult {
+        y_try(write_str(writer, first ? "\n{\"ph\":\"" : ",\n{\"ph\":\""));
+        first = false;
+        y_try(write_str(writer, phase));
+        y_try(write_str(writer, "\",\"pid\":0,\"tid\":"));
+        y_try(write_number(writer, i64(tid)));
+        y_try(write_str(writer, ",\"name\":"));
+        y_try(write_json_str(writer, name));
+        y_try(write_str(writer, ",\"ts\":"));
+        return write_timestamp(writer, ts - std::min(ts, base));
+    };
+
+    y_try(write_str(writer, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+
+    for(const ThreadTrace& trace : traces) {
+        y_try(begin_event("M", "thread_name", trace.thread_id, base));
+        y_try(write_str(writer, ",\"args\":{\"name\":"));
+        y_try(write_json_str(writer, trace.thread_name));
+        y_try(write_str(writer, "}}"));
+
+        for(const Event& event : trace.events) {
+            switch(event.type) {
+                case EventType::Zone:
+                    y_try(begin_event("X", event.name, trace.thread_id, event.begin_ns));
+                    y_try(write_str(writer, ",\"dur\":"));
+                    y_try(write_timestamp(writer, event.end_ns - event.begin_ns));
+                break;
+
+                case EventType::Frame:
+                    y_try(begin_event("i", event.name, trace.thread_id, event.begin_ns));
+                    y_try(write_str(writer, ",\"s\":\"g\""));
+                break;
+
+                case EventType::Message:
+                    y_try(begin_event("i", event.name, trace.thread_id, event.begin_ns));
+                    y_try(write_str(writer, ",\"s\":\"t\""));
+                break;
+
+                case EventType::Plot:
+                    y_try(begin_event("C", event.name, trace.thread_id, event.begin_ns));
+                    y_try(write_str(writer, ",\"args\":{\"value\":"));
+                    y_try(write_number(writer, event.value));
+                    y_try(write_str(writer, "}"));
+                break;
+            }
+            y_try(write_str(writer, "}"));
+        }
+    }
+
+    return write_str(writer, "\n]}\n");
+}
+
+
+static io2::WriteResult write_binary_str(io2::Writer& writer, std::string_view str) {
+    y_try(writer.write_one(u32(str.size())));
+    return writer.write(str.data(), str.size());
+}
+
+static core::Result<core::String> read_binary_str(io2::Reader& reader) {
+    u32 size = 0;
+    y_try_discard(reader.read_one(size));
+    if(size > reader.remaining()) {
+        return core::Err();
+    }
+
+    core::String str(nullptr, size);
+    y_try_discard(reader.read(str.data(), size));
+    return core::Ok(std::move(str));
+}
+
+io2::WriteResult write_binary(io2::Writer& writer, core::Span<ThreadTrace> traces) {
+    y_try(writer.write_one(binary_magic));
+    y_try(writer.write_one(binary_version));
+    y_try(writer.write_one(u32(traces.size())));
+
+    for(const ThreadTrace& trace : traces) {
+        y_try(writer.write_one(trace.thread_id));
+        y_try(write_binary_str(writer, trace.thread_name));
+        y_try(writer.write_one(u64(trace.events.size())));
+
+        for(const Event& event : trace.events) {
+            y_try(writer.write_one(event.type));
+            y_try(writer.write_one(event.begin_ns));
+            y_try(writer.write_one(event.type == EventType::Plot ? u64(event.value) : event.end_ns - event.begin_ns));
+            y_try(write_binary_str(writer, event.name));
+        }
+    }
+
+    return core::Ok();
+}
+
+core::Result<core::Vector<ThreadTrace>> read_binary(io2::Reader& reader) {
+    u32 magic = 0;
+    u32 version = 0;
+    u32 thread_count = 0;
+    y_try_discard(reader.read_one(magic));
+    y_try_discard(reader.read_one(version));
+    y_try_discard(reader.read_one(thread_count));
+
+    if(magic != binary_magic || version != binary_version) {
+        return core::Err();
+    }
+
+    core::Vector<ThreadTrace> traces;
+    for(u32 t = 0; t != thread_count; ++t) {
+        ThreadTrace& trace = traces.emplace_back();
+        y_try_discard(reader.read_one(trace.thread_id));
+
+        auto thread_name = read_binary_str(reader);
+        y_try_discard(thread_name);
+        trace.thread_name = std::move(thread_name.unwrap());
+
+        u64 event_count = 0;
+        y_try_discard(reader.read_one(event_count));
+
+        for(u64 i = 0; i != event_count; ++i) {
+            Event& event = trace.events.emplace_back();
+            u64 duration_or_value = 0;
+            y_try_discard(reader.read_one(event.type));
+            y_try_discard(reader.read_one(event.begin_ns));
+            y_try_discard(reader.read_one(duration_or_value));
+
+            if(event.type > EventType::Plot) {
+                return core::Err();
+            }
+
+            if(event.type == EventType::Plot) {
+                event.value = i64(duration_or_value);
+                event.end_ns = event.begin_ns;
+            } else {
+                event.end_ns = event.begin_ns + duration_or_value;
+            }
+
+            auto name = read_binary_str(reader);
+            y_try_discard(name);
+            event.name = std::move(name.unwrap());
+        }
+    }
+
+    return core::Ok(std::move(traces));
+}
+
+core::Result<void> save(const core::String& file_name) {
+    auto file = io2::File::create(file_name);
+    y_try_discard(file);
+
+    core::Vector<ThreadTrace> traces = collect();
+    const bool json = std::string_view(file_name).ends_with(".json");
+    y_try_discard((json ? write_chrome_trace(file.unwrap(), traces) : write_binary(file.unwrap(), traces)));
+    y_try_discard(file.unwrap().flush());
+
+    return core::Ok();
+}
+
+}
+}
@@ -0,0 +1,115 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_UTILS_TRACE_H
+#define Y_UTILS_TRACE_H
+
+#include <y/core/String.h>
+#include <y/io2/io.h>
+
+#include <atomic>
+#include <string_view>
+
+namespace y {
+
+// Lightweight zone recorder: every thread records in its own lock free ring buffer, oldest events get overwritten.
+// Recording is off by default and can be toggled at any time.
+namespace trace {
+
+static constexpr usize max_events_per_thread = 16 * 1024;
+static constexpr usize max_dynamic_name_size = 38;
+
+enum class EventType : u8 {
+    Zone,
+    Frame,
+    Message,
+    Plot
+};
+
+struct Event {
+    EventType type = EventType::Zone;
+    u64 begin_ns = 0;
+    u64 end_ns = 0;
+    i64 value = 0;
+    core::String name;
+};
+
+struct ThreadTrace {
+    u32 thread_id = 0;
+    core::String thread_name;
+    core::Vector<Event> events;
+};
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}
+
+inline bool is_enabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void set_enabled(bool enabled);
+
+u64 now_ns();
+
+struct dynamic_name_t {};
+static constexpr dynamic_name_t dynamic_name = {};
+
+class Zone : NonMovable {
+    public:
+        // name must outlive the trace
+        Zone(const char* name);
+
+        // name is copied and truncated to max_dynamic_name_size
+        Zone(dynamic_name_t, std::string_view name);
+
+        ~Zone();
+
+    private:
+        u64 _begin = 0;
+        const char* _name = nullptr;
+        u8 _dynamic_name_size = 0;
+        char _dynamic_name[max_dynamic_name_size] = {};
+};
+
+void frame_mark();
+void message(std::string_view msg);
+void plot(const char* name, i64 value);
+
+// Copies the events currently in the ring buffers of all threads, sorted by begin time.
+// Events recorded while collecting may be torn: disable recording first.
+core::Vector<ThreadTrace> collect();
+void clear();
+
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+io2::WriteResult write_chrome_trace(io2::Writer& writer, core::Span<ThreadTrace> traces);
+
+// Compact binary format, that can be converted to Chrome trace later
+io2::WriteResult write_binary(io2::Writer& writer, core::Span<ThreadTrace> traces);
+core::Result<core::Vector<ThreadTrace>> read_binary(io2::Reader& reader);
+
+// Collects and writes all threads to file_name: as Chrome trace JSON if the name ends with ".json", in the binary format otherwise
+core::Result<void> save(const core::String& file_name);
+
+}
+}
+
+#endif // Y_UTILS_TRACE_H
@@ -96,7 +96,7 @@ AssetLoader::Loader<T>::Loader(AssetLoader* parent) : LoaderBase(parent) {
 }
 
 template<typename T>
-AssetLoader::Loader<T>::~Loader<T>() {
+AssetLoader::Loader<T>::~Loader() {
     y_profile();
      _loaded.locked([&](auto&& loaded) {
         for(auto&& [id, ptr] : loaded) {
@@ -190,7 +190,7 @@ std::unique_ptr<AssetLoader::LoadingJob> AssetLoader::Loader<T>::create_loading_
                 y_always_assert(_data->loader() == parent(), "Mismatched AssetLoaders");
                 y_always_assert(id != AssetId::invalid_id(), "Invalid asset ID");
 
-                if(auto reader = parent()->store().data(id)) {
+                if(auto reader = asset_data()) {
                     y_profile_zone("deserializing");
 
                     const serde3::Result res = serde3::ReadableArchive(*reader.unwrap()).deserialize(_load_from);
@@ -229,6 +229,10 @@ std::unique_ptr<AssetLoader::LoadingJob> AssetLoader::Loader<T>::create_loading_
                 y_profile_msg(fmt_c_str("finished loading {}", asset_name()));
             }
 
+            AssetId asset_id() const override {
+                return _data->id;
+            }
+
             void set_dependencies_failed() override {
                 if(_data->is_failed()) {
                     return;
@@ -28,6 +28,7 @@ SOFTWARE.
 
 #include <y/utils/log.h>
 #include <y/utils/format.h>
+#include <y/utils/memory_tracking.h>
 
 namespace yave {
 
@@ -49,7 +50,25 @@ AssetLoadingContext& AssetLoadingThreadPool::LoadingJob::loading_context() {
     return _ctx;
 }
 
-AssetLoadingThreadPool::AssetLoadingThreadPool(AssetLoader* parent, usize concurency) : _parent(parent) {
+core::Result<io2::ReaderPtr> AssetLoadingThreadPool::LoadingJob::asset_data() {
+    if(_prefetched) {
+        _prefetched = false;
+        if(_prefetched_data) {
+            // Decoded here rather than in the read callback so that decompression runs on the loading threads
+            if(auto data = parent()->store().decode_data(std::move(_prefetched_data))) {
+                return core::Ok(std::move(data.unwrap()));
+            }
+        }
+        return core::Err();
+    }
+
+    if(auto data = parent()->store().data(asset_id())) {
+        return core::Ok(std::move(data.unwrap()));
+    }
+    return core::Err();
+}
+
+AssetLoadingThreadPool::AssetLoadingThreadPool(AssetLoader* parent, usize concurency) : _parent(parent), _read_queue(64) {
     _threads = core::Vector<std::thread>::with_capacity(concurency);
     for(usize i = 0; i != concurency; ++i) {
         _threads.emplace_back([this] {
@@ -60,6 +79,8 @@ AssetLoadingThreadPool::AssetLoadingThreadPool(AssetLoader* parent, usize concur
 }
 
 AssetLoadingThreadPool::~AssetLoadingThreadPool() {
+    _read_queue.wait_until_idle();
+
     {
         _run = false;
         const auto lock = std::unique_lock(_lock);
@@ -74,24 +95,46 @@ AssetLoadingThreadPool::~AssetLoadingThreadPool() {
 void AssetLoadingThreadPool::wait_until_loaded(const GenericAssetPtr& ptr) {
     y_profile();
     while(ptr.is_loading()) {
-        process_one(std::unique_lock(_lock));
+        if(!process_one(std::unique_lock(_lock))) {
+            // The asset is still being read or is being loaded by another thread
+            auto lock = std::unique_lock(_lock);
+            _condition.wait_for(lock, std::chrono::milliseconds(1), [&] {
+                return !_loading_jobs.is_empty() || !ptr.is_loading();
+            });
+        }
     }
 }
 
 void AssetLoadingThreadPool::add_loading_job(std::unique_ptr<LoadingJob> job) {
-    {
-        const auto lock = std::unique_lock(_lock);
-        _loading_jobs.emplace_back(std::move(job));
-    }
-    _condition.notify_one();
+    y_profile();
+
+    ++_reading;
+
+    // std::function needs to be copyable, so the job is released and adopted again by the callback
+    LoadingJob* job_ptr = job.release();
+    _parent->store().data_async(job_ptr->asset_id(), _read_queue, [this, job_ptr](AssetStore::Result<io2::ReaderPtr> data) {
+        std::unique_ptr<LoadingJob> job(job_ptr);
+        job->_prefetched = true;
+        if(data) {
+            job->_prefetched_data = std::move(data.unwrap());
+        }
+
+        {
+            const auto lock = std::unique_lock(_lock);
+            _loading_jobs.emplace_back(std::move(job));
+            --_reading;
+        }
+        _condition.notify_one();
+    });
 }
 
 bool AssetLoadingThreadPool::is_processing() const {
-    return _processing != 0;
+    return _processing != 0 || _reading != 0;
 }
 
-void AssetLoadingThreadPool::process_one(std::unique_lock<std::mutex> lock) {
+bool AssetLoadingThreadPool::process_one(std::unique_lock<std::mutex> lock) {
     y_profile();
+    y_memory_tag(MemoryTag::Assets);
     y_debug_assert(lock.owns_lock());
 
     ++_processing;
@@ -112,7 +155,7 @@ void AssetLoadingThreadPool::process_one(std::unique_lock<std::mutex> lock) {
                     job->set_dependencies_failed();
                 }
                 _condition.notify_all();
-                return;
+                return true;
             }
         }
     }
@@ -134,13 +177,18 @@ void AssetLoadingThreadPool::process_one(std::unique_lock<std::mutex> lock) {
                 } else if(state == AssetLoadingState::Failed) {
                     job->set_dependencies_failed();
                 }
-                _condition.notify_all();
             } else {
                 auto inner_lock = std::unique_lock(_lock);
                 _finalize_jobs.emplace_back(std::move(job));
             }
         }
+
+        // Also wakes up wait_until_loaded when the read failed
+        _condition.notify_all();
+        return true;
     }
+
+    return false;
 }
 
 void AssetLoadingThreadPool::worker() {
@@ -25,6 +25,7 @@ SOFTWARE.
 #include "AssetLoadingContext.h"
 
 #include <y/core/RingQueue.h>
+#include <y/io2/ReadQueue.h>
 
 #include <thread>
 #include <mutex>
@@ -47,6 +48,8 @@ class AssetLoadingThreadPool : NonMovable {
                 virtual void finalize() = 0;
                 virtual void set_dependencies_failed() = 0;
 
+                virtual AssetId asset_id() const = 0;
+
                 const AssetDependencies& dependencies() const;
                 AssetLoader* parent() const;
 
@@ -55,8 +58,16 @@ class AssetLoadingThreadPool : NonMovable {
 
                 AssetLoadingContext& loading_context();
 
+                // Returns the data fetched by the thread pool, or reads it from the store if it wasn't prefetched
+                core::Result<io2::ReaderPtr> asset_data();
+
             private:
+                friend class AssetLoadingThreadPool;
+
                 AssetLoadingContext _ctx;
+
+                io2::ReaderPtr _prefetched_data;
+                bool _prefetched = false;
         };
 
 
@@ -70,7 +81,8 @@ class AssetLoadingThreadPool : NonMovable {
         bool is_processing() const;
 
     private:
-        void process_one(std::unique_lock<std::mutex> lock);
+        // Returns false if there was nothing to do
+        bool process_one(std::unique_lock<std::mutex> lock);
         void worker();
 
         core::RingQueue<std::unique_ptr<LoadingJob>> _loading_jobs;
@@ -82,8 +94,12 @@ class AssetLoadingThreadPool : NonMovable {
         core::Vector<std::thread> _threads;
         std::atomic<bool> _run = true;
         std::atomic<u32> _processing = 0;
+        std::atomic<u32> _reading = 0;
+
+        AssetLoader* _parent = nullptr;
 
-        [[maybe_unused]] AssetLoader* _parent = nullptr;
+        // Jobs only get to the loading threads once their data has been read, so they never block on disk
+        io2::ReadQueue _read_queue;
 };
 
 }
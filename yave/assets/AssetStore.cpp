@@ -65,6 +65,15 @@ AssetStore::Result<> AssetStore::write(AssetId id, io2::Reader& data) {
     return core::Err(ErrorType::UnsupportedOperation);
 }
 
+void AssetStore::data_async(AssetId id, io2::ReadQueue& queue, DataCallback on_done) const {
+    unused(queue);
+    on_done(data(id));
+}
+
+AssetStore::Result<io2::ReaderPtr> AssetStore::decode_data(io2::ReaderPtr data) const {
+    return core::Ok(std::move(data));
+}
+
 AssetStore::Result<AssetType> AssetStore::asset_type(AssetId id) const {
     unused(id);
     return core::Err(ErrorType::UnsupportedOperation);
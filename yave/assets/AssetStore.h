@@ -27,6 +27,12 @@ SOFTWARE.
 
 #include <y/io2/io.h>
 
+#include <functional>
+
+namespace y::io2 {
+class ReadQueue;
+}
+
 namespace yave {
 
 class FileSystemModel;
@@ -49,6 +55,8 @@ class AssetStore : NonCopyable {
         template<typename T = void>
         using Result = core::Result<T, ErrorType>;
 
+        using DataCallback = std::function<void(Result<io2::ReaderPtr>)>;
+
 
 
         AssetStore();
@@ -64,6 +72,14 @@ class AssetStore : NonCopyable {
 
         virtual Result<io2::ReaderPtr> data(AssetId id) const = 0;
 
+        // Fetches the data of an asset without blocking the caller, on_done can be called from any thread and should return quickly.
+        // The data may still need to go through decode_data before it can be read.
+        // The default implementation calls data() synchronously.
+        virtual void data_async(AssetId id, io2::ReadQueue& queue, DataCallback on_done) const;
+
+        // Turns what data_async returned into what data() would have returned, this can be expensive (decompression)
+        virtual Result<io2::ReaderPtr> decode_data(io2::ReaderPtr data) const;
+
         virtual Result<> remove(AssetId id);
         virtual Result<> rename(AssetId id, std::string_view new_name);
 
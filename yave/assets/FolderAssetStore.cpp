@@ -23,6 +23,10 @@ SOFTWARE.
 #include "FolderAssetStore.h"
 
 #include <y/io2/File.h>
+#include <y/io2/MappedFile.h>
+#include <y/io2/ReadQueue.h>
+#include <y/io2/Buffer.h>
+#include <y/io2/Compressed.h>
 #include <y/concurrent/StaticThreadPool.h>
 
 #include <y/core/Chrono.h>
@@ -35,6 +39,19 @@ SOFTWARE.
 
 namespace yave {
 
+static core::Result<io2::ReaderPtr> decompressed(io2::ReaderPtr data) {
+    if(!io2::CompressedReader::is_compressed(*data)) {
+        return core::Ok(std::move(data));
+    }
+
+    if(auto reader = io2::CompressedReader::open(std::move(data))) {
+        io2::ReaderPtr ptr = std::make_unique<io2::CompressedReader>(std::move(reader.unwrap()));
+        return core::Ok(std::move(ptr));
+    }
+
+    return core::Err();
+}
+
 static bool is_delimiter(char c) {
     return c == '/';
 }
@@ -483,9 +500,7 @@ AssetStore::Result<AssetId> FolderAssetStore::import(io2::Reader& data, std::str
 
     {
         y_profile_zone("writing");
-        if(!io2::File::copy(data, data_file_name)) {
-            return core::Err(ErrorType::FilesytemError);
-        }
+        y_try(write_data(data, data_file_name, type));
     }
 
     const AssetDesc desc = { dst_name, type };
@@ -513,13 +528,68 @@ AssetStore::Result<> FolderAssetStore::write(AssetId id, io2::Reader& data) {
         return core::Err(ErrorType::UnknownID);
     }
 
-    if(!io2::File::copy(data, data_file_name)) {
+    const AssetType type = asset_type(id).unwrap_or(AssetType::Unknown);
+    return write_data(data, data_file_name, type);
+}
+
+static bool write_data_file(io2::Reader& data, const core::String& file_name, bool compressed) {
+    if(!compressed) {
+        return io2::File::copy(data, file_name).is_ok();
+    }
+
+    auto file = io2::File::create(file_name);
+    if(!file) {
+        return false;
+    }
+
+    io2::CompressedWriter writer(file.unwrap());
+
+    // Feed the writer one block at a time so only a couple of blocks are ever in memory
+    core::FixedArray<u8> buffer(io2::CompressedWriter::default_block_size);
+    while(!data.at_end()) {
+        const auto read = data.read_up_to(buffer.data(), buffer.size());
+        if(!read || !read.unwrap() || !writer.write(buffer.data(), read.unwrap())) {
+            return false;
+        }
+    }
+
+    return writer.flush().is_ok();
+}
+
+AssetStore::Result<> FolderAssetStore::write_data(io2::Reader& data, const core::String& file_name, AssetType type) const {
+    // Never write over the data in place: it might be mapped by a reader, which would see the file change (or shrink) under it.
+    // Renaming replaces the directory entry and leaves existing mappings on the old file.
+    const core::String tmp_file = file_name + "_";
+
+    if(!write_data_file(data, tmp_file, is_compressed(type))) {
+        FileSystemModel::local_filesystem()->remove(tmp_file).ignore();
+        return core::Err(ErrorType::FilesytemError);
+    }
+
+    if(!FileSystemModel::local_filesystem()->rename(tmp_file, file_name)) {
+        FileSystemModel::local_filesystem()->remove(tmp_file).ignore();
         return core::Err(ErrorType::FilesytemError);
     }
 
     return core::Ok();
 }
 
+void FolderAssetStore::set_compressed(AssetType type, bool compressed) {
+    const auto lock = std::unique_lock(_lock);
+
+    const u32 bit = 1 << u32(type);
+    if(compressed) {
+        _compressed_types |= bit;
+    } else {
+        _compressed_types &= ~bit;
+    }
+}
+
+bool FolderAssetStore::is_compressed(AssetType type) const {
+    const auto lock = std::unique_lock(_lock);
+    return (_compressed_types >> u32(type)) & 0x01;
+}
+
 AssetStore::Result<io2::ReaderPtr> FolderAssetStore::data(AssetId id) const {
     y_profile();
 
@@ -527,14 +597,69 @@ AssetStore::Result<io2::ReaderPtr> FolderAssetStore::data(AssetId id) const {
         return core::Err(ErrorType::UnknownID);
     }
 
-    if(auto file = io2::File::open(asset_data_file_name(id))) {
-        io2::ReaderPtr ptr = std::make_unique<io2::File>(std::move(file.unwrap()));
-        return core::Ok(std::move(ptr));
+    // Mapped so that deserialization can read POD collections directly from the page cache
+    if(auto file = io2::MappedFile::open(asset_data_file_name(id))) {
+        io2::ReaderPtr ptr = std::make_unique<io2::MappedFile>(std::move(file.unwrap()));
+        return decode_data(std::move(ptr));
     }
 
     return core::Err(ErrorType::UnknownID);
 }
 
+void FolderAssetStore::data_async(AssetId id, io2::ReadQueue& queue, DataCallback on_done) const {
+    y_profile();
+
+    if(id == AssetId::invalid_id()) {
+        on_done(core::Err(ErrorType::UnknownID));
+        return;
+    }
+
+    const core::String file_name = asset_data_file_name(id);
+
+    // Mapping is preferred so that deserialization still reads POD collections in place.
+    // The kernel pages the file in ahead of the loading thread, nothing is read here.
+    if(auto mapped = io2::MappedFile::open(file_name)) {
+        mapped.unwrap().prefetch();
+        io2::ReaderPtr ptr = std::make_unique<io2::MappedFile>(std::move(mapped.unwrap()));
+        on_done(core::Ok(std::move(ptr)));
+        return;
+    }
+
+    // Files that can't be mapped are read through the queue
+    auto file = io2::AsyncFile::open(file_name);
+    if(!file) {
+        on_done(core::Err(ErrorType::UnknownID));
+        return;
+    }
+
+    struct Request {
+        io2::AsyncFile file;
+        core::Vector<u8> data;
+        DataCallback on_done;
+    };
+
+    auto request = std::make_shared<Request>();
+    request->file = std::move(file.unwrap());
+    request->data = core::Vector<u8>(request->file.size(), u8(0));
+    request->on_done = std::move(on_done);
+
+    queue.read(request->file, 0, request->data, [request](io2::ReadResult res) {
+        if(res.is_error()) {
+            request->on_done(core::Err(ErrorType::FilesytemError));
+            return;
+        }
+        io2::ReaderPtr ptr = std::make_unique<io2::Buffer>(std::move(request->data));
+        request->on_done(core::Ok(std::move(ptr)));
+    });
+}
+
+AssetStore::Result<io2::ReaderPtr> FolderAssetStore::decode_data(io2::ReaderPtr data) const {
+    if(auto reader = decompressed(std::move(data))) {
+        return core::Ok(std::move(reader.unwrap()));
+    }
+    return core::Err(ErrorType::FilesytemError);
+}
+
 AssetStore::Result<AssetId> FolderAssetStore::id(std::string_view name) const {
     y_profile();
 
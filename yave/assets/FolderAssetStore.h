@@ -89,6 +89,8 @@ class FolderAssetStore final : NonMovable, public AssetStore {
         Result<core::String> name(AssetId id) const override;
 
         Result<io2::ReaderPtr> data(AssetId id) const override;
+        void data_async(AssetId id, io2::ReadQueue& queue, DataCallback on_done) const override;
+        Result<io2::ReaderPtr> decode_data(io2::ReaderPtr data) const override;
 
         Result<> remove(AssetId id) override;
         Result<> rename(AssetId id, std::string_view new_name) override;
@@ -97,7 +99,12 @@ class FolderAssetStore final : NonMovable, public AssetStore {
 
         Result<AssetType> asset_type(AssetId id) const override;
 
+        // Data of assets of this type will be block compressed when written (existing files are left as is)
+        void set_compressed(AssetType type, bool compressed = true);
+        bool is_compressed(AssetType type) const;
+
     private:
+        Result<> write_data(io2::Reader& data, const core::String& file_name, AssetType type) const;
         AssetId next_id();
         void rebuild_id_map() const;
 
@@ -124,6 +131,8 @@ class FolderAssetStore final : NonMovable, public AssetStore {
         std::set<core::String> _folders;
         std::map<core::String, AssetData> _assets;
 
+        u32 _compressed_types = 0;
+
         mutable std::unique_ptr<core::FlatHashMap<AssetId, std::map<core::String, AssetData>::const_iterator>> _ids;
 
         mutable std::recursive_mutex _lock;
@@ -23,10 +23,11 @@ SOFTWARE.
 #include "TransformableComponent.h"
 
 #include <yave/scene/OctreeNode.h>
+#include <yave/ecs/EntityWorld.h>
 
 namespace yave {
 
-TransformableComponent::TransformableComponent(const math::Transform<>& transform) : _transform(transform) {
+TransformableComponent::TransformableComponent(const math::Transform<>& transform) : _transform(transform), _local(transform) {
 }
 
 TransformableComponent::TransformableComponent(TransformableComponent&& other) {
@@ -38,12 +39,20 @@ TransformableComponent& TransformableComponent::operator=(TransformableComponent
     return *this;
 }
 
-TransformableComponent::TransformableComponent(const TransformableComponent& other) {
-    set_transform(other.transform());
+// Octree node and transform index belong to the instance and are never copied
+TransformableComponent::TransformableComponent(const TransformableComponent& other) :
+        _transform(other._transform),
+        _aabb(other._aabb),
+        _local(other._local),
+        _world_changed(other._world_changed) {
 }
 
 TransformableComponent& TransformableComponent::operator=(const TransformableComponent& other) {
-    set_transform(other.transform());
+    _transform = other._transform;
+    _aabb = other._aabb;
+    _local = other._local;
+    _world_changed = other._world_changed;
+    _dirty = true;
     return *this;
 }
 
@@ -52,20 +61,47 @@ void TransformableComponent::swap(TransformableComponent& other) {
     std::swap(_aabb, other._aabb);
     std::swap(_node, other._node);
     std::swap(_transform_index, other._transform_index);
+    std::swap(_local, other._local);
+    std::swap(_world_changed, other._world_changed);
+    std::swap(_dirty, other._dirty);
 }
 
 void TransformableComponent::set_transform(const math::Transform<>& tr) {
     _transform = tr;
+    _world_changed = true;
+    _dirty = true;
 }
 
 void TransformableComponent::set_position(const math::Vec3& pos) {
     _transform.position() = pos;
+    _world_changed = true;
+    _dirty = true;
 }
 
 const math::Transform<>& TransformableComponent::transform() const {
     return _transform;
 }
 
+void TransformableComponent::set_local_transform(const math::Transform<>& tr) {
+    _local = tr;
+    _world_changed = false;
+    _dirty = true;
+}
+
+const math::Transform<>& TransformableComponent::local_transform() const {
+    return _local;
+}
+
+void TransformableComponent::update_from_parent(const TransformableComponent* parent) {
+    if(_world_changed) {
+        _local = parent ? math::Transform<>(parent->_transform.inverse() * _transform) : _transform;
+        _world_changed = false;
+    } else {
+        _transform = parent ? math::Transform<>(parent->_transform * _local) : _local;
+    }
+    _dirty = false;
+}
+
 const math::Vec3& TransformableComponent::forward() const {
     return _transform.forward();
 }
@@ -115,8 +151,35 @@ u32 TransformableComponent::transform_index() const {
     return _transform_index;
 }
 
+void TransformableComponent::post_deserialize() {
+    _world_changed = true;
+    _dirty = true;
+}
+
 void TransformableComponent::inspect(ecs::ComponentInspector* inspector) {
+    const math::Transform<> previous = _transform;
     inspector->inspect("Transform", _transform);
+    if(_transform != previous) {
+        _world_changed = true;
+        _dirty = true;
+    }
+}
+
+
+
+core::Vector<ecs::EntityId> instantiate_prefab(ecs::EntityWorld& world, const ecs::PrefabSpawnPlan& plan, core::Span<math::Transform<>> transforms) {
+    y_profile();
+
+    const usize count = transforms.size();
+    core::Vector<ecs::EntityId> ids = world.instantiate(plan, count);
+
+    for(usize i = 0; i != ids.size(); ++i) {
+        if(TransformableComponent* tr = world.component_mut<TransformableComponent>(ids[i])) {
+            tr->set_transform(transforms[i % count] * tr->transform());
+        }
+    }
+
+    return ids;
 }
 
 }
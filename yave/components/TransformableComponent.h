@@ -42,11 +42,17 @@ class TransformableComponent final {
         TransformableComponent(const TransformableComponent& other);
         TransformableComponent& operator=(const TransformableComponent& other);
 
+        // World space transform
         void set_transform(const math::Transform<>& tr);
         void set_position(const math::Vec3& pos);
 
         const math::Transform<>& transform() const;
 
+        // Parent relative transform, the world transform is updated by TransformHierarchySystem
+        void set_local_transform(const math::Transform<>& tr);
+
+        const math::Transform<>& local_transform() const;
+
         const math::Vec3& forward() const;
         const math::Vec3& right() const;
         const math::Vec3& up() const;
@@ -65,6 +71,9 @@ class TransformableComponent final {
 
         void inspect(ecs::ComponentInspector* inspector);
 
+        // The local transform isn't serialized and is recomputed from the world one
+        void post_deserialize();
+
         y_reflect(TransformableComponent, _transform)
 
     private:
@@ -73,6 +82,19 @@ class TransformableComponent final {
         math::Transform<> _transform;
         AABB _aabb;
 
+    private:
+        friend class TransformHierarchySystem;
+
+        void update_from_parent(const TransformableComponent* parent);
+
+        math::Transform<> _local;
+
+        // True if _transform was set directly and _local needs to be recomputed
+        bool _world_changed = true;
+
+        // True until the transform has been propagated by TransformHierarchySystem
+        bool _dirty = true;
+
         friend class Octree;
         friend class OctreeSystem;
         mutable OctreeNode* _node = nullptr;
@@ -84,6 +106,10 @@ class TransformableComponent final {
         mutable u32 _transform_index = u32(-1);
 };
 
+// Instantiates the prefab once per transform, every entity of an instance is moved by the instance transform.
+// Ids are laid out as returned by ecs::EntityWorld::instantiate.
+core::Vector<ecs::EntityId> instantiate_prefab(ecs::EntityWorld& world, const ecs::PrefabSpawnPlan& plan, core::Span<math::Transform<>> transforms);
+
 }
 
 #endif // YAVE_COMPONENTS_TRANSFORMABLECOMPONENT_H
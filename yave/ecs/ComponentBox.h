@@ -40,6 +40,9 @@ class ComponentBoxBase : NonMovable {
 
         virtual ComponentRuntimeInfo runtime_info() const = 0;
         virtual void add_to(EntityWorld& world, EntityId id, const EntityIdMap& id_map) const = 0;
+
+        // Adds the component to every instance of the plan node, ids are laid out as returned by EntityWorld::instantiate
+        virtual void add_to_instances(EntityWorld& world, const PrefabSpawnPlan& plan, u32 node, core::Span<EntityId> ids) const = 0;
         // virtual void add_or_replace_to(EntityWorld& world, EntityId id) const = 0;
 
         y_serde3_poly_abstract_base(ComponentBoxBase)
@@ -53,6 +56,7 @@ class ComponentBox final : public ComponentBoxBase {
 
         ComponentRuntimeInfo runtime_info() const override;
         void add_to(EntityWorld& world, EntityId id, const EntityIdMap& id_map) const override;
+        void add_to_instances(EntityWorld& world, const PrefabSpawnPlan& plan, u32 node, core::Span<EntityId> ids) const override;
         // void add_or_replace_to(EntityWorld& world, EntityId id) const override;
 
         const T& component() const {
@@ -26,6 +26,8 @@ SOFTWARE.
 #include "SparseComponentSet.h"
 #include "ComponentInspector.h"
 #include "ComponentBox.h"
+#include "QueryCache.h"
+#include "ComponentGroup.h"
 
 #include <y/concurrent/Signal.h>
 
@@ -57,6 +59,10 @@ class ComponentContainerBase : NonMovable {
         virtual void add_if_absent(EntityId id) = 0;
         virtual void remove(EntityId id) = 0;
 
+        virtual void reserve(usize additional) = 0;
+
+        virtual void swap_dense(SparseIdSetBase::index_type a, SparseIdSetBase::index_type b) = 0;
+
 
         virtual void inspect_component(EntityId id, ComponentInspector* inspector) = 0;
 
@@ -77,6 +83,7 @@ class ComponentContainerBase : NonMovable {
 
     protected:
         friend class EntityWorld;
+        friend class ComponentGroup;
 
         ComponentContainerBase(ComponentTypeIndex type_id) : _type_id(type_id) {
         }
@@ -84,11 +91,31 @@ class ComponentContainerBase : NonMovable {
 
         virtual serde3::Result save_state(serde3::WritableArchive& arc) const = 0;
         virtual serde3::Result load_state(serde3::ReadableArchive& arc) = 0;
+        // Takes the components of a container of the same type, used to load into a temporary container first
+        virtual void replace_state(ComponentContainerBase& other) = 0;
+        // post_load only touches the container and can run in parallel, notify_loaded sends the signals
         virtual void post_load() = 0;
+        virtual void notify_loaded() = 0;
+
+        // Single component state, existing components are loaded in place so that state that isn't serialized is kept
+        virtual serde3::Result save_component(EntityId id, serde3::WritableArchive& arc) const = 0;
+        virtual serde3::Result load_component(EntityId id, serde3::ReadableArchive& arc) = 0;
+
 
+        void update_query_caches(EntityId id) {
+            for(QueryCache* cache : _query_caches) {
+                cache->update(id);
+            }
+        }
 
         const ComponentTypeIndex _type_id;
         SparseIdSet _mutated;
+
+        // Caches with a rule on this component type
+        mutable core::Vector<QueryCache*> _query_caches;
+
+        // Group owning this component type, if any
+        ComponentGroup* _group = nullptr;
 };
 
 
@@ -138,8 +165,12 @@ class ComponentContainer final : public ComponentContainerBase {
         void remove(EntityId id) override {
             if(T* comp = _components.try_get(id)) {
                 _on_destroyed.send(id, *comp);
+                if(_group) {
+                    _group->remove(id);
+                }
                 _components.erase(id);
                 _mutated.erase(id);
+                update_query_caches(id);
             }
         }
 
@@ -149,6 +180,14 @@ class ComponentContainer final : public ComponentContainerBase {
             get_or_add(id);
         }
 
+        void reserve(usize additional) override {
+            _components.set_min_capacity(_components.size() + additional);
+        }
+
+        void swap_dense(SparseIdSetBase::index_type a, SparseIdSetBase::index_type b) override {
+            _components.swap_dense(a, b);
+        }
+
         template<typename... Args>
         inline T& add_or_replace(EntityId id, Args&&... args) {
             y_debug_assert(id.is_valid());
@@ -157,7 +196,8 @@ class ComponentContainer final : public ComponentContainerBase {
 
             T* comp = nullptr;
             if(!_components.contains_index(id.index())) {
-                comp = &_components.insert(id, y_fwd(args)...);
+                _components.insert(id, y_fwd(args)...);
+                comp = &added(id);
             } else {
                 comp = &(_components[id] = std::move(T(y_fwd(args)...)));
             }
@@ -172,7 +212,8 @@ class ComponentContainer final : public ComponentContainerBase {
             _mutated.insert(id);
 
             if(!_components.contains_index(id.index())) {
-                T& comp = _components.insert(id);
+                _components.insert(id);
+                T& comp = added(id);
                 _on_created.send(id, comp);
                 return comp;
             } else {
@@ -210,6 +251,15 @@ class ComponentContainer final : public ComponentContainerBase {
     private:
         friend class EntityWorld;
 
+        // Groups can move the component, so it has to be fetched again
+        T& added(EntityId id) {
+            if(_group) {
+                _group->add(id);
+            }
+            update_query_caches(id);
+            return _components[id];
+        }
+
 
         serde3::Result save_state(serde3::WritableArchive& arc) const override {
             return arc.serialize(_components);
@@ -219,13 +269,41 @@ class ComponentContainer final : public ComponentContainerBase {
             return arc.deserialize(_components);
         }
 
+        void replace_state(ComponentContainerBase& other) override {
+            y_debug_assert(other.type_id() == type_id());
+            _components = std::move(static_cast<ComponentContainer<T>&>(other)._components);
+        }
+
         void post_load() override {
-            for(auto&& [id, comp] : _components) {
+            for(const EntityId id : _components.ids()) {
                 _mutated.insert(id);
+            }
+        }
+
+        void notify_loaded() override {
+            for(auto&& [id, comp] : _components) {
                 _on_created.send(id, comp);
             }
         }
 
+        serde3::Result save_component(EntityId id, serde3::WritableArchive& arc) const override {
+            y_debug_assert(_components.contains(id));
+            return arc.serialize(_components[id]);
+        }
+
+        serde3::Result load_component(EntityId id, serde3::ReadableArchive& arc) override {
+            if(T* comp = _components.try_get(id)) {
+                serde3::Result res = arc.deserialize(*comp);
+                _mutated.insert(id);
+                return res;
+            }
+
+            T comp;
+            y_try(arc.deserialize(comp));
+            add_or_replace(id, std::move(comp));
+            return core::Ok(serde3::Success::Full);
+        }
+
 
         SparseComponentSet<T> _components;
 
@@ -0,0 +1,104 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "ComponentGroup.h"
+#include "ComponentContainer.h"
+
+namespace yave {
+namespace ecs {
+
+ComponentGroup::ComponentGroup(core::Vector<ComponentContainerBase*> containers) : _containers(std::move(containers)) {
+    y_always_assert(!_containers.is_empty(), "Empty group");
+    for(ComponentContainerBase* container : _containers) {
+        y_always_assert(!container->_group, "Component type is already owned by a group");
+        container->_group = this;
+    }
+    rebuild();
+}
+
+usize ComponentGroup::size() const {
+    return _size;
+}
+
+bool ComponentGroup::owns(core::Span<ComponentTypeIndex> types) const {
+    if(types.size() != _containers.size()) {
+        return false;
+    }
+    return std::all_of(types.begin(), types.end(), [&](ComponentTypeIndex type) {
+        return std::any_of(_containers.begin(), _containers.end(), [&](const ComponentContainerBase* c) { return c->type_id() == type; });
+    });
+}
+
+bool ComponentGroup::contains(EntityId id) const {
+    return _containers[0]->id_set().dense_index_of(id) < _size;
+}
+
+void ComponentGroup::add(EntityId id) {
+    if(contains(id)) {
+        return;
+    }
+
+    for(const ComponentContainerBase* container : _containers) {
+        if(!container->contains(id)) {
+            return;
+        }
+    }
+
+    for(ComponentContainerBase* container : _containers) {
+        container->swap_dense(container->id_set().dense_index_of(id), SparseIdSetBase::index_type(_size));
+    }
+    ++_size;
+}
+
+void ComponentGroup::remove(EntityId id) {
+    if(!contains(id)) {
+        return;
+    }
+
+    --_size;
+    for(ComponentContainerBase* container : _containers) {
+        container->swap_dense(container->id_set().dense_index_of(id), SparseIdSetBase::index_type(_size));
+    }
+}
+
+void ComponentGroup::rebuild() {
+    y_profile();
+
+    _size = 0;
+
+    const ComponentContainerBase* smallest = _containers[0];
+    for(const ComponentContainerBase* container : _containers) {
+        if(container->id_set().size() < smallest->id_set().size()) {
+            smallest = container;
+        }
+    }
+
+    // Adding reorders the sets
+    const core::Vector<EntityId> ids(smallest->id_set().ids());
+    for(const EntityId id : ids) {
+        add(id);
+    }
+}
+
+}
+}
+
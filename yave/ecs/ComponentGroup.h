@@ -0,0 +1,159 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ECS_COMPONENTGROUP_H
+#define YAVE_ECS_COMPONENTGROUP_H
+
+#include "traits.h"
+#include "SparseComponentSet.h"
+
+namespace yave {
+namespace ecs {
+
+class ComponentContainerBase;
+
+// Owning group: entities that have every owned component are kept at the front of each component array, in the same order.
+// Iterating the group is then a linear walk over parallel arrays.
+// Each component type can only be owned by one group.
+class ComponentGroup : NonMovable {
+    public:
+        ComponentGroup(core::Vector<ComponentContainerBase*> containers);
+
+        usize size() const;
+        bool owns(core::Span<ComponentTypeIndex> types) const;
+
+        // Called after a component of an owned type has been added
+        void add(EntityId id);
+
+        // Called before a component of an owned type is removed
+        void remove(EntityId id);
+
+        void rebuild();
+
+    private:
+        bool contains(EntityId id) const;
+
+        core::Vector<ComponentContainerBase*> _containers;
+        usize _size = 0;
+};
+
+
+template<typename... Args>
+class GroupView {
+    static_assert(sizeof...(Args) > 0);
+    static_assert((traits::component_required_v<Args> && ...), "Groups can not exclude components");
+    static_assert(!(traits::component_changed_v<Args> || ...), "Groups can not filter changed components");
+
+    using set_tuple = std::tuple<SparseComponentSet<traits::component_raw_type_t<Args>>*...>;
+
+    public:
+        using component_tuple = std::tuple<traits::component_type_t<Args>&...>;
+
+        struct IdComponents {
+            EntityId id;
+            component_tuple components;
+        };
+
+    private:
+        template<bool WithId>
+        class Iterator {
+            public:
+                inline Iterator& operator++() {
+                    ++_index;
+                    return *this;
+                }
+
+                inline bool operator==(const Iterator& other) const {
+                    return _index == other._index;
+                }
+
+                inline bool operator!=(const Iterator& other) const {
+                    return _index != other._index;
+                }
+
+                inline auto operator*() const {
+                    if constexpr(WithId) {
+                        return IdComponents{std::get<0>(_sets)->ids()[_index], components(std::index_sequence_for<Args...>{})};
+                    } else {
+                        return components(std::index_sequence_for<Args...>{});
+                    }
+                }
+
+            private:
+                friend class GroupView;
+
+                inline Iterator(usize index, const set_tuple& sets) : _index(index), _sets(sets) {
+                }
+
+                template<usize... I>
+                inline component_tuple components(std::index_sequence<I...>) const {
+                    return component_tuple(std::get<I>(_sets)->values()[_index]...);
+                }
+
+                usize _index = 0;
+                set_tuple _sets;
+        };
+
+    public:
+        using const_iterator = Iterator<true>;
+        using const_component_iterator = Iterator<false>;
+
+        GroupView(const set_tuple& sets, usize size) : _sets(sets), _size(size) {
+        }
+
+        usize size() const {
+            return _size;
+        }
+
+        bool is_empty() const {
+            return !_size;
+        }
+
+        core::Span<EntityId> ids() const {
+            return core::Span<EntityId>(std::get<0>(_sets)->ids().data(), _size);
+        }
+
+        const_iterator begin() const {
+            return const_iterator(0, _sets);
+        }
+
+        const_iterator end() const {
+            return const_iterator(_size, _sets);
+        }
+
+        core::Range<const_iterator> id_components() const {
+            return {begin(), end()};
+        }
+
+        core::Range<const_component_iterator> components() const {
+            return {const_component_iterator(0, _sets), const_component_iterator(_size, _sets)};
+        }
+
+    private:
+        set_tuple _sets;
+        usize _size = 0;
+};
+
+}
+}
+
+#endif // YAVE_ECS_COMPONENTGROUP_H
+
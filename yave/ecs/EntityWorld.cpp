@@ -25,15 +25,38 @@ SOFTWARE.
 #include <y/utils/log.h>
 #include <y/utils/format.h>
 #include <y/utils/memory.h>
+#include <y/utils/memory_tracking.h>
 
 #include <yave/assets/AssetLoadingContext.h>
 
+#include <y/concurrent/StaticThreadPool.h>
+#include <y/io2/Buffer.h>
+
 #include <numeric>
 
 
 namespace yave {
 namespace ecs {
 
+// Written before everything else, worlds saved without it are read with the old sequential layout
+struct WorldStateHeader {
+    static constexpr u32 world_magic = 0x444C5759; // "YWLD"
+    static constexpr u32 current_version = 1;
+
+    u32 magic = 0;
+    u32 version = 0;
+
+    y_reflect(WorldStateHeader, magic, version)
+};
+
+// Each container is saved in its own section so that containers can be (de)serialized in parallel
+struct ContainerSection {
+    core::String type_name;
+    core::Vector<u8> data;
+
+    y_reflect(ContainerSection, type_name, data)
+};
+
 static auto create_component_containers() {
     y_profile();
 
@@ -51,59 +74,67 @@ static auto create_component_containers() {
     return containers;
 }
 
-static EntityId create_prefab_entities(EntityWorld& world, const EntityPrefab& prefab, EntityIdMap& id_map, EntityId base_id = {}) {
+static EntityId add_prefab_scope(EntityWorld& world, const EntityPrefab& prefab, EntityId base_id = {});
+
+// Entities are created depth first, ids are stored in the same order so components can find them without going through the map
+static EntityId create_prefab_entities(EntityWorld& world, const EntityPrefab& prefab, EntityIdMap& id_map, core::Vector<EntityId>& ids, EntityId base_id = {}) {
     y_profile();
 
     y_debug_assert(prefab.original_id().is_valid());
 
     const EntityId id = base_id.is_valid() ? base_id : world.create_entity();
-    y_always_assert(id_map.find(prefab.original_id()) == id_map.end(), "Invalid prefab: id is duplicated");
-    id_map.emplace_back(prefab.original_id(), id);
+    ids << id;
 
-    auto parent_child = [&](const auto& child) {
-        if(child) {
-            world.set_parent(create_prefab_entities(world, *child, id_map), id);
-        }
-    };
+    // The entity is still created, but references resolve to the first entity with that id
+    if(id_map.find(prefab.original_id()) == id_map.end()) {
+        id_map.emplace_back(prefab.original_id(), id);
+    } else {
+        log_msg(fmt("Invalid prefab: id {} is duplicated", prefab.original_id().index()), Log::Warning);
+    }
 
     for(const auto& child : prefab.children()) {
-        parent_child(child);
+        if(child) {
+            world.set_parent(create_prefab_entities(world, *child, id_map, ids), id);
+        }
     }
 
+    // Asset children are prefabs of their own, their ids can collide with ours
     for(const auto& child : prefab.asset_children()) {
-        parent_child(child);
+        if(child) {
+            world.set_parent(add_prefab_scope(world, *child), id);
+        }
     }
 
     return id;
 }
 
-static void add_prefab_components(EntityWorld& world, const EntityPrefab& prefab, const EntityIdMap& id_map) {
+static void add_prefab_components(EntityWorld& world, const EntityPrefab& prefab, const EntityIdMap& id_map, core::Span<EntityId> ids, usize& index) {
     y_profile();
 
-    y_debug_assert(prefab.original_id().is_valid());
-
-    const auto it = id_map.find(prefab.original_id());
-    y_debug_assert(it != id_map.end());
-
+    const EntityId id = ids[index++];
     for(const auto& comp : prefab.components()) {
         if(comp) {
-            comp->add_to(world, it->second, id_map);
+            comp->add_to(world, id, id_map);
         }
     }
 
-    auto add_child_components = [&](const auto& child) {
+    for(const auto& child : prefab.children()) {
         if(child) {
-            add_prefab_components(world, *child, id_map);
+            add_prefab_components(world, *child, id_map, ids, index);
         }
-    };
-
-    for(const auto& child : prefab.children()) {
-        add_child_components(child);
     }
+}
 
-    for(const auto& child : prefab.asset_children()) {
-        add_child_components(child);
-    }
+static EntityId add_prefab_scope(EntityWorld& world, const EntityPrefab& prefab, EntityId base_id) {
+    EntityIdMap id_map;
+    core::Vector<EntityId> ids;
+    const EntityId id = create_prefab_entities(world, prefab, id_map, ids, base_id);
+
+    usize index = 0;
+    add_prefab_components(world, prefab, id_map, ids, index);
+    y_debug_assert(index == ids.size());
+
+    return id;
 }
 
 
@@ -111,6 +142,16 @@ static void add_prefab_components(EntityWorld& world, const EntityPrefab& prefab
 
 
 EntityWorld::EntityWorld() : _containers(create_component_containers()) {
+    for(const auto& container : _containers) {
+        if(container) {
+            const ComponentRuntimeInfo info = container->runtime_info();
+            const Tag tag = Tag(fmt("@{}", info.clean_component_name()));
+            if(const auto [it, inserted] = _component_tags.emplace(tag.id(), container->type_id()); !inserted) {
+                log_msg(fmt("Component tag \"{}\" is ambiguous, use the qualified component name", tag.name()), Log::Warning);
+            }
+            _component_tags.emplace(Tag(fmt("@{}", info.type_name)).id(), container->type_id());
+        }
+    }
 }
 
 EntityWorld::~EntityWorld() {
@@ -123,6 +164,7 @@ EntityWorld::~EntityWorld() {
 
 void EntityWorld::tick() {
     y_profile();
+    y_memory_tag(MemoryTag::Ecs);
 
     {
         y_profile_zone("tick");
@@ -131,6 +173,10 @@ void EntityWorld::tick() {
             y_debug_assert(system->_world == this);
             system->tick();
         }
+
+        for(auto& system : _systems) {
+            system->post_tick();
+        }
     }
 
     {
@@ -140,6 +186,9 @@ void EntityWorld::tick() {
                 container->_mutated.clear();
             }
         }
+
+        evict_unused_query_caches();
+        ++_tick_index;
     }
 
     _entities.audit();
@@ -147,6 +196,7 @@ void EntityWorld::tick() {
 
 void EntityWorld::update(float dt) {
     y_profile();
+    y_memory_tag(MemoryTag::Ecs);
 
     for(auto& system : _systems) {
         y_profile_dyn_zone(system->name().data());
@@ -182,9 +232,46 @@ EntityId EntityWorld::create_entity(const EntityPrefab& prefab) {
 void EntityWorld::add_prefab(EntityId id, const EntityPrefab& prefab) {
     y_profile();
 
-    EntityIdMap id_map;
-    create_prefab_entities(*this, prefab, id_map, id);
-    add_prefab_components(*this, prefab, id_map);
+    add_prefab_scope(*this, prefab, id);
+}
+
+core::Vector<EntityId> EntityWorld::instantiate(const EntityPrefab& prefab, usize count) {
+    return instantiate(PrefabSpawnPlan(prefab), count);
+}
+
+core::Vector<EntityId> EntityWorld::instantiate(const PrefabSpawnPlan& plan, usize count) {
+    y_profile();
+
+    const core::Span<PrefabSpawnPlan::Node> nodes = plan.nodes();
+
+    auto ids = core::Vector<EntityId>::with_capacity(nodes.size() * count);
+
+    {
+        y_profile_zone("create entities");
+        for(usize i = 0; i != nodes.size() * count; ++i) {
+            ids.emplace_back(create_entity());
+        }
+
+        for(usize n = 1; n < nodes.size(); ++n) {
+            const usize parent = nodes[n].parent;
+            y_debug_assert(parent < n);
+            for(usize i = 0; i != count; ++i) {
+                set_parent(ids[n * count + i], ids[parent * count + i]);
+            }
+        }
+    }
+
+    {
+        y_profile_zone("add components");
+        for(const PrefabSpawnPlan::ComponentTypeSpawn& type : plan.component_types()) {
+            find_container(type.type)->reserve(type.components.size() * count);
+            for(const PrefabSpawnPlan::ComponentSpawn& spawn : type.components) {
+                spawn.box->add_to_instances(*this, plan, spawn.node, ids);
+            }
+        }
+    }
+
+    return ids;
 }
 
 void EntityWorld::remove_entity(EntityId id) {
@@ -194,9 +281,15 @@ void EntityWorld::remove_entity(EntityId id) {
 
     _on_destroyed.send(id);
 
+    const auto children = core::Vector<EntityId>::from_range(_entities.children(id));
+
     remove_all_components(id);
     _entities.remove(id);
 
+    for(const EntityId child : children) {
+        _on_parent_changed.send(child);
+    }
+
     // Entities are deleted immediatly, while components linger until the end of tick.
     // This needs to be changed to be made consistent.
     // Deferring entity deletion is problematic as we could add new components to the entity, while it is in limbo
@@ -213,12 +306,15 @@ void EntityWorld::remove_all_components(EntityId id) {
         }
     }
 
-    for(auto& [tag, container] : _tags) {
-        unused(tag);
+    for(auto& container : _tags) {
         if(container.contains(id)) {
             container.erase(id);
         }
     }
+
+    for(auto& cache : _query_caches) {
+        cache->update(id);
+    }
 }
 
 void EntityWorld::remove_all_entities() {
@@ -249,7 +345,12 @@ EntityId EntityWorld::parent(EntityId id) const {
 void EntityWorld::set_parent(EntityId id, EntityId parent_id) {
     y_profile();
 
+    if(_entities.parent(id) == parent_id) {
+        return;
+    }
+
     _entities.set_parent(id, parent_id);
+    _on_parent_changed.send(id);
 }
 
 bool EntityWorld::has_parent(EntityId id) const {
@@ -272,65 +373,87 @@ const SparseIdSet& EntityWorld::recently_mutated(ComponentTypeIndex type_id) con
     return find_container(type_id)->recently_mutated();
 }
 
-core::Span<EntityId> EntityWorld::with_tag(const core::String& tag) const {
+core::Span<EntityId> EntityWorld::with_tag(Tag tag) const {
     const SparseIdSetBase* set = tag_set(tag);
     return set ? set->ids() : core::Span<EntityId>();
 }
 
-const SparseIdSet* EntityWorld::raw_tag_set(const core::String& tag) const {
-    if(const auto it = _tags.find(tag); it != _tags.end()) {
-        return &it->second;
+const SparseIdSet* EntityWorld::raw_tag_set(Tag tag) const {
+    if(tag.id() < _tags.size()) {
+        return &_tags[tag.id()];
     }
     return nullptr;
 }
 
-const SparseIdSetBase* EntityWorld::tag_set(const core::String& tag) const {
-    if(tag.is_empty()) {
+const SparseIdSetBase* EntityWorld::tag_set(Tag tag) const {
+    if(!tag.is_valid()) {
         return nullptr;
     }
 
-    if(tag[0] == '@') {
-        for(const auto& container : _containers) {
-            if(container->runtime_info().clean_component_name() == tag.sub_str(1)) {
-                return &container->id_set();
-            }
-        }
-        return nullptr;
+    if(tag.is_negated()) {
+        y_fatal("'!' tags can't have a set, use queries instead");
     }
 
-    if(tag[0] == '!') {
-        y_fatal("'!' tags can't have a set, use queries instead");
+    if(tag.is_component()) {
+        const ComponentContainerBase* container = find_component_tag_container(tag);
+        return container ? &container->id_set() : nullptr;
     }
 
     return raw_tag_set(tag);
 }
 
-void EntityWorld::add_tag(EntityId id, const core::String& tag) {
+const ComponentContainerBase* EntityWorld::find_component_tag_container(Tag tag) const {
+    y_debug_assert(tag.is_component());
+    if(const auto it = _component_tags.find(tag.id()); it != _component_tags.end()) {
+        return find_container(it->second);
+    }
+    return nullptr;
+}
+
+void EntityWorld::add_tag(EntityId id, Tag tag) {
     check_exists(id);
-    y_always_assert(!is_tag_implicit(tag), "Implicit tags can't be added directly");
-    _tags[tag].insert(id);
+    y_always_assert(!tag.is_implicit(), "Implicit tags can't be added directly");
+    _tags.set_min_size(usize(tag.id()) + 1);
+    _tags[tag.id()].insert(id);
+    update_query_caches(id, tag);
 }
 
-void EntityWorld::remove_tag(EntityId id, const core::String& tag) {
+void EntityWorld::remove_tag(EntityId id, Tag tag) {
     check_exists(id);
-    y_always_assert(!is_tag_implicit(tag), "Implicit tags can't be removed directly");
-    auto& tag_set = _tags[tag];
-    if(tag_set.contains(id)) {
-        tag_set.erase(id);
+    y_always_assert(!tag.is_implicit(), "Implicit tags can't be removed directly");
+    if(tag.id() < _tags.size()) {
+        _tags[tag.id()].erase(id);
+        update_query_caches(id, tag);
     }
 }
 
-void EntityWorld::clear_tag(const core::String& tag) {
-    y_always_assert(!is_tag_implicit(tag), "Implicit tags can't be removed directly");
-    _tags.erase(tag);
+void EntityWorld::clear_tag(Tag tag) {
+    y_always_assert(!tag.is_implicit(), "Implicit tags can't be removed directly");
+    if(tag.id() < _tags.size()) {
+        const core::Vector<EntityId> ids(_tags[tag.id()].ids());
+        _tags[tag.id()].make_empty();
+        for(const EntityId id : ids) {
+            update_query_caches(id, tag);
+        }
+    }
 }
 
-bool EntityWorld::has_tag(EntityId id, const core::String& tag) const {
+bool EntityWorld::has_tag(EntityId id, Tag tag) const {
     check_exists(id);
     const SparseIdSetBase* set = tag_set(tag);
     return set ? set->contains(id) : false;
 }
 
+core::Vector<Tag> EntityWorld::tags() const {
+    core::Vector<Tag> tags;
+    for(usize i = 0; i != _tags.size(); ++i) {
+        if(!_tags[i].is_empty()) {
+            tags.emplace_back(Tag::from_id(u32(i)));
+        }
+    }
+    return tags;
+}
+
 bool EntityWorld::is_tag_implicit(std::string_view tag) {
     return !tag.empty() && (tag[0] == '@' || tag[0] == '!');
 }
@@ -339,6 +462,117 @@ std::string_view EntityWorld::component_type_name(ComponentTypeIndex type_id) co
     return find_container(type_id)->runtime_info().clean_component_name();
 }
 
+std::unique_ptr<ComponentBoxBase> EntityWorld::create_box(EntityId id, ComponentTypeIndex type_id) const {
+    const ComponentContainerBase* container = find_container(type_id);
+    if(!container || !container->contains(id)) {
+        return nullptr;
+    }
+    return container->create_box(id);
+}
+
+void EntityWorld::remove_component(EntityId id, ComponentTypeIndex type_id) {
+    check_exists(id);
+    if(ComponentContainerBase* container = find_container(type_id)) {
+        container->remove(id);
+    }
+}
+
+const QueryCache& EntityWorld::find_or_create_query_cache(core::Vector<QueryCache::Rule> rules) const {
+    // Component tags are turned into component rules so that the cache gets notified by the container
+    for(QueryCache::Rule& rule : rules) {
+        if(rule.is_tag() && rule.tag.is_component()) {
+            if(const ComponentContainerBase* container = find_component_tag_container(rule.tag)) {
+                rule = QueryCache::Rule{container->type_id(), Tag(), rule.include};
+            }
+        }
+    }
+
+    const auto lock = std::unique_lock(_query_cache_lock);
+
+    for(const auto& cache : _query_caches) {
+        const core::Span<QueryCache::Rule> cache_rules = cache->rules();
+        if(std::equal(cache_rules.begin(), cache_rules.end(), rules.begin(), rules.end())) {
+            cache->set_last_used_tick(_tick_index);
+            return *cache;
+        }
+    }
+
+    y_profile_zone("creating query cache");
+
+    for(const QueryCache::Rule& rule : rules) {
+        if(rule.is_tag() && rule.tag.is_component()) {
+            // All containers exist from construction, so this tag will never match anything
+            log_msg(fmt("Unknown component tag \"{}\" in query", rule.tag.name()), Log::Warning);
+        }
+    }
+
+    const auto& cache = _query_caches.emplace_back(std::make_unique<QueryCache>(this, std::move(rules)));
+    cache->set_last_used_tick(_tick_index);
+    for(const QueryCache::Rule& rule : cache->rules()) {
+        if(!rule.is_tag()) {
+            find_container(rule.type)->_query_caches << cache.get();
+        }
+    }
+
+    return *cache;
+}
+
+void EntityWorld::create_group(core::Span<ComponentTypeIndex> types) {
+    y_profile();
+
+    y_always_assert(!find_group(types), "Group already exists");
+
+    auto containers = core::Vector<ComponentContainerBase*>::with_capacity(types.size());
+    for(const ComponentTypeIndex type : types) {
+        containers << find_container(type);
+    }
+
+    _groups.emplace_back(std::make_unique<ComponentGroup>(std::move(containers)));
+}
+
+const ComponentGroup* EntityWorld::find_group(core::Span<ComponentTypeIndex> types) const {
+    for(const auto& group : _groups) {
+        if(group->owns(types)) {
+            return group.get();
+        }
+    }
+    return nullptr;
+}
+
+void EntityWorld::update_query_caches(EntityId id, Tag tag) {
+    for(auto& cache : _query_caches) {
+        if(cache->depends_on(tag)) {
+            cache->update(id);
+        }
+    }
+}
+
+void EntityWorld::evict_unused_query_caches() {
+    y_profile();
+
+    // Queries don't outlive a tick, so nothing can still reference an evicted cache
+    const auto lock = std::unique_lock(_query_cache_lock);
+
+    for(usize i = 0; i != _query_caches.size();) {
+        const QueryCache* cache = _query_caches[i].get();
+        if(_tick_index - cache->last_used_tick() <= query_cache_max_unused_ticks) {
+            ++i;
+            continue;
+        }
+
+        for(const QueryCache::Rule& rule : cache->rules()) {
+            if(!rule.is_tag()) {
+                auto& container_caches = find_container(rule.type)->_query_caches;
+                if(const auto it = std::find(container_caches.begin(), container_caches.end(), cache); it != container_caches.end()) {
+                    container_caches.erase_unordered(it);
+                }
+            }
+        }
+
+        _query_caches.erase_unordered(_query_caches.begin() + i);
+    }
+}
+
 void EntityWorld::make_mutated(ComponentTypeIndex type_id, core::Span<EntityId> ids) {
     y_profile();
     auto& mutated = find_container(type_id)->_mutated;
@@ -378,16 +612,81 @@ void EntityWorld::inspect_components(EntityId id, ComponentInspector* inspector)
 }
 
 
+serde3::Result EntityWorld::save_component(EntityId id, ComponentTypeIndex type_id, serde3::WritableArchive& arc) const {
+    const ComponentContainerBase* container = find_container(type_id);
+    if(!container || !container->contains(id)) {
+        return core::Err(serde3::Error(serde3::ErrorType::UnknownError));
+    }
+    return container->save_component(id, arc);
+}
+
+serde3::Result EntityWorld::load_component(EntityId id, ComponentTypeIndex type_id, serde3::ReadableArchive& arc) {
+    check_exists(id);
+    ComponentContainerBase* container = find_container(type_id);
+    if(!container) {
+        return core::Err(serde3::Error(serde3::ErrorType::UnknownError));
+    }
+    return container->load_component(id, arc);
+}
+
 serde3::Result EntityWorld::save_state(serde3::WritableArchive& arc) const {
     y_profile();
 
+    y_try(arc.serialize(WorldStateHeader{WorldStateHeader::world_magic, WorldStateHeader::current_version}));
     y_try(arc.serialize(_entities));
-    y_try(arc.serialize(_tags));
+
+    {
+        // Tags are saved by name, as ids are only valid for the current run
+        core::FlatHashMap<core::String, SparseIdSet> tags;
+        for(const Tag tag : this->tags()) {
+            SparseIdSet& set = tags[tag.name()];
+            for(const EntityId id : _tags[tag.id()].ids()) {
+                set.insert(id);
+            }
+        }
+        y_try(arc.serialize(tags));
+    }
+
     y_try(arc.serialize(_world_components));
 
-    for(auto&& container : _containers) {
-        if(container) {
-            y_try(container->save_state(arc));
+    {
+        y_profile_zone("containers");
+
+        core::Vector<ContainerSection> sections;
+        for(auto&& container : _containers) {
+            if(container) {
+                sections.emplace_back(container->runtime_info().type_name, core::Vector<u8>());
+            }
+        }
+
+        {
+            concurrent::StaticThreadPool thread_pool;
+            core::Vector<std::future<serde3::Result>> futures;
+
+            usize index = 0;
+            for(auto&& container : _containers) {
+                if(container) {
+                    ContainerSection* section = &sections[index++];
+                    const ComponentContainerBase* cont = container.get();
+                    futures.emplace_back(thread_pool.schedule_with_future([=]() -> serde3::Result {
+                        y_profile_zone("save container");
+                        io2::Buffer buffer;
+                        serde3::WritableArchive section_arc(buffer);
+                        y_try(cont->save_state(section_arc));
+                        section->data = core::Vector<u8>(core::Span<u8>(buffer.data(), buffer.size()));
+                        return core::Ok(serde3::Success::Full);
+                    }));
+                }
+            }
+
+            for(auto& future : futures) {
+                y_try(future.get());
+            }
+        }
+
+        y_try(arc.serialize(u64(sections.size())));
+        for(const ContainerSection& section : sections) {
+            y_try(arc.serialize(section));
         }
     }
 
@@ -395,34 +694,137 @@ serde3::Result EntityWorld::save_state(serde3::WritableArchive& arc) const {
 }
 
 serde3::Result EntityWorld::load_state(serde3::ReadableArchive& arc) {
-    remove_all_entities();
-    _tags.clear();
-    _world_components.clear();
+    y_profile();
+
+    // Everything is loaded into temporaries first so that the world is left untouched if loading fails
+    bool sequential = false;
+    {
+        const usize start = arc.tell();
+        WorldStateHeader header;
+        if(!arc.deserialize(header) || header.magic != WorldStateHeader::world_magic) {
+            // Worlds saved before the header was introduced store containers one after the other
+            arc.seek(start);
+            sequential = true;
+        } else if(header.version != WorldStateHeader::current_version) {
+            return core::Err(serde3::Error(serde3::ErrorType::VersionError));
+        }
+    }
 
-    y_try(arc.deserialize(_entities));
-    y_try(arc.deserialize(_tags));
-    y_try(arc.deserialize(_world_components));
+    EntityPool entities;
+    y_try(arc.deserialize(entities));
 
-    for(auto&& container : _containers) {
-        if(container) {
-            y_try(container->load_state(arc));
+    core::Vector<SparseIdSet> tags;
+    {
+        core::FlatHashMap<core::String, SparseIdSet> named_tags;
+        y_try(arc.deserialize(named_tags));
+        for(auto& [name, set] : named_tags) {
+            const Tag tag(name);
+            tags.set_min_size(usize(tag.id()) + 1);
+            tags[tag.id()] = std::move(set);
+        }
+    }
+
+    core::Vector<std::unique_ptr<WorldComponentContainerBase>> world_components;
+    y_try(arc.deserialize(world_components));
+
+    serde3::Success success = serde3::Success::Full;
+    auto containers = create_component_containers();
+
+    if(sequential) {
+        y_profile_zone("containers");
+        for(auto&& container : containers) {
+            if(container) {
+                y_try(container->load_state(arc));
+            }
         }
+    } else {
+        y_profile_zone("containers");
+
+        u64 section_count = 0;
+        y_try(arc.deserialize(section_count));
+
+        // Sections are decoded as soon as they are read
+        concurrent::StaticThreadPool thread_pool;
+        core::Vector<std::future<serde3::Result>> futures;
+
+        for(u64 i = 0; i != section_count; ++i) {
+            auto section = std::make_shared<ContainerSection>();
+            y_try(arc.deserialize(*section));
+
+            const auto it = std::find_if(containers.begin(), containers.end(), [&](const auto& c) {
+                return c && c->runtime_info().type_name == section->type_name.view();
+            });
+
+            if(it == containers.end()) {
+                log_msg(fmt("Unknown component type \"{}\" was not loaded", section->type_name), Log::Warning);
+                success = serde3::Success::Partial;
+                continue;
+            }
+
+            ComponentContainerBase* container = it->get();
+            const serde3::DeserializationFlags flags = arc.flags();
+            futures.emplace_back(thread_pool.schedule_with_future([=]() -> serde3::Result {
+                y_profile_zone("load container");
+                io2::Buffer buffer(std::move(section->data));
+                serde3::ReadableArchive section_arc(buffer, flags);
+                return container->load_state(section_arc);
+            }));
+        }
+
+        // Wait for every section even on failure, as tasks reference the temporary containers
+        serde3::Result result = core::Ok(serde3::Success::Full);
+        for(auto& future : futures) {
+            serde3::Result r = future.get();
+            if(!r) {
+                result = std::move(r);
+            } else if(r.unwrap() == serde3::Success::Partial) {
+                success = serde3::Success::Partial;
+            }
+        }
+        y_try(result);
     }
 
 
     {
+        y_profile_zone("replace world");
+
+        remove_all_entities();
+
+        _entities = std::move(entities);
+        _tags = std::move(tags);
+        _world_components = std::move(world_components);
+
+        for(usize i = 0; i != containers.size(); ++i) {
+            if(containers[i]) {
+                _containers[i]->replace_state(*containers[i]);
+                _containers[i]->post_load();
+            }
+        }
+    }
+
+    {
+        // Tags have been replaced wholesale
+        for(auto& cache : _query_caches) {
+            cache->rebuild();
+        }
+
+        // Components have been deserialized in place
+        for(auto& group : _groups) {
+            group->rebuild();
+        }
+
         for(const EntityId id : _entities.ids()) {
             _on_created.send(id);
         }
 
         for(auto&& container : _containers) {
             if(container) {
-                container->post_load();
+                container->notify_loaded();
             }
         }
     }
 
-    return core::Ok(serde3::Success::Full);
+    return core::Ok(success);
 }
 
 
@@ -24,7 +24,9 @@ SOFTWARE.
 
 #include "EntityPool.h"
 #include "Query.h"
+#include "QueryCache.h"
 #include "EntityPrefab.h"
+#include "PrefabSpawnPlan.h"
 #include "System.h"
 #include "tags.h"
 
@@ -34,6 +36,8 @@ SOFTWARE.
 #include <y/core/HashMap.h>
 #include <y/core/ScratchPad.h>
 
+#include <mutex>
+
 namespace yave {
 namespace ecs {
 
@@ -53,6 +57,11 @@ class EntityWorld : NonMovable {
 
         void add_prefab(EntityId id, const EntityPrefab& prefab);
 
+        // Creates count copies of the prefab. Ids are grouped by node: ids of node n are [n * count, (n + 1) * count).
+        // Roots come first.
+        core::Vector<EntityId> instantiate(const PrefabSpawnPlan& plan, usize count);
+        core::Vector<EntityId> instantiate(const EntityPrefab& prefab, usize count);
+
         void remove_entity(EntityId id);
         void remove_all_components(EntityId id);
         void remove_all_entities();
@@ -64,13 +73,17 @@ class EntityWorld : NonMovable {
         const SparseIdSetBase& component_ids(ComponentTypeIndex type_id) const;
         const SparseIdSet& recently_mutated(ComponentTypeIndex type_id) const;
 
-        core::Span<EntityId> with_tag(const core::String& tag) const;
-        const SparseIdSetBase* tag_set(const core::String& tag) const;
+        core::Span<EntityId> with_tag(Tag tag) const;
+        const SparseIdSetBase* tag_set(Tag tag) const;
 
         std::string_view component_type_name(ComponentTypeIndex type_id) const;
 
         void make_mutated(ComponentTypeIndex type_id, core::Span<EntityId> ids);
 
+        // Returns null if the entity doesn't have the component or if it can not be copied
+        std::unique_ptr<ComponentBoxBase> create_box(EntityId id, ComponentTypeIndex type_id) const;
+        void remove_component(EntityId id, ComponentTypeIndex type_id);
+
 
 
         // ---------------------------------------- Parent ----------------------------------------
@@ -179,13 +192,13 @@ class EntityWorld : NonMovable {
 
         // ---------------------------------------- Tags ----------------------------------------
 
-        void add_tag(EntityId id, const core::String& tag);
+        void add_tag(EntityId id, Tag tag);
 
-        void remove_tag(EntityId id, const core::String& tag);
+        void remove_tag(EntityId id, Tag tag);
 
-        void clear_tag(const core::String& tag);
+        void clear_tag(Tag tag);
 
-        bool has_tag(EntityId id, const core::String& tag) const;
+        bool has_tag(EntityId id, Tag tag) const;
 
         static bool is_tag_implicit(std::string_view tag);
 
@@ -203,9 +216,7 @@ class EntityWorld : NonMovable {
             return core::Range(TransformIterator(_containers.begin(), tr), _containers.end());
         }
 
-        auto tags() const {
-            return _tags.keys();
-        }
+        core::Vector<Tag> tags() const;
 
         core::Span<std::unique_ptr<System>> systems() const {
            return _systems;
@@ -269,6 +280,10 @@ class EntityWorld : NonMovable {
             return _on_destroyed;
         }
 
+        concurrent::Signal<EntityId>& on_parent_changed() {
+            return _on_parent_changed;
+        }
+
 
         // ---------------------------------------- Component sets ----------------------------------------
 
@@ -287,14 +302,14 @@ class EntityWorld : NonMovable {
         // ---------------------------------------- Queries ----------------------------------------
 
         template<typename... Args>
-        auto query(core::Span<core::String> tags = {}) {
+        auto query(core::Span<Tag> tags = {}) {
             auto q = Query<traits::discard_query_qualifiers_t<Args>...>(component_sets_for_query<Args...>(), build_matches_for_query<Args...>(tags));
             dirty_mutated_containers<Args...>(q.ids());
             return q;
         }
 
         template<typename... Args>
-        auto query(core::Span<core::String> tags = {}) const {
+        auto query(core::Span<Tag> tags = {}) const {
             static_assert((traits::is_component_const_v<Args> && ...));
             auto q = Query<traits::discard_query_qualifiers_t<Args>...>(component_sets_for_query<Args...>(), build_matches_for_query<Args...>(tags));
 
@@ -302,14 +317,14 @@ class EntityWorld : NonMovable {
         }
 
         template<typename... Args>
-        auto query(core::Span<EntityId> ids, core::Span<core::String> tags = {}) {
+        auto query(core::Span<EntityId> ids, core::Span<Tag> tags = {}) {
             auto q = Query<traits::discard_query_qualifiers_t<Args>...>(component_sets_for_query<Args...>(), build_matches_for_query<Args...>(tags), ids);
             dirty_mutated_containers<Args...>(q.ids());
             return q;
         }
 
         template<typename... Args>
-        auto query(core::Span<EntityId> ids, core::Span<core::String> tags = {}) const {
+        auto query(core::Span<EntityId> ids, core::Span<Tag> tags = {}) const {
             static_assert((traits::is_component_const_v<Args> && ...));
             auto q = Query<traits::discard_query_qualifiers_t<Args>...>(component_sets_for_query<Args...>(), build_matches_for_query<Args...>(tags), ids);
 
@@ -318,6 +333,59 @@ class EntityWorld : NonMovable {
 
 
 
+        // ---------------------------------------- Cached queries ----------------------------------------
+
+        // Same as query, but the matching ids are registered once and kept up to date by the world
+        // The returned Query should not outlive the next component or tag addition/removal
+        template<typename... Args>
+        auto cached_query(core::Span<Tag> tags = {}) {
+            const QueryCache& cache = find_or_create_query_cache(query_cache_rules<Args...>(tags));
+            auto q = Query<traits::discard_query_qualifiers_t<Args>...>(component_sets_for_query<Args...>(), cache.ids());
+            dirty_mutated_containers<Args...>(q.ids());
+            return q;
+        }
+
+        template<typename... Args>
+        auto cached_query(core::Span<Tag> tags = {}) const {
+            static_assert((traits::is_component_const_v<Args> && ...));
+            const QueryCache& cache = find_or_create_query_cache(query_cache_rules<Args...>(tags));
+            return Query<traits::discard_query_qualifiers_t<Args>...>(component_sets_for_query<Args...>(), cache.ids());
+        }
+
+
+
+        // ---------------------------------------- Groups ----------------------------------------
+
+        // Entities with all of Args are packed at the front of each component array, see ComponentGroup
+        template<typename... Args>
+        void create_group() {
+            create_group(std::array{type_index<Args>()...});
+        }
+
+        template<typename... Args>
+        bool has_group() const {
+            return find_group(std::array{type_index<traits::component_raw_type_t<Args>>()...});
+        }
+
+        template<typename... Args>
+        auto group() {
+            const ComponentGroup* group = find_group(std::array{type_index<traits::component_raw_type_t<Args>>()...});
+            y_always_assert(group, "Group doesn't exist");
+            auto view = GroupView<Args...>(component_sets_for_query<Args...>(), group->size());
+            dirty_mutated_containers<Args...>(view.ids());
+            return view;
+        }
+
+        template<typename... Args>
+        auto group() const {
+            static_assert((traits::is_component_const_v<Args> && ...));
+            const ComponentGroup* group = find_group(std::array{type_index<traits::component_raw_type_t<Args>>()...});
+            y_always_assert(group, "Group doesn't exist");
+            return GroupView<Args...>(component_sets_for_query<Args...>(), group->size());
+        }
+
+
+
         // ---------------------------------------- Misc ----------------------------------------
 
 
@@ -341,6 +409,10 @@ class EntityWorld : NonMovable {
         serde3::Result save_state(serde3::WritableArchive& arc) const;
         serde3::Result load_state(serde3::ReadableArchive& arc);
 
+        // Saves or restores a single component, loading into an existing component doesn't replace it
+        serde3::Result save_component(EntityId id, ComponentTypeIndex type_id, serde3::WritableArchive& arc) const;
+        serde3::Result load_component(EntityId id, ComponentTypeIndex type_id, serde3::ReadableArchive& arc);
+
 
     private:
         template<typename T>
@@ -379,7 +451,7 @@ class EntityWorld : NonMovable {
         }
 
         template<typename... Args>
-        auto build_matches_for_query(core::Span<core::String> tags) const {
+        auto build_matches_for_query(core::Span<Tag> tags) const {
             constexpr usize container_count = sizeof...(Args);
 
             const std::array<const ComponentContainerBase*, container_count> containers = {
@@ -390,9 +462,9 @@ class EntityWorld : NonMovable {
             QueryUtils::fill_match_array<0, Args...>(matches, containers);
 
             for(usize i = 0; i != tags.size(); ++i) {
-                const bool is_neg = tags[i].starts_with("!");
+                const bool is_neg = tags[i].is_negated();
                 matches[container_count + i] = {
-                    tag_set(is_neg ? core::String(tags[i].sub_str(1)) : tags[i]),
+                    tag_set(is_neg ? tags[i].negated() : tags[i]),
                     !is_neg
                 };
             }
@@ -401,6 +473,26 @@ class EntityWorld : NonMovable {
         }
 
 
+        template<typename... Args>
+        static core::Vector<QueryCache::Rule> query_cache_rules(core::Span<Tag> tags) {
+            static_assert(!(traits::component_changed_v<Args> || ...), "Changed<T> queries can not be cached");
+
+            auto rules = core::Vector<QueryCache::Rule>::with_capacity(sizeof...(Args) + tags.size());
+            (rules.emplace_back(type_index<traits::component_raw_type_t<Args>>(), Tag(), traits::component_required_v<Args>), ...);
+            for(const Tag tag : tags) {
+                rules.emplace_back(ComponentTypeIndex::invalid_index, tag.is_negated() ? tag.negated() : tag, !tag.is_negated());
+            }
+            return rules;
+        }
+
+        const QueryCache& find_or_create_query_cache(core::Vector<QueryCache::Rule> rules) const;
+
+        void create_group(core::Span<ComponentTypeIndex> types);
+        const ComponentGroup* find_group(core::Span<ComponentTypeIndex> types) const;
+        void update_query_caches(EntityId id, Tag tag);
+        void evict_unused_query_caches();
+
+
         template<typename T, typename... Args>
         void dirty_mutated_containers(core::Span<EntityId> mutated) {
             if(mutated.is_empty()) {
@@ -419,7 +511,10 @@ class EntityWorld : NonMovable {
 
 
 
-        const SparseIdSet* raw_tag_set(const core::String& tag) const;
+        const SparseIdSet* raw_tag_set(Tag tag) const;
+
+        // Container matching an "@" tag, or null if the component doesn't exist
+        const ComponentContainerBase* find_component_tag_container(Tag tag) const;
 
         const ComponentContainerBase* find_container(ComponentTypeIndex type_id) const;
         ComponentContainerBase* find_container(ComponentTypeIndex type_id);
@@ -430,7 +525,11 @@ class EntityWorld : NonMovable {
 
 
         core::Vector<std::unique_ptr<ComponentContainerBase>> _containers;
-        core::FlatHashMap<core::String, SparseIdSet> _tags;
+        // Indexed by tag id
+        core::Vector<SparseIdSet> _tags;
+        // "@" tag id to component type, containers are all created with the world so this never changes
+        // Both the short and the fully qualified component names are registered
+        core::FlatHashMap<u32, ComponentTypeIndex> _component_tags;
         EntityPool _entities;
 
         core::Vector<std::unique_ptr<System>> _systems;
@@ -438,6 +537,16 @@ class EntityWorld : NonMovable {
 
         concurrent::Signal<EntityId> _on_created;
         concurrent::Signal<EntityId> _on_destroyed;
+        concurrent::Signal<EntityId> _on_parent_changed;
+
+        // Caches not requested for query_cache_max_unused_ticks ticks are destroyed at the end of tick()
+        static constexpr u64 query_cache_max_unused_ticks = 64;
+
+        mutable core::Vector<std::unique_ptr<QueryCache>> _query_caches;
+        mutable std::mutex _query_cache_lock;
+        u64 _tick_index = 0;
+
+        core::Vector<std::unique_ptr<ComponentGroup>> _groups;
 };
 
 }
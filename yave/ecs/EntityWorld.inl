@@ -88,6 +88,37 @@ void ComponentBox<T>::add_to(EntityWorld& world, EntityId id, const EntityIdMap&
     });
 }
 
+template<typename T>
+void ComponentBox<T>::add_to_instances(EntityWorld& world, const PrefabSpawnPlan& plan, u32 node, core::Span<EntityId> ids) const {
+    y_debug_assert(ids.size() % plan.node_count() == 0);
+
+    const usize count = ids.size() / plan.node_count();
+    const EntityId* node_ids = ids.data() + node * count;
+
+    // Only components referencing entities of the prefab need to be patched per instance
+    const u32 scope = plan.nodes()[node].scope;
+    bool remap = false;
+    reflect::explore_recursive(_component, [&](const auto& m) {
+        if constexpr(std::is_same_v<std::remove_cvref_t<decltype(m)>, EntityId>) {
+            remap |= plan.node_index(m, scope) != PrefabSpawnPlan::invalid_node;
+        }
+    });
+
+    for(usize i = 0; i != count; ++i) {
+        T* comp = world.add_or_replace_component<T>(node_ids[i], _component);
+
+        if(remap) {
+            reflect::explore_recursive(*comp, [&](auto& m) {
+                if constexpr(std::is_same_v<std::remove_cvref_t<decltype(m)>, EntityId>) {
+                    if(const u32 n = plan.node_index(m, scope); n != PrefabSpawnPlan::invalid_node) {
+                        m = ids[n * count + i];
+                    }
+                }
+            });
+        }
+    }
+}
+
 }
 }
 
@@ -0,0 +1,107 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "PrefabSpawnPlan.h"
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+namespace yave {
+namespace ecs {
+
+PrefabSpawnPlan::PrefabSpawnPlan(const EntityPrefab& prefab) {
+    y_profile();
+
+    _node_indices.emplace_back();
+    add_node(prefab, invalid_node, 0);
+}
+
+void PrefabSpawnPlan::add_node(const EntityPrefab& prefab, u32 parent, u32 scope) {
+    y_debug_assert(prefab.original_id().is_valid());
+
+    const u32 index = u32(_nodes.size());
+    _nodes.emplace_back(parent, scope);
+
+    // The entity is still created, but references resolve to the first entity with that id
+    if(!_node_indices[scope].emplace(prefab.original_id(), index).second) {
+        log_msg(fmt("Invalid prefab: id {} is duplicated", prefab.original_id().index()), Log::Warning);
+    }
+
+    for(const auto& comp : prefab.components()) {
+        if(!comp) {
+            continue;
+        }
+
+        const ComponentTypeIndex type = comp->runtime_info().type_id;
+        auto it = std::find_if(_types.begin(), _types.end(), [&](const ComponentTypeSpawn& spawn) { return spawn.type == type; });
+        if(it == _types.end()) {
+            _types.emplace_back(type, core::Vector<ComponentSpawn>());
+            it = _types.end() - 1;
+        }
+        it->components.emplace_back(index, comp.get());
+    }
+
+    for(const auto& child : prefab.children()) {
+        if(child) {
+            add_node(*child, index, scope);
+        }
+    }
+
+    for(const auto& child : prefab.asset_children()) {
+        if(child) {
+            const u32 child_scope = u32(_node_indices.size());
+            _node_indices.emplace_back();
+            add_node(*child, index, child_scope);
+        }
+    }
+}
+
+bool PrefabSpawnPlan::is_empty() const {
+    return _nodes.is_empty();
+}
+
+usize PrefabSpawnPlan::node_count() const {
+    return _nodes.size();
+}
+
+core::Span<PrefabSpawnPlan::Node> PrefabSpawnPlan::nodes() const {
+    return _nodes;
+}
+
+core::Span<PrefabSpawnPlan::ComponentTypeSpawn> PrefabSpawnPlan::component_types() const {
+    return _types;
+}
+
+u32 PrefabSpawnPlan::node_index(EntityId original_id, u32 scope) const {
+    if(scope >= _node_indices.size()) {
+        return invalid_node;
+    }
+
+    const core::FlatHashMap<EntityId, u32>& indices = _node_indices[scope];
+    if(const auto it = indices.find(original_id); it != indices.end()) {
+        return it->second;
+    }
+    return invalid_node;
+}
+
+}
+}
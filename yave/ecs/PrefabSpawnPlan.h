@@ -0,0 +1,81 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ECS_PREFABSPAWNPLAN_H
+#define YAVE_ECS_PREFABSPAWNPLAN_H
+
+#include "EntityPrefab.h"
+
+#include <y/core/HashMap.h>
+
+namespace yave {
+namespace ecs {
+
+// Flattened prefab used to instantiate many copies at once.
+// The plan points into the prefab, which needs to outlive it.
+// Asset children are prefabs of their own: their ids live in a separate scope and can collide with ids of the parent prefab.
+class PrefabSpawnPlan : NonCopyable {
+    public:
+        static constexpr u32 invalid_node = u32(-1);
+
+        struct Node {
+            // Parents always come before their children
+            u32 parent = invalid_node;
+            u32 scope = 0;
+        };
+
+        struct ComponentSpawn {
+            u32 node = invalid_node;
+            const ComponentBoxBase* box = nullptr;
+        };
+
+        struct ComponentTypeSpawn {
+            ComponentTypeIndex type;
+            core::Vector<ComponentSpawn> components;
+        };
+
+        PrefabSpawnPlan() = default;
+        PrefabSpawnPlan(const EntityPrefab& prefab);
+
+        bool is_empty() const;
+
+        usize node_count() const;
+
+        core::Span<Node> nodes() const;
+        core::Span<ComponentTypeSpawn> component_types() const;
+
+        // Returns the node created for the given prefab id in the given scope, or invalid_node
+        u32 node_index(EntityId original_id, u32 scope = 0) const;
+
+    private:
+        void add_node(const EntityPrefab& prefab, u32 parent, u32 scope);
+
+        core::Vector<Node> _nodes;
+        core::Vector<ComponentTypeSpawn> _types;
+
+        // One map per scope
+        core::Vector<core::FlatHashMap<EntityId, u32>> _node_indices;
+};
+
+}
+}
+
+#endif // YAVE_ECS_PREFABSPAWNPLAN_H
@@ -22,18 +22,20 @@ SOFTWARE.
 
 #include "Query.h"
 
+#include <y/core/ScratchPad.h>
+
 #include <y/utils/log.h>
 #include <y/utils/format.h>
 
 namespace yave {
 namespace ecs {
 
-core::Vector<EntityId> QueryUtils::matching(core::Span<SetMatch> matches, core::Span<EntityId> ids) {
+core::FrameVector<EntityId> QueryUtils::matching(core::Span<SetMatch> matches, core::Span<EntityId> ids) {
     y_profile();
 
     Y_TODO(maybe do one set at a time for better cache performance)
 
-    auto match = core::Vector<EntityId>::with_capacity(ids.size());
+    auto match = core::FrameVector<EntityId>::with_capacity(ids.size());
     for(EntityId id : ids) {
         bool matched = true;
         for(usize i = 0; matched && i != matches.size(); ++i) {
@@ -50,6 +52,53 @@ core::Vector<EntityId> QueryUtils::matching(core::Span<SetMatch> matches, core::
     return match;
 }
 
+bool QueryUtils::should_match_bits(core::Span<SetMatch> matches) {
+    if(matches.size() < 2) {
+        return false;
+    }
+
+    y_debug_assert(matches[0].include && matches[0].set);
+
+    // Probing does a sparse lookup per id per set, bits need one word per 64 entity indices per set.
+    // Scanning wins unless the smallest set is very sparse.
+    const SparseIdSetBase& smallest = *matches[0].set;
+    return smallest.size() * 16 >= smallest.index_bits().words().size();
+}
+
+core::FrameVector<EntityId> QueryUtils::matching_bits(core::Span<SetMatch> matches) {
+    y_profile();
+
+    core::ScratchPad<const core::BitSet*> includes(matches.size());
+    core::ScratchPad<const core::BitSet*> excludes(matches.size());
+
+    usize include_count = 0;
+    usize exclude_count = 0;
+    for(const SetMatch& match : matches) {
+        if(match.include) {
+            y_debug_assert(match.set);
+            includes[include_count++] = &match.set->index_bits();
+        } else if(match.set) {
+            excludes[exclude_count++] = &match.set->index_bits();
+        }
+    }
+
+    core::FrameVector<u32> indices;
+    core::BitSet::match(core::Span<const core::BitSet*>(includes.data(), include_count), core::Span<const core::BitSet*>(excludes.data(), exclude_count), indices);
+
+    // Indices are turned back into ids using the smallest set, this also restores the generation
+    const SparseIdSetBase& smallest = *matches[0].set;
+    const core::Span<EntityId> smallest_ids = smallest.ids();
+
+    auto match = core::FrameVector<EntityId>::with_capacity(indices.size());
+    for(const u32 index : indices) {
+        match.push_back(smallest_ids[smallest.dense_index_of(index)]);
+    }
+
+    y_profile_msg(fmt_c_str("{} id matched", match.size()));
+
+    return match;
+}
+
 }
 }
 
@@ -25,6 +25,8 @@ SOFTWARE.
 #include "traits.h"
 #include "ComponentContainer.h"
 
+#include <y/core/FrameArena.h>
+
 #include <y/utils/iter.h>
 
 #include <y/utils/log.h>
@@ -76,7 +78,12 @@ struct QueryUtils {
         }
     };
 
-    static core::Vector<EntityId> matching(core::Span<SetMatch> matches, core::Span<EntityId> ids);
+    // Matched ids live in the frame arena, queries are not meant to be kept across frames
+    static core::FrameVector<EntityId> matching(core::Span<SetMatch> matches, core::Span<EntityId> ids);
+
+    // Matches using the sets' index bits, matches must be sorted and start with the smallest inclusive set
+    static core::FrameVector<EntityId> matching_bits(core::Span<SetMatch> matches);
+    static bool should_match_bits(core::Span<SetMatch> matches);
 
     template<usize I = 0, typename... Args>
     static void fill_match_array(core::MutableSpan<SetMatch> matches, const std::array<const ComponentContainerBase*, sizeof...(Args)>& containers, bool only_changed = true) {
@@ -254,30 +261,30 @@ class Query : NonCopyable {
         using const_component_iterator = LazyIterator<ComponentsReturnPolicy>;
 
         const_iterator begin() const {
-            return const_iterator(_ids.begin(), _sets);
+            return const_iterator(matched_ids().begin(), _sets);
         }
 
         const_iterator end() const {
-            return const_iterator(_ids.end(), _sets);
+            return const_iterator(matched_ids().end(), _sets);
         }
 
         const_component_iterator components_begin() const {
-            return const_component_iterator(_ids.begin(), _sets);
+            return const_component_iterator(matched_ids().begin(), _sets);
         }
 
         const_component_iterator components_end() const {
-            return const_component_iterator(_ids.end(), _sets);
+            return const_component_iterator(matched_ids().end(), _sets);
         }
 #else
         using const_iterator = VecIterator<IdComponentsReturnPolicy>;
         using const_component_iterator = typename core::Vector<component_tuple>::const_iterator;
 
         const_iterator begin() const {
-            return const_iterator(0, _ids.data(), _components.data());
+            return const_iterator(0, matched_ids().data(), _components.data());
         }
 
         const_iterator end() const {
-            return const_iterator(_ids.size(), _ids.data(), _components.data());
+            return const_iterator(matched_ids().size(), matched_ids().data(), _components.data());
         }
 
         const_component_iterator components_begin() const {
@@ -292,11 +299,11 @@ class Query : NonCopyable {
 
 
         usize size() const {
-            return _ids.size();
+            return matched_ids().size();
         }
 
         bool is_empty() const {
-            return _ids.is_empty();
+            return matched_ids().is_empty();
         }
 
         // These have lifetime problems when writing:
@@ -313,11 +320,11 @@ class Query : NonCopyable {
         }
 
         core::Span<EntityId> ids() & {
-            return _ids;
+            return matched_ids();
         }
 
         core::Vector<EntityId> ids() && {
-            return std::move(_ids);
+            return core::Vector<EntityId>(matched_ids());
         }
 
     private:
@@ -327,7 +334,11 @@ class Query : NonCopyable {
             if(!matches.is_empty() && std::all_of(matches.begin(), matches.end(), [](auto match) { return !match.is_empty(); })) {
                 std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) { return a.sorting_key() < b.sorting_key(); });
                 y_always_assert(matches[0].include, "Query needs at least one inclusive matching rule");
-                _ids = QueryUtils::matching(core::Span<QueryUtils::SetMatch>(matches.begin() + 1, matches.size() - 1), matches[0].ids());
+                if(QueryUtils::should_match_bits(matches)) {
+                    _ids = QueryUtils::matching_bits(matches);
+                } else {
+                    _ids = QueryUtils::matching(core::Span<QueryUtils::SetMatch>(matches.begin() + 1, matches.size() - 1), matches[0].ids());
+                }
             }
             fill_components_array();
         }
@@ -340,16 +351,26 @@ class Query : NonCopyable {
             fill_components_array();
         }
 
+        // Iterates the ids of a QueryCache directly, without copying them
+        Query(const set_tuple& sets, const SparseIdSetBase& cached) : _sets(sets), _cached(&cached) {
+            fill_components_array();
+        }
+
+        core::Span<EntityId> matched_ids() const {
+            return _cached ? _cached->ids() : core::Span<EntityId>(_ids);
+        }
+
     private:
 #if defined(USE_LAZY_QUERY)
         void fill_components_array() {}
 #else
         void fill_components_array() {
             y_profile();
-            _components.set_min_capacity(_ids.size());
+            const core::Span<EntityId> ids = matched_ids();
+            _components.set_min_capacity(ids.size());
 
             using iterator_t = LazyIterator<ComponentsReturnPolicy>;
-            const auto lazy_components = core::Range<iterator_t>(iterator_t(_ids.begin(), _sets), iterator_t(_ids.end(), _sets));
+            const auto lazy_components = core::Range<iterator_t>(iterator_t(ids.begin(), _sets), iterator_t(ids.end(), _sets));
             for(auto&& comps : lazy_components) {
                 _components.emplace_back(comps);
             }
@@ -360,7 +381,8 @@ class Query : NonCopyable {
 
         set_tuple _sets;
 
-        core::Vector<EntityId> _ids;
+        core::FrameVector<EntityId> _ids;
+        const SparseIdSetBase* _cached = nullptr;
 
 
 };
@@ -0,0 +1,107 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "QueryCache.h"
+#include "EntityWorld.h"
+
+namespace yave {
+namespace ecs {
+
+QueryCache::QueryCache(const EntityWorld* world, core::Vector<Rule> rules) : _world(world), _rules(std::move(rules)) {
+    y_always_assert(std::any_of(_rules.begin(), _rules.end(), [](const Rule& r) { return r.include; }), "Query needs at least one inclusive matching rule");
+    rebuild();
+}
+
+core::Span<QueryCache::Rule> QueryCache::rules() const {
+    return _rules;
+}
+
+bool QueryCache::depends_on(Tag tag) const {
+    return std::any_of(_rules.begin(), _rules.end(), [&](const Rule& r) { return r.tag == tag; });
+}
+
+const SparseIdSet& QueryCache::ids() const {
+    return _ids;
+}
+
+u64 QueryCache::last_used_tick() const {
+    return _last_used_tick;
+}
+
+void QueryCache::set_last_used_tick(u64 tick) const {
+    _last_used_tick = tick;
+}
+
+void QueryCache::update(EntityId id) {
+    if(matches(id)) {
+        _ids.insert(id);
+    } else {
+        _ids.erase(id);
+    }
+}
+
+void QueryCache::rebuild() {
+    y_profile();
+
+    _ids.make_empty();
+
+    const SparseIdSetBase* smallest = nullptr;
+    for(const Rule& rule : _rules) {
+        if(!rule.include) {
+            continue;
+        }
+
+        const SparseIdSetBase* set = rule_set(rule);
+        if(!set || set->is_empty()) {
+            return;
+        }
+
+        if(!smallest || set->size() < smallest->size()) {
+            smallest = set;
+        }
+    }
+
+    y_debug_assert(smallest);
+    for(const EntityId id : smallest->ids()) {
+        if(matches(id)) {
+            _ids.insert(id);
+        }
+    }
+}
+
+const SparseIdSetBase* QueryCache::rule_set(const Rule& rule) const {
+    return rule.is_tag() ? _world->tag_set(rule.tag) : &_world->component_ids(rule.type);
+}
+
+bool QueryCache::matches(EntityId id) const {
+    for(const Rule& rule : _rules) {
+        const SparseIdSetBase* set = rule_set(rule);
+        if((set && set->contains(id)) != rule.include) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+}
+
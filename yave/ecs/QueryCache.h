@@ -0,0 +1,77 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ECS_QUERYCACHE_H
+#define YAVE_ECS_QUERYCACHE_H
+
+#include "SparseComponentSet.h"
+#include "tags.h"
+
+namespace yave {
+namespace ecs {
+
+// Persistent match list for a query.
+// Created by EntityWorld::cached_query and kept up to date when components or tags are added or removed,
+// so iterating it doesn't require matching every id again.
+class QueryCache : NonMovable {
+    public:
+        struct Rule {
+            ComponentTypeIndex type = ComponentTypeIndex::invalid_index;
+            Tag tag;
+            bool include = true;
+
+            bool is_tag() const {
+                return tag.is_valid();
+            }
+
+            bool operator==(const Rule&) const = default;
+        };
+
+        QueryCache(const EntityWorld* world, core::Vector<Rule> rules);
+
+        core::Span<Rule> rules() const;
+        bool depends_on(Tag tag) const;
+
+        const SparseIdSet& ids() const;
+
+        void update(EntityId id);
+        void rebuild();
+
+        // World tick at which the cache was last requested, used to evict unused caches
+        u64 last_used_tick() const;
+        void set_last_used_tick(u64 tick) const;
+
+    private:
+        const SparseIdSetBase* rule_set(const Rule& rule) const;
+        bool matches(EntityId id) const;
+
+        const EntityWorld* _world = nullptr;
+        core::Vector<Rule> _rules;
+        SparseIdSet _ids;
+
+        mutable u64 _last_used_tick = 0;
+};
+
+}
+}
+
+#endif // YAVE_ECS_QUERYCACHE_H
+
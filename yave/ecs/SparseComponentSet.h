@@ -25,6 +25,7 @@ SOFTWARE.
 #include "ecs.h"
 
 #include <y/core/Vector.h>
+#include <y/core/BitSet.h>
 #include <y/core/Range.h>
 #include <y/utils/traits.h>
 
@@ -77,6 +78,11 @@ class SparseIdSetBase : NonCopyable {
             return size() < other.size() ? *this : other;
         }
 
+        // One bit per entity index, used for bulk query matching
+        const core::BitSet& index_bits() const {
+            return _bits;
+        }
+
     protected:
         void grow_sparse(index_type max_index) {
             _sparse.set_min_size(usize(max_index + 1), invalid_index);
@@ -84,6 +90,7 @@ class SparseIdSetBase : NonCopyable {
 
         core::Vector<EntityId> _dense;
         core::Vector<index_type> _sparse;
+        core::BitSet _bits;
 };
 
 
@@ -99,6 +106,7 @@ class SparseIdSet : public SparseIdSetBase {
 
                 _sparse[index] = index_type(_dense.size());
                 _dense.emplace_back(id);
+                _bits.set(index);
             }
         }
 
@@ -123,6 +131,7 @@ class SparseIdSet : public SparseIdSetBase {
             const index_type last_sparse_index = last.index();
             _sparse[last_sparse_index] = dense_index;
             _sparse[index] = invalid_index;
+            _bits.reset(index);
 
             y_debug_assert(!contains(id));
 
@@ -132,11 +141,13 @@ class SparseIdSet : public SparseIdSetBase {
         void clear() {
             _sparse.clear();
             _dense.clear();
+            _bits.clear();
         }
 
         void make_empty() {
             _sparse.make_empty();
             _dense.make_empty();
+            _bits.make_empty();
         }
 
         auto begin() const {
@@ -199,6 +210,12 @@ class SparseComponentSetBase : public SparseIdSetBase {
                     return *this;
                 }
 
+                inline PairIterator operator--() {
+                    --_id;
+                    --_value;
+                    return *this;
+                }
+
                 inline PairIterator operator++(int) {
                     const PairIterator it = *this;
                     operator++();
@@ -262,6 +279,7 @@ class SparseComponentSetBase : public SparseIdSetBase {
             _sparse[index] = index_type(_dense.size());
             _dense.emplace_back(id);
             _values.emplace_back(y_fwd(args)...);
+            _bits.set(index);
 
             audit();
 
@@ -295,6 +313,7 @@ class SparseComponentSetBase : public SparseIdSetBase {
             const index_type last_sparse_index = last.index();
             _sparse[last_sparse_index] = dense_index;
             _sparse[index] = invalid_index;
+            _bits.reset(index);
 
             audit();
 
@@ -332,6 +351,21 @@ class SparseComponentSetBase : public SparseIdSetBase {
             return pi < _values.size() ? &_values[pi] : nullptr;
         }
 
+        // Swaps the dense positions of two components, ids are unchanged
+        void swap_dense(index_type a, index_type b) {
+            y_debug_assert(a < _dense.size() && b < _dense.size());
+            if(a == b) {
+                return;
+            }
+
+            std::swap(_dense[a], _dense[b]);
+            std::swap(_values[a], _values[b]);
+            _sparse[_dense[a].index()] = a;
+            _sparse[_dense[b].index()] = b;
+
+            audit();
+        }
+
         void set_min_capacity(usize cap) {
             _values.set_min_capacity(cap);
             _dense.set_min_capacity(cap);
@@ -341,6 +375,7 @@ class SparseComponentSetBase : public SparseIdSetBase {
             _values.clear();
             _dense.clear();
             _sparse.clear();
+            _bits.clear();
             audit();
         }
 
@@ -350,6 +385,7 @@ class SparseComponentSetBase : public SparseIdSetBase {
                 _values.swap(v._values);
                 _dense.swap(v._dense);
                 _sparse.swap(v._sparse);
+                _bits.swap(v._bits);
             }
             audit();
         }
@@ -44,6 +44,11 @@ class System : public NonMovable {
             // nothing
         }
 
+        // Called once every system has ticked, before the world resets mutation tracking
+        virtual void post_tick() {
+            // nothing
+        }
+
         virtual void update(float dt) {
             unused(dt);
             // nothing
@@ -0,0 +1,99 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "tags.h"
+
+#include <y/core/Vector.h>
+#include <y/core/HashMap.h>
+
+#include <mutex>
+#include <memory>
+
+namespace yave {
+namespace ecs {
+
+class TagRegistry : NonMovable {
+    public:
+        static TagRegistry& instance() {
+            static TagRegistry registry;
+            return registry;
+        }
+
+        u32 intern(std::string_view name) {
+            const auto lock = std::unique_lock(_lock);
+
+            if(const auto it = _ids.find(name); it != _ids.end()) {
+                return it->second;
+            }
+
+            const u32 id = u32(_names.size());
+            _names.emplace_back(std::make_unique<core::String>(name));
+            _ids.emplace(*_names.last(), id);
+            return id;
+        }
+
+        const core::String& name(u32 id) {
+            const auto lock = std::unique_lock(_lock);
+            y_debug_assert(id < _names.size());
+            return *_names[id];
+        }
+
+    private:
+        std::mutex _lock;
+        core::FlatHashMap<core::String, u32> _ids;
+        core::Vector<std::unique_ptr<core::String>> _names;
+};
+
+
+Tag::Tag(std::string_view name) {
+    _negated = !name.empty() && name[0] == '!';
+    if(_negated) {
+        name = name.substr(1);
+    }
+    _component = !name.empty() && name[0] == '@';
+    _id = TagRegistry::instance().intern(name);
+}
+
+Tag::Tag(const core::String& name) : Tag(name.view()) {
+}
+
+Tag::Tag(const char* name) : Tag(std::string_view(name)) {
+}
+
+Tag Tag::from_id(u32 id) {
+    Tag tag;
+    tag._id = id;
+
+    const core::String& name = tag.name();
+    tag._component = !name.is_empty() && name[0] == '@';
+
+    return tag;
+}
+
+const core::String& Tag::name() const {
+    static const core::String empty;
+    return is_valid() ? TagRegistry::instance().name(_id) : empty;
+}
+
+}
+}
+
@@ -28,11 +28,65 @@ SOFTWARE.
 
 namespace yave {
 namespace ecs {
+
+// Tags are interned to compact ids the first time they are used, so that they can be resolved once and reused.
+// "!" tags match entities without the tag, "@" tags match entities that have the named component.
+class Tag {
+    public:
+        static constexpr u32 invalid_id = u32(-1);
+
+        Tag() = default;
+
+        Tag(std::string_view name);
+        Tag(const core::String& name);
+        Tag(const char* name);
+
+        static Tag from_id(u32 id);
+
+        u32 id() const {
+            return _id;
+        }
+
+        bool is_valid() const {
+            return _id != invalid_id;
+        }
+
+        bool is_negated() const {
+            return _negated;
+        }
+
+        bool is_component() const {
+            return _component;
+        }
+
+        bool is_implicit() const {
+            return _negated || is_component();
+        }
+
+        Tag negated() const {
+            Tag tag = *this;
+            tag._negated = !_negated;
+            return tag;
+        }
+
+        // Name without the "!"
+        const core::String& name() const;
+
+        bool operator==(const Tag& other) const = default;
+
+    private:
+        u32 _id = invalid_id;
+        bool _negated = false;
+
+        // Cached when the tag is created, so that checking doesn't need to look the name up
+        bool _component = false;
+};
+
 namespace tags {
 
 #define DECLARE_TAG(tag)                                \
-static const core::String tag = #tag;                   \
-static const core::String not_##tag = "!"#tag;
+static const Tag tag = Tag(#tag);                       \
+static const Tag not_##tag = tag.negated();
 
 
 
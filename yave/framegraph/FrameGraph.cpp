@@ -29,6 +29,8 @@ SOFTWARE.
 #include <yave/utils/color.h>
 
 #include <y/core/ScratchPad.h>
+#include <y/core/FrameArena.h>
+#include <y/utils/memory_tracking.h>
 #include <y/utils/log.h>
 #include <y/utils/format.h>
 
@@ -193,6 +195,8 @@ void FrameGraph::end_region(usize index) {
 
 void FrameGraph::render(CmdBufferRecorder& recorder, CmdTimingRecorder* time_rec) {
     y_profile();
+    y_memory_tag(MemoryTag::FrameGraph);
+
     Y_TODO(Pass culling)
     Y_TODO(Ensure that pass are always recorded in order)
 
@@ -256,9 +260,9 @@ void FrameGraph::render(CmdBufferRecorder& recorder, CmdTimingRecorder* time_rec
     std::sort(_image_clears.begin(), _image_clears.end(), [&](const auto& a, const auto& b) { return a.pass_index < b.pass_index; });
 
     using hash_t = std::hash<FrameGraphResourceId>;
-    core::FlatHashMap<FrameGraphBufferId, PipelineStage, hash_t> buffers_to_barrier;
-    core::FlatHashMap<FrameGraphVolumeId, PipelineStage, hash_t> volumes_to_barrier;
-    core::FlatHashMap<FrameGraphImageId, PipelineStage, hash_t> images_to_barrier;
+    core::FrameHashMap<FrameGraphBufferId, PipelineStage, hash_t> buffers_to_barrier;
+    core::FrameHashMap<FrameGraphVolumeId, PipelineStage, hash_t> volumes_to_barrier;
+    core::FrameHashMap<FrameGraphImageId, PipelineStage, hash_t> images_to_barrier;
     buffers_to_barrier.set_min_capacity(_buffers.size());
     volumes_to_barrier.set_min_capacity(_volumes.size());
     images_to_barrier.set_min_capacity(_images.size());
@@ -475,6 +479,7 @@ FrameGraphMutableBufferId FrameGraph::declare_buffer(u64 byte_size) {
 }
 
 FrameGraphPass* FrameGraph::create_pass(std::string_view name) {
+    y_memory_tag(MemoryTag::FrameGraph);
     auto pass = std::make_unique<FrameGraphPass>(name, this, ++_pass_index);
     FrameGraphPass* ptr = pass.get();
      _passes << std::move(pass);
@@ -616,8 +621,15 @@ static auto& alloc_prev(C& c, T new_res, U persistent_id) {
 }
 
 FrameGraphImageId FrameGraph::make_persistent_and_get_prev(FrameGraphImageId res, FrameGraphPersistentResourceId persistent_id) {
+    set_persistent(res, persistent_id);
+    return get_prev_image(persistent_id);
+}
+
+void FrameGraph::set_persistent(FrameGraphImageId res, FrameGraphPersistentResourceId persistent_id) {
     make_persistent(_images, _persistents, res, persistent_id);
+}
 
+FrameGraphImageId FrameGraph::get_prev_image(FrameGraphPersistentResourceId persistent_id) {
     if(!_resources->has_prev_image(persistent_id)) {
         return {};
     }
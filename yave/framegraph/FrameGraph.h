@@ -130,6 +130,10 @@ class FrameGraph : NonMovable {
         FrameGraphImageId make_persistent_and_get_prev(FrameGraphImageId res, FrameGraphPersistentResourceId persistent_id);
         FrameGraphBufferId make_persistent_and_get_prev(FrameGraphBufferId res, FrameGraphPersistentResourceId persistent_id);
 
+        // For resources that are read before being written in the frame
+        FrameGraphImageId get_prev_image(FrameGraphPersistentResourceId persistent_id);
+        void set_persistent(FrameGraphImageId res, FrameGraphPersistentResourceId persistent_id);
+
         math::Vec2ui image_size(FrameGraphImageId res) const;
         math::Vec3ui volume_size(FrameGraphVolumeId res) const;
 
@@ -26,7 +26,7 @@ SOFTWARE.
 #include <yave/graphics/commands/CmdBufferRecorder.h>
 #include <yave/graphics/buffers/Buffer.h>
 #include <yave/graphics/device/DeviceProperties.h>
-#include <yave/graphics/device/extensions/DebugUtils.h>
+#include <yave/graphics/graphics.h>
 
 #include <y/utils/memory.h>
 
@@ -66,13 +66,7 @@ u32 FrameGraphFrameResources::create_buffer_id() {
 
 void FrameGraphFrameResources::init_staging_buffer() {
     if(_staging_buffer_len) {
-        _staging_buffer = StagingBuffer(_staging_buffer_len);
-
-#ifdef Y_DEBUG
-        if(const auto* debug = debug_utils()) {
-            debug->set_resource_name(_staging_buffer.vk_buffer(), "Frame graph staging buffer");
-        }
-#endif
+        _staging_buffer = upload_ring_buffer().alloc(_staging_buffer_len);
     }
 }
 
@@ -275,7 +269,7 @@ StagingSubBuffer FrameGraphFrameResources::staging_buffer(FrameGraphMutableBuffe
 
 StagingSubBuffer FrameGraphFrameResources::staging_buffer(const BufferData& buffer) const {
     y_debug_assert(buffer.is_mapped());
-    return StagingSubBuffer(_staging_buffer, buffer.buffer->byte_size(), buffer.staging_buffer_offset);
+    return StagingSubBuffer(_staging_buffer.buffer(), buffer.buffer->byte_size(), buffer.staging_buffer_offset);
 }
 
 
@@ -28,6 +28,7 @@ SOFTWARE.
 
 #include <yave/graphics/barriers/Barrier.h>
 #include <yave/graphics/buffers/Buffer.h>
+#include <yave/graphics/device/UploadRingBuffer.h>
 
 #include <y/core/Vector.h>
 #include <y/core/HashMap.h>
@@ -145,7 +146,7 @@ class FrameGraphFrameResources final : NonMovable {
         std::deque<std::pair<TransientVolume, FrameGraphPersistentResourceId>> _volume_storage;
         std::deque<std::pair<TransientBuffer, FrameGraphPersistentResourceId>> _buffer_storage;
 
-        StagingBuffer _staging_buffer;
+        UploadAllocation _staging_buffer;
         u64 _staging_buffer_len = 0;
 };
 
@@ -108,7 +108,9 @@ void FrameGraphPassBuilderBase::add_input_usage(FrameGraphImageId res, ImageUsag
 }
 
 void FrameGraphPassBuilderBase::add_input_usage(FrameGraphBufferId res, BufferUsage usage) {
-    add_to_pass(res, usage, false, PipelineStage::None);
+    // Indirect buffers need to be barriered against the indirect command read
+    const bool is_indirect = (usage & BufferUsage::IndirectBit) != BufferUsage::None;
+    add_to_pass(res, usage, false, is_indirect ? PipelineStage::DrawIndirectBit : PipelineStage::None);
 }
 
 void FrameGraphPassBuilderBase::add_output_usage(FrameGraphMutableImageId res, ImageUsage usage) {
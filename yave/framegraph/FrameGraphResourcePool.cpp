@@ -255,5 +255,26 @@ u64 FrameGraphResourcePool::frame_id() const {
     return _frame_id;
 }
 
+u64 FrameGraphResourcePool::allocated_byte_size() const {
+    u64 size = 0;
+    auto add_sizes = [&](auto&& resources) {
+        for(const auto& res : resources) {
+            if constexpr(requires { res.first; }) {
+                size += res.first.device_memory().vk_size();
+            } else {
+                size += res.device_memory().vk_size();
+            }
+        }
+    };
+
+    _images.locked(add_sizes);
+    _volumes.locked(add_sizes);
+    _buffers.locked(add_sizes);
+    _persistent_images.locked(add_sizes);
+    _persistent_buffers.locked(add_sizes);
+
+    return size;
+}
+
 }
 
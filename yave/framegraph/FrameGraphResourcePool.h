@@ -57,6 +57,9 @@ class FrameGraphResourcePool : NonMovable {
 
         u64 frame_id() const;
 
+        // Device memory of the resources owned by the pool, resources currently used by a frame graph are not included
+        u64 allocated_byte_size() const;
+
     private:
         bool create_image_from_pool(TransientImage& res, ImageFormat format, const math::Vec2ui& size, ImageUsage usage);
         bool create_volume_from_pool(TransientVolume& res, ImageFormat format, const math::Vec3ui& size, ImageUsage usage);
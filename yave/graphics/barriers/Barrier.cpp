@@ -72,6 +72,9 @@ static VkAccessFlags vk_dst_access_flags(PipelineStage dst) {
         case PipelineStage::HostBit:
             return VK_ACCESS_HOST_READ_BIT;
 
+        case PipelineStage::DrawIndirectBit:
+            return VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
         /*case PipelineStage::VertexInputBit:
             return VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;*/
 
@@ -125,6 +128,9 @@ static VkPipelineStageFlags vk_barrier_stage(VkAccessFlags access) {
     if(access & (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT)) {
         return VK_PIPELINE_STAGE_TRANSFER_BIT;
     }
+    if(access & VK_ACCESS_INDIRECT_COMMAND_READ_BIT) {
+        return VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+    }
     if(access & (VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT)) {
         return VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
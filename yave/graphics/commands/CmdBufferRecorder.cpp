@@ -38,6 +38,8 @@ SOFTWARE.
 
 #include <y/core/ScratchPad.h>
 
+#include <atomic>
+
 
 namespace yave {
 
@@ -115,11 +117,12 @@ RenderPassRecorder::~RenderPassRecorder() {
 
 void RenderPassRecorder::bind_material_template(const MaterialTemplate* material_template, core::Span<DescriptorSetBase> sets, bool bind_main_ds) {
     if(material_template != _cache.material) {
-        const GraphicPipeline& pipeline = material_template->compile(*_cmd_buffer._render_pass);
-        vkCmdBindPipeline(vk_cmd_buffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.vk_pipeline());
+        // The handles stay valid even if the pipeline is discarded: destruction is deferred until the command buffer completes
+        const auto pipeline = material_template->compile(*_cmd_buffer._render_pass);
+        vkCmdBindPipeline(vk_cmd_buffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline());
 
         _cache.material = material_template;
-        _cache.pipeline_layout = pipeline.vk_pipeline_layout();
+        _cache.pipeline_layout = pipeline->vk_pipeline_layout();
     }
 
     if(_main_descriptor_set && bind_main_ds) {
@@ -153,12 +156,27 @@ void RenderPassRecorder::set_main_descriptor_set(DescriptorSetBase ds_set) {
     _main_descriptor_set = ds_set.vk_descriptor_set();
 }
 
+static std::atomic<u64> draw_call_count = 0;
+static std::atomic<u64> indirect_draw_count = 0;
+static std::atomic<u64> triangle_count = 0;
+
+RenderPassRecorder::DrawStats RenderPassRecorder::reset_draw_stats() {
+    DrawStats stats;
+    stats.draw_calls = draw_call_count.exchange(0, std::memory_order_relaxed);
+    stats.indirect_draws = indirect_draw_count.exchange(0, std::memory_order_relaxed);
+    stats.triangles = triangle_count.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
 void RenderPassRecorder::draw(const MeshDrawData& draw_data, u32 instance_count, u32 instance_index) {
     bind_mesh_buffers(draw_data.mesh_buffers());
     draw(draw_data.draw_command().vk_indirect_data(instance_index, instance_count));
 }
 
 void RenderPassRecorder::draw(const VkDrawIndexedIndirectCommand& indirect) {
+    draw_call_count.fetch_add(1, std::memory_order_relaxed);
+    triangle_count.fetch_add(u64(indirect.indexCount / 3) * indirect.instanceCount, std::memory_order_relaxed);
+
     vkCmdDrawIndexed(vk_cmd_buffer(),
         indirect.indexCount,
         indirect.instanceCount,
@@ -169,6 +187,9 @@ void RenderPassRecorder::draw(const VkDrawIndexedIndirectCommand& indirect) {
 }
 
 void RenderPassRecorder::draw(const VkDrawIndirectCommand& indirect) {
+    draw_call_count.fetch_add(1, std::memory_order_relaxed);
+    triangle_count.fetch_add(u64(indirect.vertexCount / 3) * indirect.instanceCount, std::memory_order_relaxed);
+
     vkCmdDraw(vk_cmd_buffer(),
         indirect.vertexCount,
         indirect.instanceCount,
@@ -177,6 +198,43 @@ void RenderPassRecorder::draw(const VkDrawIndirectCommand& indirect) {
     );
 }
 
+void RenderPassRecorder::draw_indirect(const TypedSubBuffer<VkDrawIndexedIndirectCommand, BufferUsage::IndirectBit>& indirect, usize first_draw, usize draw_count) {
+    y_debug_assert(first_draw + draw_count <= indirect.size());
+    if(!draw_count) {
+        return;
+    }
+
+    draw_call_count.fetch_add(1, std::memory_order_relaxed);
+    indirect_draw_count.fetch_add(draw_count, std::memory_order_relaxed);
+
+    vkCmdDrawIndexedIndirect(vk_cmd_buffer(),
+        indirect.vk_buffer(),
+        indirect.byte_offset() + first_draw * sizeof(VkDrawIndexedIndirectCommand),
+        u32(draw_count),
+        sizeof(VkDrawIndexedIndirectCommand)
+    );
+}
+
+void RenderPassRecorder::draw_indirect_count(const TypedSubBuffer<VkDrawIndexedIndirectCommand, BufferUsage::IndirectBit>& indirect, const TypedSubBuffer<u32, BufferUsage::IndirectBit>& counts, usize first_draw, usize count_index, usize max_draw_count) {
+    y_debug_assert(first_draw + max_draw_count <= indirect.size());
+    y_debug_assert(count_index < counts.size());
+    if(!max_draw_count) {
+        return;
+    }
+
+    draw_call_count.fetch_add(1, std::memory_order_relaxed);
+    indirect_draw_count.fetch_add(max_draw_count, std::memory_order_relaxed);
+
+    vkCmdDrawIndexedIndirectCount(vk_cmd_buffer(),
+        indirect.vk_buffer(),
+        indirect.byte_offset() + first_draw * sizeof(VkDrawIndexedIndirectCommand),
+        counts.vk_buffer(),
+        counts.byte_offset() + count_index * sizeof(u32),
+        u32(max_draw_count),
+        sizeof(VkDrawIndexedIndirectCommand)
+    );
+}
+
 void RenderPassRecorder::draw_indexed(usize index_count) {
     VkDrawIndexedIndirectCommand command = {};
     command.indexCount = u32(index_count);
@@ -56,6 +56,19 @@ class CmdBufferRegion : NonCopyable {
 
 class RenderPassRecorder final : NonMovable {
     public:
+        struct DrawStats {
+            u64 draw_calls = 0;
+
+            // Draw count of indirect calls (max draw count for draw_indirect_count)
+            u64 indirect_draws = 0;
+
+            // Only direct draws are counted, indirect arguments are not read back
+            u64 triangles = 0;
+        };
+
+        // Returns the stats of all draws recorded since the last call, on all threads
+        static DrawStats reset_draw_stats();
+
         ~RenderPassRecorder();
 
         // specific
@@ -68,6 +81,9 @@ class RenderPassRecorder final : NonMovable {
         void draw(const VkDrawIndexedIndirectCommand& indirect);
         void draw(const VkDrawIndirectCommand& indirect);
 
+        void draw_indirect(const TypedSubBuffer<VkDrawIndexedIndirectCommand, BufferUsage::IndirectBit>& indirect, usize first_draw, usize draw_count);
+        void draw_indirect_count(const TypedSubBuffer<VkDrawIndexedIndirectCommand, BufferUsage::IndirectBit>& indirect, const TypedSubBuffer<u32, BufferUsage::IndirectBit>& counts, usize first_draw, usize count_index, usize max_draw_count);
+
         void draw_indexed(usize index_count);
         void draw_array(usize vertex_count, usize instance_count = 1);
 
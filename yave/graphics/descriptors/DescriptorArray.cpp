@@ -88,7 +88,7 @@ static VkHandle<VkDescriptorSetLayout> create_libray_layout(VkDescriptorType typ
     VkDescriptorSetLayoutBinding binding = {};
     {
         binding.descriptorType = type;
-        binding.descriptorCount = std::min(max_descriptor_of_type(type), DescriptorArray::upper_descriptor_count_limit);
+        binding.descriptorCount = 4096; //TMP
         binding.stageFlags = VK_SHADER_STAGE_ALL;
     }
 
@@ -151,6 +151,7 @@ DescriptorArray::~DescriptorArray() {
 VkDescriptorSet DescriptorArray::Allocator::alloc_set(u32 size, const DescriptorArray* parent) {
     y_profile();
     y_debug_assert(size > capacity);
+    size = std::max(size, 4096u); //TMP
 
     destroy_graphic_resource(std::exchange(pool, create_libray_pool(size, parent->_type)));
     capacity = size;
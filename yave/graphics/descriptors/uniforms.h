@@ -65,6 +65,34 @@ struct TransformableData {
 static_assert(sizeof(TransformableData) % 16 == 0);
 
 
+struct StaticMeshInstance {
+    math::Vec3 center;
+    float radius = 0.0f;
+
+    u32 transform_index = u32(-1);
+    u32 material_index = 0;
+    u32 group_index = 0;
+    u32 index_count = 0;
+
+    u32 first_index = 0;
+    i32 vertex_offset = 0;
+    u32 group_offset = 0;
+    u32 padding_0 = 0;
+};
+
+static_assert(sizeof(StaticMeshInstance) % 16 == 0);
+
+
+struct CullingStats {
+    u32 instances = 0;
+    u32 frustum_culled = 0;
+    u32 occlusion_culled = 0;
+    u32 drawn = 0;
+};
+
+static_assert(sizeof(CullingStats) % 16 == 0);
+
+
 struct MaterialData {
     static constexpr usize texture_count = 8;
 
@@ -31,12 +31,14 @@ SOFTWARE.
 #include <yave/graphics/images/ImageData.h>
 #include <yave/material/Material.h>
 #include <yave/material/MaterialTemplate.h>
+#include <yave/material/MaterialCompiler.h>
 #include <yave/meshes/MeshData.h>
 #include <yave/meshes/StaticMesh.h>
 #include <yave/graphics/images/IBLProbe.h>
 
 #include <y/math/random.h>
 #include <y/core/Chrono.h>
+#include <y/core/ScratchPad.h>
 #include <y/io2/File.h>
 #include <y/utils/log.h>
 #include <y/utils/format.h>
@@ -113,6 +115,8 @@ static constexpr const char* spirv_names[] = {
         "atmosphere_integrator.comp",
         "prev_camera.comp",
         "update_transforms.comp",
+        "depth_pyramid.comp",
+        "cull_static_meshes.comp",
 
         "deferred_point.frag",
         "deferred_spot.frag",
@@ -250,6 +254,15 @@ DeviceResources::DeviceResources() {
         }
     }
 
+    {
+        y_profile_zone("Pipeline precompilation");
+        core::ScratchPad<const MaterialTemplate*> templates(template_count);
+        for(usize i = 0; i != template_count; ++i) {
+            templates[i] = &_material_templates[i];
+        }
+        MaterialCompiler::precompile(templates);
+    }
+
     {
         y_profile_zone("Materials");
         _materials = std::make_unique<AssetPtr<Material>[]>(usize(MaxMaterials));
@@ -58,6 +58,8 @@ class DeviceResources final : NonMovable {
             AtmosphereIntergratorComp,
             PrevCameraComp,
             UpdateTransformsComp,
+            DepthPyramidComp,
+            CullStaticMeshesComp,
 
             DeferredPointFrag,
             DeferredSpotFrag,
@@ -102,6 +104,8 @@ class DeviceResources final : NonMovable {
             AtmosphereIntergratorProgram,
             PrevCameraProgram,
             UpdateTransformsProgram,
+            DepthPyramidProgram,
+            CullStaticMeshesProgram,
 
             MaxComputePrograms
         };
@@ -217,6 +217,14 @@ ResourceFence LifetimeManager::create_fence() {
     return _create_counter++;
 }
 
+ResourceFence LifetimeManager::retire_fence() const {
+    return _create_counter.load();
+}
+
+bool LifetimeManager::is_complete(ResourceFence fence) const {
+    return _in_flight.locked([&](auto&&) { return fence._value <= _next_to_collect; });
+}
+
 usize LifetimeManager::pending_cmd_buffers() const {
     return _in_flight.locked([](auto&& in_flight) { return in_flight.size(); });
 }
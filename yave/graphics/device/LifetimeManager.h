@@ -61,6 +61,10 @@ YAVE_GRAPHIC_HANDLE_TYPES(YAVE_GENERATE_RT_VARIANT)
         ResourceFence create_fence();
         void register_pending(core::Span<CmdBufferData*> datas);
 
+        // Anything released now can be reused once is_complete(retire_fence()) returns true
+        ResourceFence retire_fence() const;
+        bool is_complete(ResourceFence fence) const;
+
         usize pending_deletions() const;
         usize pending_cmd_buffers() const;
 
@@ -27,6 +27,8 @@ SOFTWARE.
 
 #include <yave/graphics/device/extensions/DebugUtils.h>
 
+#include <yave/meshes/MeshData.h>
+
 #include <y/core/FixedArray.h>
 #include <y/utils/memory.h>
 
@@ -34,13 +36,9 @@ namespace yave {
 
 MeshAllocator::MeshAllocator() :
         _attrib_buffer(default_vertex_count * MeshVertexStreams::total_vertex_size),
-        _triangle_buffer(default_triangle_count) {
-
-
-    _free_blocks << FreeBlock {
-        0, default_vertex_count,
-        0, default_triangle_count
-    };
+        _triangle_buffer(default_triangle_count),
+        _vertex_allocator(default_vertex_count),
+        _triangle_allocator(default_triangle_count) {
 
     const u64 vertex_capacity = _attrib_buffer.byte_size() / u64(MeshVertexStreams::total_vertex_size);
 
@@ -70,14 +68,16 @@ MeshAllocator::MeshAllocator() :
 MeshAllocator::~MeshAllocator() {
     const auto lock = std::unique_lock(_lock);
 
-    sort_and_compact_blocks();
-
-    y_always_assert(_free_blocks.size() == 1, "Not all mesh memory has been released: mesh heap fragmented");
+    y_always_assert(_vertex_allocator.allocation_count() == 0 && _triangle_allocator.allocation_count() == 0, "Not all mesh memory has been released");
+    y_always_assert(_vertex_allocator.free_blocks() == 1 && _triangle_allocator.free_blocks() == 1, "Not all mesh memory has been released: mesh heap fragmented");
 }
 
-MeshDrawData MeshAllocator::alloc_mesh(const MeshVertexStreams& streams, core::Span<IndexedTriangle> triangles) {
+MeshDrawData MeshAllocator::alloc_mesh(const MeshData& mesh) {
     y_profile();
 
+    const MeshVertexStreams& streams = mesh.vertex_streams();
+    const core::Span<IndexedTriangle> triangles = mesh.triangles();
+
     const u64 triangle_count = triangles.size();
     const u64 vertex_count = streams.vertex_count();
 
@@ -139,6 +139,20 @@ MeshDrawData MeshAllocator::alloc_mesh(const MeshVertexStreams& streams, core::S
         recorder.submit_async();
     }
 
+    {
+        const auto sub_meshes = mesh.sub_meshes();
+        mesh_data._sub_meshes = core::FixedArray<MeshDrawCommand>(sub_meshes.size());
+        std::transform(sub_meshes.begin(), sub_meshes.end(), mesh_data._sub_meshes.begin(), [cmd = mesh_data._command](auto sub_mesh) {
+            return MeshDrawCommand {
+                sub_mesh.triangle_count * 3,
+                sub_mesh.first_triangle * 3 + cmd.first_index,
+                cmd.vertex_offset
+            };
+        });
+    }
+
+    relink(&mesh_data);
+
     return mesh_data;
 }
 
@@ -147,86 +161,154 @@ void MeshAllocator::recycle(MeshDrawData* data) {
 
     const auto lock = std::unique_lock(_lock);
 
-    _free_blocks << FreeBlock {
-        u64(data->_command.vertex_offset),
-        data->_vertex_count,
-        u64(data->_command.first_index) / 3,
-        u64(data->_command.index_count) / 3,
-    };
+    // Ranges released by defragment only have one of the two
+    if(data->_vertex_count) {
+        const u64 vertex_offset = u64(data->_command.vertex_offset);
+        if(const auto it = _vertex_owners.find(vertex_offset); it != _vertex_owners.end() && it->second == data) {
+            _vertex_owners.erase(it);
+        }
+        _vertex_allocator.free(vertex_offset);
+    }
+
+    if(data->_command.index_count) {
+        const u64 triangle_offset = u64(data->_command.first_index) / 3;
+        if(const auto it = _triangle_owners.find(triangle_offset); it != _triangle_owners.end() && it->second == data) {
+            _triangle_owners.erase(it);
+        }
+        _triangle_allocator.free(triangle_offset);
+    }
 
     data->_command = {};
+    data->_vertex_count = 0;
+    data->_sub_meshes = core::FixedArray<MeshDrawCommand>();
     data->_mesh_buffers = nullptr;
-
-    _should_compact = true;
 }
 
+void MeshAllocator::relink(MeshDrawData* data) {
+    y_debug_assert(data->_mesh_buffers == _mesh_buffers.get());
+
+    if(!data->_vertex_count || !data->_command.index_count) {
+        return;
+    }
 
-std::pair<u64, u64> MeshAllocator::alloc_block(u64 vertex_count, u64 triangle_count) {
     const auto lock = std::unique_lock(_lock);
+    _vertex_owners[u64(data->_command.vertex_offset)] = data;
+    _triangle_owners[u64(data->_command.first_index) / 3] = data;
+}
+
+usize MeshAllocator::defragment(u64 max_bytes) {
+    y_profile();
+
+    core::Vector<MeshDrawData> released;
+
+    {
+        const auto lock = std::unique_lock(_lock);
 
-    sort_and_compact_blocks();
+        const u64 vertex_byte_size = u64(MeshVertexStreams::total_vertex_size);
+        const u64 triangle_byte_size = u64(sizeof(IndexedTriangle));
 
-    for(auto& block : _free_blocks) {
-        if(block.vertex_count < vertex_count || block.triangle_count < triangle_count) {
-            continue;
+        const auto vertex_moves = _vertex_allocator.plan_defragmentation(max_bytes / 2 / vertex_byte_size);
+        const auto triangle_moves = _triangle_allocator.plan_defragmentation(max_bytes / 2 / triangle_byte_size);
+
+        if(vertex_moves.is_empty() && triangle_moves.is_empty()) {
+            return 0;
         }
 
-        const u64 vertex_offset = block.vertex_offset;
-        const u64 triangle_offset = block.triangle_offset;
+        TransferCmdBufferRecorder recorder = create_disposable_transfer_cmd_buffer();
 
-        block.vertex_offset += vertex_count;
-        block.vertex_count -= vertex_count;
-        block.triangle_offset += triangle_count;
-        block.triangle_count -= triangle_count;
+        // Everything goes through the same queue: the barriers order the copies after pending uploads
+        // and make the moved data visible to the vertex and index reads of the next frames.
+        recorder.full_barrier();
+
+        const u64 vertex_capacity = u64(_mesh_buffers->_vertex_count);
+        for(const auto& move : vertex_moves) {
+            const auto it = _vertex_owners.find(move.src);
+            y_debug_assert(it != _vertex_owners.end());
+            MeshDrawData* data = it->second;
+
+            for(const AttribSubBuffer& sub_buffer : _mesh_buffers->_attrib_buffers) {
+                const u64 elem_size = sub_buffer.byte_size() / vertex_capacity;
+                recorder.unbarriered_copy(
+                    CmdBufferRecorderBase::SrcCopySubBuffer(_attrib_buffer, move.size * elem_size, sub_buffer.byte_offset() + move.src * elem_size),
+                    CmdBufferRecorderBase::DstCopySubBuffer(_attrib_buffer, move.size * elem_size, sub_buffer.byte_offset() + move.dst * elem_size)
+                );
+            }
 
-        return {vertex_offset, triangle_offset};
+            MeshDrawData& old = released.emplace_back();
+            old._mesh_buffers = _mesh_buffers.get();
+            old._vertex_count = u32(move.size);
+            old._command.vertex_offset = i32(move.src);
+
+            data->_command.vertex_offset = i32(move.dst);
+            for(MeshDrawCommand& sub_mesh : data->_sub_meshes) {
+                sub_mesh.vertex_offset = i32(move.dst);
+            }
+
+            _vertex_owners.erase(it);
+            _vertex_owners[move.dst] = data;
+        }
+
+        for(const auto& move : triangle_moves) {
+            const auto it = _triangle_owners.find(move.src);
+            y_debug_assert(it != _triangle_owners.end());
+            MeshDrawData* data = it->second;
+
+            recorder.unbarriered_copy(
+                CmdBufferRecorderBase::SrcCopySubBuffer(_triangle_buffer, move.size * triangle_byte_size, move.src * triangle_byte_size),
+                CmdBufferRecorderBase::DstCopySubBuffer(_triangle_buffer, move.size * triangle_byte_size, move.dst * triangle_byte_size)
+            );
+
+            MeshDrawData& old = released.emplace_back();
+            old._mesh_buffers = _mesh_buffers.get();
+            old._command.index_count = u32(move.size * 3);
+            old._command.first_index = u32(move.src * 3);
+
+            data->_command.first_index = u32(move.dst * 3);
+            for(MeshDrawCommand& sub_mesh : data->_sub_meshes) {
+                sub_mesh.first_index = u32(sub_mesh.first_index - move.src * 3 + move.dst * 3);
+            }
+
+            _triangle_owners.erase(it);
+            _triangle_owners[move.dst] = data;
+        }
+
+        recorder.full_barrier();
+        recorder.submit_async();
+    }
+
+    // Sources stay allocated until the frames still reading them are done
+    const usize moved = released.size();
+    for(MeshDrawData& data : released) {
+        destroy_graphic_resource(std::move(data));
     }
 
-    y_fatal("Unable to alloc mesh data");
+    _on_relocated.send();
+
+    return moved;
 }
 
-void MeshAllocator::sort_and_compact_blocks() {
-    y_profile();
+concurrent::Signal<>& MeshAllocator::on_relocated() {
+    return _on_relocated;
+}
 
-    y_debug_assert(!_lock.try_lock());
 
-    const usize block_count = _free_blocks.size();
-    if(!_should_compact || block_count < 2) {
-        return;
-    }
+std::pair<u64, u64> MeshAllocator::alloc_block(u64 vertex_count, u64 triangle_count) {
+    const auto lock = std::unique_lock(_lock);
 
-    _should_compact = false;
-
-    std::sort(_free_blocks.begin(), _free_blocks.end(), [](const auto& a, const auto& b) {
-        return a.vertex_offset < b.vertex_offset;
-    });
-
-    usize dst = 0;
-    for(usize i = 1; i != block_count; ++i) {
-        const u64 dst_end = _free_blocks[dst].vertex_offset + _free_blocks[dst].vertex_count;
-        if(_free_blocks[i].vertex_offset == dst_end) {
-            y_debug_assert(_free_blocks[dst].triangle_offset + _free_blocks[dst].triangle_count == _free_blocks[i].triangle_offset);
-            _free_blocks[dst].vertex_count += _free_blocks[i].vertex_count;
-            _free_blocks[dst].triangle_count += _free_blocks[i].triangle_count;
-        } else {
-            ++dst;
-            _free_blocks[dst] = _free_blocks[i];
-        }
+    auto vertex_offset = _vertex_allocator.alloc(vertex_count);
+    auto triangle_offset = _triangle_allocator.alloc(triangle_count);
+
+    if(!vertex_offset || !triangle_offset) {
+        y_fatal("Unable to alloc mesh data");
     }
 
-    _free_blocks.shrink_to(dst + 1);
+    return {vertex_offset.unwrap(), triangle_offset.unwrap()};
 }
 
 
 std::pair<u64, u64> MeshAllocator::available() const {
     const auto lock = std::unique_lock(_lock);
-    u64 vert = 0;
-    u64 tris = 0;
-    for(const auto& b : _free_blocks) {
-        vert += b.vertex_count;
-        tris += b.triangle_count;
-    }
-    return {vert, tris};
+    return {_vertex_allocator.available(), _triangle_allocator.available()};
 }
 
 std::pair<u64, u64> MeshAllocator::allocated() const {
@@ -234,9 +316,14 @@ std::pair<u64, u64> MeshAllocator::allocated() const {
     return {default_vertex_count - vert, default_triangle_count - tris};
 }
 
+std::pair<float, float> MeshAllocator::fragmentation() const {
+    const auto lock = std::unique_lock(_lock);
+    return {_vertex_allocator.fragmentation(), _triangle_allocator.fragmentation()};
+}
+
 usize MeshAllocator::free_blocks() const {
     const auto lock = std::unique_lock(_lock);
-    return _free_blocks.size();
+    return _vertex_allocator.free_blocks() + _triangle_allocator.free_blocks();
 }
 
 const MeshDrawBuffers& MeshAllocator::mesh_buffers() const {
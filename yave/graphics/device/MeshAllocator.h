@@ -26,7 +26,9 @@ SOFTWARE.
 #include <yave/meshes/MeshDrawData.h>
 
 #include <y/core/Span.h>
-#include <y/core/Vector.h>
+#include <y/core/TLSFAllocator.h>
+#include <y/core/HashMap.h>
+#include <y/concurrent/Signal.h>
 
 #include <atomic>
 #include <mutex>
@@ -37,13 +39,9 @@ class MeshAllocator : NonMovable {
     using MutableTriangleSubBuffer = SubBuffer<BufferUsage::IndexBit | BufferUsage::TransferDstBit>;
     using MutableAttribSubBuffer = SubBuffer<BufferUsage::AttributeBit | BufferUsage::TransferDstBit>;
 
-    struct FreeBlock {
-        u64 vertex_offset;
-        u64 vertex_count;
-
-        u64 triangle_offset;
-        u64 triangle_count;
-    };
+    // Meshes are copied within the buffers when defragmenting
+    using MeshAttribBuffer = Buffer<BufferUsage::AttributeBit | BufferUsage::TransferDstBit | BufferUsage::TransferSrcBit, prefered_memory_type(BufferUsage::AttributeBit)>;
+    using MeshTriangleBuffer = TypedBuffer<IndexedTriangle, BufferUsage::IndexBit | BufferUsage::TransferDstBit | BufferUsage::TransferSrcBit, prefered_memory_type(BufferUsage::IndexBit)>;
 
     public:
         static const u64 default_vertex_count = 8 * 1024 * 1024;
@@ -52,10 +50,19 @@ class MeshAllocator : NonMovable {
         MeshAllocator();
         ~MeshAllocator();
 
-        MeshDrawData alloc_mesh(const MeshVertexStreams& streams, core::Span<IndexedTriangle> triangles);
+        MeshDrawData alloc_mesh(const MeshData& mesh_data);
+
+        // Moves up to max_bytes of mesh data toward the start of the buffers and patches the draw data of the moved meshes.
+        // Should be called between frames: draw commands recorded before the call are not valid anymore.
+        // Returns the number of moved vertex and triangle ranges.
+        usize defragment(u64 max_bytes);
+
+        // Sent after meshes have been moved
+        concurrent::Signal<>& on_relocated();
 
-        std::pair<u64, u64> available() const; // slow!
-        std::pair<u64, u64> allocated() const; // slow!
+        std::pair<u64, u64> available() const;
+        std::pair<u64, u64> allocated() const;
+        std::pair<float, float> fragmentation() const;
         usize free_blocks() const;
 
         const MeshDrawBuffers& mesh_buffers() const;
@@ -64,15 +71,22 @@ class MeshAllocator : NonMovable {
         friend class MeshDrawData;
 
         std::pair<u64, u64> alloc_block(u64 vertex_count, u64 triangle_count);
-        void sort_and_compact_blocks();
 
         void recycle(MeshDrawData* data);
+        void relink(MeshDrawData* data);
+
+        MeshAttribBuffer _attrib_buffer;
+        MeshTriangleBuffer _triangle_buffer;
+
+        // Vertices and triangles are allocated independently
+        core::TLSFAllocator _vertex_allocator;
+        core::TLSFAllocator _triangle_allocator;
 
-        AttribBuffer<> _attrib_buffer;
-        TriangleBuffer<> _triangle_buffer;
+        // Live meshes, by vertex and triangle offset
+        core::FlatHashMap<u64, MeshDrawData*> _vertex_owners;
+        core::FlatHashMap<u64, MeshDrawData*> _triangle_owners;
 
-        core::Vector<FreeBlock> _free_blocks;
-        bool _should_compact = false;
+        concurrent::Signal<> _on_relocated;
         mutable std::mutex _lock;
 
         std::unique_ptr<MeshDrawBuffers> _mesh_buffers;
@@ -78,7 +78,7 @@ DeviceProperties PhysicalDevice::device_properties() const {
     properties.max_sampled_image_desc_array_size = _properties_1_2.maxDescriptorSetUpdateAfterBindSampledImages;
     properties.max_storage_image_desc_array_size = _properties_1_2.maxDescriptorSetUpdateAfterBindStorageImages;
 
-    properties.max_inline_uniform_size = _properties_1_3.maxInlineUniformBlockSize;
+    properties.max_inline_uniform_size = 0; //TMP
 
     properties.timestamp_period = limits.timestampPeriod;
 
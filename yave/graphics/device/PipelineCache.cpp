@@ -0,0 +1,180 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include "PipelineCache.h"
+#include "PhysicalDevice.h"
+
+#include <yave/graphics/graphics.h>
+
+#include <y/io2/File.h>
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+#include <cstring>
+
+namespace yave {
+
+struct PipelineCacheHeader {
+    static constexpr u32 current_magic = 0x63707679;
+    static constexpr u32 current_version = 1;
+
+    u32 magic = current_magic;
+    u32 version = current_version;
+
+    u32 vendor_id = 0;
+    u32 device_id = 0;
+    u32 driver_version = 0;
+    std::array<u8, VK_UUID_SIZE> uuid = {};
+
+    u32 known_layout_count = 0;
+    u64 cache_byte_size = 0;
+
+    static PipelineCacheHeader for_device() {
+        const VkPhysicalDeviceProperties& props = physical_device().vk_properties();
+
+        PipelineCacheHeader header;
+        header.vendor_id = props.vendorID;
+        header.device_id = props.deviceID;
+        header.driver_version = props.driverVersion;
+        std::copy_n(props.pipelineCacheUUID, VK_UUID_SIZE, header.uuid.begin());
+        return header;
+    }
+
+    bool is_compatible(const PipelineCacheHeader& other) const {
+        return magic == other.magic &&
+               version == other.version &&
+               vendor_id == other.vendor_id &&
+               device_id == other.device_id &&
+               driver_version == other.driver_version &&
+               uuid == other.uuid;
+    }
+};
+
+
+PipelineCache::PipelineCache(const core::String& file_name) : _file_name(file_name) {
+    y_profile();
+
+    core::Vector<u8> cache_data;
+
+    if(auto file = io2::File::open(_file_name)) {
+        const PipelineCacheHeader expected = PipelineCacheHeader::for_device();
+
+        PipelineCacheHeader header;
+        bool valid = file.unwrap().read_one(header).is_ok() && header.is_compatible(expected);
+
+        if(valid) {
+            _known = core::Vector<KnownLayout>(header.known_layout_count, KnownLayout{});
+            cache_data = core::Vector<u8>(usize(header.cache_byte_size), u8(0));
+
+            valid = file.unwrap().read_array(_known.data(), _known.size()).is_ok() &&
+                    file.unwrap().read_array(cache_data.data(), cache_data.size()).is_ok();
+        }
+
+        if(!valid) {
+            log_msg(fmt("Pipeline cache \"{}\" is invalid or was created for another device, ignoring", _file_name), Log::Warning);
+            _known.clear();
+            cache_data.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo create_info = vk_struct();
+    {
+        create_info.initialDataSize = cache_data.size();
+        create_info.pInitialData = cache_data.data();
+    }
+
+    if(vkCreatePipelineCache(vk_device(), &create_info, vk_allocation_callbacks(), &_cache) != VK_SUCCESS) {
+        log_msg("Unable to use pipeline cache data, starting with an empty cache", Log::Warning);
+        create_info.initialDataSize = 0;
+        create_info.pInitialData = nullptr;
+        _known.clear();
+        vk_check(vkCreatePipelineCache(vk_device(), &create_info, vk_allocation_callbacks(), &_cache));
+    } else {
+        _loaded_size = cache_data.size();
+    }
+
+    log_msg(fmt("Pipeline cache loaded: {}KB, {} known pipelines", _loaded_size / 1024, _known.size()));
+}
+
+PipelineCache::~PipelineCache() {
+    save();
+    vkDestroyPipelineCache(vk_device(), _cache, vk_allocation_callbacks());
+}
+
+VkPipelineCache PipelineCache::vk_pipeline_cache() const {
+    return _cache;
+}
+
+bool PipelineCache::save() const {
+    y_profile();
+
+    usize byte_size = 0;
+    vk_check(vkGetPipelineCacheData(vk_device(), _cache, &byte_size, nullptr));
+
+    core::Vector<u8> cache_data(byte_size, u8(0));
+    vk_check(vkGetPipelineCacheData(vk_device(), _cache, &byte_size, cache_data.data()));
+
+    const auto lock = std::unique_lock(_lock);
+
+    PipelineCacheHeader header = PipelineCacheHeader::for_device();
+    header.known_layout_count = u32(_known.size());
+    header.cache_byte_size = byte_size;
+
+    auto file = io2::File::create(_file_name);
+    if(!file ||
+       !file.unwrap().write_one(header) ||
+       !file.unwrap().write_array(_known.data(), _known.size()) ||
+       !file.unwrap().write_array(cache_data.data(), byte_size)) {
+        log_msg(fmt("Unable to write pipeline cache \"{}\"", _file_name), Log::Error);
+        return false;
+    }
+
+    return true;
+}
+
+void PipelineCache::add_known_layout(u64 template_hash, const RenderPass::Layout& layout) {
+    const auto lock = std::unique_lock(_lock);
+    for(const KnownLayout& known : _known) {
+        if(known.template_hash == template_hash && known.layout == layout) {
+            return;
+        }
+    }
+    _known << KnownLayout{template_hash, layout};
+}
+
+core::Vector<RenderPass::Layout> PipelineCache::known_layouts(u64 template_hash) const {
+    const auto lock = std::unique_lock(_lock);
+
+    core::Vector<RenderPass::Layout> layouts;
+    for(const KnownLayout& known : _known) {
+        if(known.template_hash == template_hash) {
+            layouts << known.layout;
+        }
+    }
+    return layouts;
+}
+
+usize PipelineCache::loaded_byte_size() const {
+    return _loaded_size;
+}
+
+}
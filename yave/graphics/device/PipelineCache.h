@@ -0,0 +1,70 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_DEVICE_PIPELINECACHE_H
+#define YAVE_GRAPHICS_DEVICE_PIPELINECACHE_H
+
+#include <yave/graphics/framebuffer/RenderPass.h>
+
+#include <y/core/Vector.h>
+#include <y/core/String.h>
+
+#include <mutex>
+
+namespace yave {
+
+// Shared VkPipelineCache, persisted to disk between runs.
+// Also remembers which render pass layouts each material template has been compiled for,
+// so that MaterialCompiler::precompile can build them ahead of time on the next run.
+class PipelineCache : NonMovable {
+    public:
+        static constexpr const char* default_file_name = "pipeline_cache.bin";
+
+        PipelineCache(const core::String& file_name = default_file_name);
+        ~PipelineCache();
+
+        VkPipelineCache vk_pipeline_cache() const;
+
+        bool save() const;
+
+        void add_known_layout(u64 template_hash, const RenderPass::Layout& layout);
+        core::Vector<RenderPass::Layout> known_layouts(u64 template_hash) const;
+
+        usize loaded_byte_size() const;
+
+    private:
+        struct KnownLayout {
+            u64 template_hash = 0;
+            RenderPass::Layout layout;
+        };
+
+        core::String _file_name;
+        VkPipelineCache _cache = {};
+
+        core::Vector<KnownLayout> _known;
+        usize _loaded_size = 0;
+
+        mutable std::mutex _lock;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_DEVICE_PIPELINECACHE_H
@@ -0,0 +1,171 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "UploadRingBuffer.h"
+#include "LifetimeManager.h"
+
+#include <yave/graphics/graphics.h>
+#include <yave/graphics/device/DeviceProperties.h>
+#include <yave/graphics/device/extensions/DebugUtils.h>
+
+#include <y/utils/memory.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace yave {
+
+UploadAllocation::~UploadAllocation() {
+    if(_parent) {
+        _parent->retire(_region);
+    }
+}
+
+UploadAllocation::UploadAllocation(UploadAllocation&& other) {
+    swap(other);
+}
+
+UploadAllocation& UploadAllocation::operator=(UploadAllocation&& other) {
+    swap(other);
+    return *this;
+}
+
+void UploadAllocation::swap(UploadAllocation& other) {
+    std::swap(_parent, other._parent);
+    std::swap(_region, other._region);
+    std::swap(_buffer, other._buffer);
+    std::swap(_overflow, other._overflow);
+}
+
+bool UploadAllocation::is_null() const {
+    return _buffer.is_null();
+}
+
+const UploadAllocation::sub_buffer_type& UploadAllocation::buffer() const {
+    return _buffer;
+}
+
+BufferMapping<u8> UploadAllocation::map_bytes(MappingAccess access) const {
+    return _buffer.map_bytes(access);
+}
+
+
+
+UploadRingBuffer::UploadRingBuffer(u64 byte_size) : _buffer(byte_size) {
+    const DeviceProperties& props = device_properties();
+    _min_alignment = std::max({props.non_coherent_atom_size, props.uniform_buffer_alignment, props.storage_buffer_alignment, u64(16)});
+
+#ifdef Y_DEBUG
+    if(const auto* debug = debug_utils()) {
+        debug->set_resource_name(_buffer.vk_buffer(), "Upload ring buffer");
+    }
+#endif
+}
+
+UploadRingBuffer::~UploadRingBuffer() {
+    const auto lock = std::unique_lock(_lock);
+    y_always_assert(std::all_of(_regions.begin(), _regions.end(), [](const Region& r) { return r.retired; }), "Upload allocations are still alive");
+}
+
+UploadAllocation UploadRingBuffer::alloc(u64 byte_size, u64 alignment) {
+    y_profile();
+
+    y_debug_assert(byte_size);
+
+    const u64 size = _buffer.byte_size();
+    const u64 aligned_size = align_up_to(byte_size, _min_alignment);
+
+    UploadAllocation allocation;
+
+    {
+        const auto lock = std::unique_lock(_lock);
+
+        reclaim();
+
+        u64 begin = align_up_to(_head, std::lcm(alignment, _min_alignment));
+        if((begin % size) + aligned_size > size) {
+            // Allocations never wrap around, skip to the start of the buffer
+            begin = align_up_to(begin, size);
+        }
+
+        const u64 end = begin + aligned_size;
+        if(end - _tail <= size) {
+            _regions.push_back(Region{end, {}, false});
+            _head = end;
+
+            allocation._parent = this;
+            allocation._region = _first_region + _regions.size() - 1;
+            allocation._buffer = UploadAllocation::sub_buffer_type(_buffer, byte_size, begin % size);
+            return allocation;
+        }
+
+        ++_overflow_count;
+    }
+
+    y_profile_zone("overflow");
+    allocation._overflow = UploadAllocation::buffer_type(byte_size);
+    allocation._buffer = allocation._overflow;
+    return allocation;
+}
+
+void UploadRingBuffer::retire(u64 region) {
+    const auto lock = std::unique_lock(_lock);
+
+    y_debug_assert(region >= _first_region);
+    Region& r = _regions[usize(region - _first_region)];
+    r.fence = lifetime_manager().retire_fence();
+    r.retired = true;
+}
+
+void UploadRingBuffer::reclaim() {
+    while(!_regions.is_empty()) {
+        const Region& region = _regions.first();
+        if(!region.retired || !lifetime_manager().is_complete(region.fence)) {
+            break;
+        }
+
+        _tail = region.end;
+        _regions.pop_front();
+        ++_first_region;
+    }
+
+    if(_regions.is_empty()) {
+        // Nothing is in flight, restart from the beginning of the buffer
+        _head = _tail = align_up_to(_head, _buffer.byte_size());
+    }
+}
+
+u64 UploadRingBuffer::byte_size() const {
+    return _buffer.byte_size();
+}
+
+u64 UploadRingBuffer::used() const {
+    const auto lock = std::unique_lock(_lock);
+    return _head - _tail;
+}
+
+usize UploadRingBuffer::overflow_count() const {
+    const auto lock = std::unique_lock(_lock);
+    return _overflow_count;
+}
+
+}
@@ -0,0 +1,127 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_DEVICE_UPLOADRINGBUFFER_H
+#define YAVE_GRAPHICS_DEVICE_UPLOADRINGBUFFER_H
+
+#include <yave/graphics/buffers/Buffer.h>
+#include <yave/graphics/commands/CmdBufferData.h>
+
+#include <y/core/RingQueue.h>
+
+#include <mutex>
+
+namespace yave {
+
+class UploadRingBuffer;
+
+// Staging memory returned by UploadRingBuffer::alloc.
+// The memory can be reused once the command buffers created before the allocation is destroyed have completed.
+class UploadAllocation : NonCopyable {
+    public:
+        static constexpr BufferUsage usage = BufferUsage::TransferSrcBit | BufferUsage::StorageBit;
+        using buffer_type = Buffer<usage, MemoryType::Staging>;
+        using sub_buffer_type = SubBuffer<usage, MemoryType::Staging>;
+
+        UploadAllocation() = default;
+        ~UploadAllocation();
+
+        UploadAllocation(UploadAllocation&& other);
+        UploadAllocation& operator=(UploadAllocation&& other);
+
+        bool is_null() const;
+
+        const sub_buffer_type& buffer() const;
+
+        template<typename T>
+        TypedSubBuffer<T, usage, MemoryType::Staging> typed_buffer() const {
+            return _buffer;
+        }
+
+        BufferMapping<u8> map_bytes(MappingAccess access = MappingAccess::WriteOnly) const;
+
+    private:
+        friend class UploadRingBuffer;
+
+        void swap(UploadAllocation& other);
+
+        UploadRingBuffer* _parent = nullptr;
+        u64 _region = 0;
+
+        sub_buffer_type _buffer;
+
+        // Only used when the ring is full
+        buffer_type _overflow;
+};
+
+// Persistently allocated staging ring, split into regions that are reclaimed once the GPU is done with them.
+// Replaces short lived staging buffers: transform updates, frame graph uploads and texture uploads.
+class UploadRingBuffer : NonMovable {
+    public:
+        static constexpr u64 default_byte_size = 32 * 1024 * 1024;
+
+        UploadRingBuffer(u64 byte_size = default_byte_size);
+        ~UploadRingBuffer();
+
+        // Falls back to a dedicated buffer if the ring doesn't have enough free space
+        UploadAllocation alloc(u64 byte_size, u64 alignment = 1);
+
+        template<typename T>
+        UploadAllocation alloc(usize count) {
+            return alloc(std::max(usize(1), count) * sizeof(T), alignof(T));
+        }
+
+        u64 byte_size() const;
+        u64 used() const;
+
+        // Allocations that did not fit in the ring
+        usize overflow_count() const;
+
+    private:
+        friend class UploadAllocation;
+
+        struct Region {
+            u64 end = 0;
+            ResourceFence fence;
+            bool retired = false;
+        };
+
+        void retire(u64 region);
+        void reclaim();
+
+        UploadAllocation::buffer_type _buffer;
+        u64 _min_alignment = 1;
+
+        // Positions are monotonic, offsets in the buffer are taken modulo its size
+        u64 _head = 0;
+        u64 _tail = 0;
+
+        core::RingQueue<Region> _regions;
+        u64 _first_region = 0;
+
+        usize _overflow_count = 0;
+
+        mutable std::mutex _lock;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_DEVICE_UPLOADRINGBUFFER_H
@@ -222,8 +222,9 @@ VkPhysicalDeviceFeatures required_device_features() {
     VkPhysicalDeviceFeatures required = {};
 
     {
-        required.multiDrawIndirect = true;
-        required.geometryShader = true;
+        required.multiDrawIndirect = true;
+        required.robustBufferAccess = true; //TMP
+        //TMP required.geometryShader = true;
         required.drawIndirectFirstInstance = true;
         required.fullDrawIndexUint32 = true;
         required.textureCompressionBC = true;
@@ -255,6 +256,7 @@ VkPhysicalDeviceVulkan12Features required_device_features_1_2() {
 
     {
         required.timelineSemaphore = true;
+        //TMP required.drawIndirectCount = true;
         required.runtimeDescriptorArray = true;
         required.descriptorIndexing = true;
         required.descriptorBindingVariableDescriptorCount = true;
@@ -302,7 +304,7 @@ bool has_required_properties(const PhysicalDevice &physical) {
 
     bool ok = true;
 
-    ok &= !!p11.subgroupQuadOperationsInAllStages;
+    //TMP ok &= !!p11.subgroupQuadOperationsInAllStages;
 
     return ok;
 }
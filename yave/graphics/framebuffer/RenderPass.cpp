@@ -166,6 +166,15 @@ bool RenderPass::Layout::is_depth_only() const {
     return !_colors[0].is_valid();
 }
 
+ImageFormat RenderPass::Layout::depth_format() const {
+    return _depth;
+}
+
+core::Span<ImageFormat> RenderPass::Layout::color_formats() const {
+    const auto end = std::find_if(_colors.begin(), _colors.end(), [](const ImageFormat& f) { return !f.is_valid(); });
+    return core::Span<ImageFormat>(_colors.data(), usize(end - _colors.begin()));
+}
+
 bool RenderPass::Layout::operator==(const Layout& other) const {
     return _depth == other._depth && _colors == other._colors;
 }
@@ -181,6 +190,26 @@ RenderPass::RenderPass(core::Span<AttachmentData> colors) :
         RenderPass(AttachmentData(), colors) {
 }
 
+// Only formats matter for render pass compatibility
+static RenderPass::AttachmentData compatible_depth(const RenderPass::Layout& layout) {
+    const ImageFormat format = layout.depth_format();
+    return format.is_valid()
+        ? RenderPass::AttachmentData(format, ImageUsage::DepthBit, RenderPass::LoadOp::Load)
+        : RenderPass::AttachmentData();
+}
+
+static core::Vector<RenderPass::AttachmentData> compatible_colors(const RenderPass::Layout& layout) {
+    core::Vector<RenderPass::AttachmentData> colors;
+    for(const ImageFormat format : layout.color_formats()) {
+        colors.emplace_back(format, ImageUsage::ColorBit, RenderPass::LoadOp::Load);
+    }
+    return colors;
+}
+
+RenderPass::RenderPass(const Layout& layout) :
+        RenderPass(compatible_depth(layout), compatible_colors(layout)) {
+}
+
 RenderPass::~RenderPass() {
     destroy_graphic_resource(std::move(_render_pass));
 }
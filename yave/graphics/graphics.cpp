@@ -35,6 +35,8 @@ SOFTWARE.
 #include <yave/graphics/device/LifetimeManager.h>
 #include <yave/graphics/device/MeshAllocator.h>
 #include <yave/graphics/device/MaterialAllocator.h>
+#include <yave/graphics/device/UploadRingBuffer.h>
+#include <yave/graphics/device/PipelineCache.h>
 #include <yave/graphics/images/TextureLibrary.h>
 
 #include <y/concurrent/Mutexed.h>
@@ -53,9 +55,11 @@ std::array<Uninitialized<Sampler>, 5> samplers;
 
 Uninitialized<DeviceMemoryAllocator> allocator;
 Uninitialized<LifetimeManager> lifetime_manager;
+Uninitialized<PipelineCache> pipeline_cache;
 Uninitialized<DescriptorSetAllocator> descriptor_set_allocator;
 Uninitialized<MeshAllocator> mesh_allocator;
 Uninitialized<MaterialAllocator> material_allocator;
+Uninitialized<UploadRingBuffer> upload_ring_buffer;
 Uninitialized<TextureLibrary> texture_library;
 Uninitialized<DeviceResources> resources;
 
@@ -162,10 +166,12 @@ void init_device(Instance& instance, PhysicalDevice device) {
     init_vk_device();
 
     device::lifetime_manager.init();
+    device::pipeline_cache.init();
     device::allocator.init(device_properties());
     device::descriptor_set_allocator.init();
     device::mesh_allocator.init();
     device::material_allocator.init();
+    device::upload_ring_buffer.init();
     device::texture_library.init();
 
     for(usize i = 0; i != device::samplers.size(); ++i) {
@@ -196,6 +202,8 @@ void destroy_device() {
     }
 
     device::texture_library.destroy();
+    device::pipeline_cache.destroy();
+    device::upload_ring_buffer.destroy();
     device::material_allocator.destroy();
     device::mesh_allocator.destroy();
     device::descriptor_set_allocator.destroy();
@@ -271,6 +279,14 @@ MaterialAllocator& material_allocator() {
     return *device::material_allocator;
 }
 
+UploadRingBuffer& upload_ring_buffer() {
+    return *device::upload_ring_buffer;
+}
+
+PipelineCache& pipeline_cache() {
+    return *device::pipeline_cache;
+}
+
 TextureLibrary& texture_library() {
     return *device::texture_library;
 }
@@ -54,6 +54,8 @@ DeviceMemoryAllocator& device_allocator();
 DescriptorSetAllocator& descriptor_set_allocator();
 MeshAllocator& mesh_allocator();
 MaterialAllocator& material_allocator();
+UploadRingBuffer& upload_ring_buffer();
+PipelineCache& pipeline_cache();
 TextureLibrary& texture_library();
 CmdQueue& command_queue();
 CmdQueue& loading_command_queue();
@@ -27,6 +27,7 @@ SOFTWARE.
 #include <yave/graphics/barriers/Barrier.h>
 #include <yave/graphics/commands/CmdQueue.h>
 #include <yave/graphics/memory/DeviceMemoryAllocator.h>
+#include <yave/graphics/device/UploadRingBuffer.h>
 #include <yave/graphics/graphics.h>
 
 #include <y/core/ScratchPad.h>
@@ -60,7 +61,7 @@ static VkHandle<VkImage> create_image(const math::Vec3ui& size, usize layers, us
     return image;
 }
 
-static core::ScratchPad<VkBufferImageCopy> get_copy_regions(const ImageData& data) {
+static core::ScratchPad<VkBufferImageCopy> get_copy_regions(const ImageData& data, u64 buffer_offset) {
     core::ScratchPad<VkBufferImageCopy> regions(data.mipmaps());
 
     usize index = 0;
@@ -68,7 +69,7 @@ static core::ScratchPad<VkBufferImageCopy> get_copy_regions(const ImageData& dat
         const auto size = data.mip_size(m);
         VkBufferImageCopy copy = {};
         {
-            copy.bufferOffset = data.data_offset(m);
+            copy.bufferOffset = buffer_offset + data.data_offset(m);
             copy.imageExtent = {size.x(), size.y(), size.z()};
             copy.imageSubresource.aspectMask = data.format().vk_aspect();
             copy.imageSubresource.mipLevel = u32(m);
@@ -83,7 +84,8 @@ static core::ScratchPad<VkBufferImageCopy> get_copy_regions(const ImageData& dat
 
 static auto create_staging_buffer(usize byte_size, const void* data) {
     y_profile();
-    auto staging_buffer = StagingBuffer(byte_size);
+    // Buffer offsets must be a multiple of the texel block size, which the ring's minimum alignment covers
+    auto staging_buffer = upload_ring_buffer().alloc(byte_size);
     {
         y_profile_zone("copy");
         if(data) {
@@ -130,14 +132,14 @@ static void upload_data(ImageBase& image, const ImageData& data) {
     y_profile();
 
     const auto staging_buffer = create_staging_buffer(data.byte_size(), data.data());
-    const auto regions = get_copy_regions(data);
+    const auto regions = get_copy_regions(data, staging_buffer.buffer().byte_offset());
 
     TransferCmdBufferRecorder recorder = create_disposable_transfer_cmd_buffer();
 
     {
         const auto region = recorder.region("Image upload");
         recorder.barriers({ImageBarrier::transition_barrier(image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)});
-        vkCmdCopyBufferToImage(recorder.vk_cmd_buffer(), staging_buffer.vk_buffer(), image.vk_image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, u32(regions.size()), regions.data());
+        vkCmdCopyBufferToImage(recorder.vk_cmd_buffer(), staging_buffer.buffer().vk_buffer(), image.vk_image(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, u32(regions.size()), regions.data());
         recorder.barriers({ImageBarrier::transition_barrier(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, vk_image_layout(image.usage()))});
     }
 
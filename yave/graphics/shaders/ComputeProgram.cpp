@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <yave/graphics/graphics.h>
 #include <yave/graphics/descriptors/DescriptorSetAllocator.h>
+#include <yave/graphics/device/PipelineCache.h>
 
 #include <y/core/ScratchPad.h>
 #include <y/utils/log.h>
@@ -79,7 +80,7 @@ ComputeProgram::ComputeProgram(const ComputeShader& comp, const SpecializationDa
         create_info.stage = stage;
     }
 
-    vk_check(vkCreateComputePipelines(vk_device(), {}, 1, &create_info, vk_allocation_callbacks(), _pipeline.get_ptr_for_init()));
+    vk_check(vkCreateComputePipelines(vk_device(), pipeline_cache().vk_pipeline_cache(), 1, &create_info, vk_allocation_callbacks(), _pipeline.get_ptr_for_init()));
 }
 
 ComputeProgram::~ComputeProgram() {
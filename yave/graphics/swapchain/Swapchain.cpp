@@ -32,6 +32,7 @@ SOFTWARE.
 
 #include <y/core/FixedArray.h>
 #include <y/core/ScratchPad.h>
+#include <y/core/FrameArena.h>
 #include <y/utils/log.h>
 
 namespace yave {
@@ -167,7 +168,9 @@ static VkHandle<VkSurfaceKHR> create_surface(Window* window) {
     y_profile();
 
 #if defined(Y_OS_WIN) || defined(Y_OS_LINUX)
-    return create_surface(window->instance(), window->handle());
+    VkHandle<VkSurfaceKHR> surface;
+    *surface.get_ptr_for_init() = create_surface(window->instance(), window->handle());
+    return surface;
 #endif
 
     unused(window);
@@ -336,6 +339,12 @@ core::Result<FrameToken> Swapchain::next_frame() {
 
     y_profile_frame_begin();
 
+    {
+        const core::FrameArena::FrameStats arena_stats = core::FrameArena::next_frame();
+        y_profile_plot("Frame arena allocations", i64(arena_stats.allocations));
+        y_profile_plot("Frame arena bytes", i64(arena_stats.allocated_bytes));
+    }
+
     if(_images.is_empty()) {
         if(!reset()) {
             return core::Err();
@@ -24,12 +24,15 @@ SOFTWARE.
 
 #include <yave/graphics/framebuffer/RenderPass.h>
 #include <yave/graphics/shaders/ShaderProgram.h>
+#include <yave/graphics/device/PipelineCache.h>
 #include <yave/meshes/Vertex.h>
 #include <yave/graphics/graphics.h>
 
 #include <y/core/ScratchPad.h>
 #include <y/core/Chrono.h>
 
+#include <y/concurrent/StaticThreadPool.h>
+
 #include <y/utils/log.h>
 #include <y/utils/format.h>
 
@@ -97,18 +100,66 @@ static GeometryShader create_geometry_shader(const SpirVData& geom) {
 
 
 
+MaterialShaders::MaterialShaders(const MaterialTemplateData& data) :
+        frag(data._frag),
+        vert(data._vert),
+        geom(create_geometry_shader(data._geom)),
+        program(frag, vert, geom) {
+}
+
+MaterialCompiler::PrecompileReport MaterialCompiler::precompile(core::Span<const MaterialTemplate*> templates) {
+    y_profile();
+
+    const core::Chrono timer;
+
+    // Pipelines only need a compatible render pass, one per layout is enough
+    core::Vector<std::unique_ptr<RenderPass>> render_passes;
+    const auto find_render_pass = [&](const RenderPass::Layout& layout) -> const RenderPass* {
+        for(const auto& render_pass : render_passes) {
+            if(render_pass->layout() == layout) {
+                return render_pass.get();
+            }
+        }
+        return render_passes.emplace_back(std::make_unique<RenderPass>(layout)).get();
+    };
+
+    PrecompileReport report;
+    report.templates = templates.size();
+
+    {
+        concurrent::StaticThreadPool thread_pool;
+        core::Vector<std::future<std::shared_ptr<const GraphicPipeline>>> futures;
+
+        for(const MaterialTemplate* material : templates) {
+            for(const RenderPass::Layout& layout : pipeline_cache().known_layouts(material->hash())) {
+                const RenderPass* render_pass = find_render_pass(layout);
+                futures.emplace_back(thread_pool.schedule_with_future([=] {
+                    y_profile_zone("precompile pipeline");
+                    return material->compile(*render_pass);
+                }));
+            }
+        }
+
+        for(auto& future : futures) {
+            future.get();
+        }
+
+        report.pipelines = futures.size();
+    }
+
+    report.time = timer.elapsed();
+    log_msg(fmt("Precompiled {} pipelines for {} material templates in {}ms", report.pipelines, report.templates, report.time.to_millis()));
+
+    return report;
+}
+
 GraphicPipeline MaterialCompiler::compile(const MaterialTemplate* material, const RenderPass& render_pass) {
     y_profile();
 
     core::DebugTimer _("MaterialCompiler::compile", core::Duration::milliseconds(2));
-    Y_TODO(move program creation programs can be reused)
 
     const auto& mat_data = material->data();
-
-    const FragmentShader frag = FragmentShader(mat_data._frag);
-    const VertexShader vert = VertexShader(mat_data._vert);
-    const GeometryShader geom = create_geometry_shader(mat_data._geom);
-    const ShaderProgram program(frag, vert, geom);
+    const ShaderProgram& program = material->shaders().program;
 
     core::ScratchVector<VkPipelineShaderStageCreateInfo> pipeline_shader_stages(program.vk_pipeline_stage_info());
     if(render_pass.is_depth_only()) {
@@ -237,7 +288,7 @@ GraphicPipeline MaterialCompiler::compile(const MaterialTemplate* material, cons
     }
 
     VkHandle<VkPipeline> pipeline;
-    vk_check(vkCreateGraphicsPipelines(vk_device(), {}, 1, &create_info, vk_allocation_callbacks(), pipeline.get_ptr_for_init()));
+    vk_check(vkCreateGraphicsPipelines(vk_device(), pipeline_cache().vk_pipeline_cache(), 1, &create_info, vk_allocation_callbacks(), pipeline.get_ptr_for_init()));
     return GraphicPipeline(std::move(pipeline), std::move(pipeline_layout));
 }
 
@@ -24,11 +24,34 @@ SOFTWARE.
 
 #include "GraphicPipeline.h"
 
+#include <yave/graphics/shaders/ShaderProgram.h>
+
+#include <y/core/Chrono.h>
+
 namespace yave {
 
+// Shader modules and reflection data, shared by every pipeline compiled from the same template
+struct MaterialShaders : NonMovable {
+    MaterialShaders(const MaterialTemplateData& data);
+
+    const FragmentShader frag;
+    const VertexShader vert;
+    const GeometryShader geom;
+    const ShaderProgram program;
+};
+
 class MaterialCompiler {
     public:
+        struct PrecompileReport {
+            usize templates = 0;
+            usize pipelines = 0;
+            core::Duration time;
+        };
+
         static GraphicPipeline compile(const MaterialTemplate* material, const RenderPass& render_pass);
+
+        // Compiles, in parallel, every pipeline the pipeline cache has seen for these templates during previous runs
+        static PrecompileReport precompile(core::Span<const MaterialTemplate*> templates);
 };
 
 
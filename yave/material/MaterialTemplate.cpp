@@ -19,56 +19,127 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 **********************************/
+
 #include "MaterialTemplate.h"
 #include "MaterialCompiler.h"
 
 #include <yave/graphics/graphics.h>
 #include <yave/graphics/framebuffer/RenderPass.h>
+#include <yave/graphics/device/PipelineCache.h>
 #include <yave/graphics/device/extensions/DebugUtils.h>
 
+#include <y/core/Vector.h>
+
 #include <y/utils/log.h>
 #include <y/utils/format.h>
 
 #include <mutex>
+#include <algorithm>
 
 namespace yave {
 
-MaterialTemplate::MaterialTemplate(MaterialTemplateData&& data) : _data(std::move(data)) {
+struct MaterialTemplate::CompiledPipelines {
+    struct Entry {
+        RenderPass::Layout layout;
+        std::shared_ptr<const GraphicPipeline> pipeline;
+        u64 last_use = 0;
+    };
+
+    std::shared_ptr<const GraphicPipeline> find(const RenderPass::Layout& layout) {
+        for(Entry& entry : pipelines) {
+            if(entry.layout == layout) {
+                entry.last_use = ++use_counter;
+                return entry.pipeline;
+            }
+        }
+        return nullptr;
+    }
+
+    void evict_least_recently_used() {
+        const auto it = std::min_element(pipelines.begin(), pipelines.end(), [](const Entry& a, const Entry& b) { return a.last_use < b.last_use; });
+        log_msg("Discarding graphic pipeline", Log::Warning);
+        std::swap(*it, pipelines.last());
+        pipelines.pop();
+    }
+
+    std::mutex lock;
+
+    std::unique_ptr<MaterialShaders> shaders;
+
+    core::Vector<Entry> pipelines;
+    u64 use_counter = 0;
+};
+
+
+MaterialTemplate::MaterialTemplate() : _compiled(std::make_unique<CompiledPipelines>()) {
+}
+
+MaterialTemplate::MaterialTemplate(MaterialTemplateData&& data) :
+        _compiled(std::make_unique<CompiledPipelines>()),
+        _data(std::move(data)),
+        _hash(_data.hash()) {
+}
+
+MaterialTemplate::~MaterialTemplate() {
 }
 
-const GraphicPipeline& MaterialTemplate::compile(const RenderPass& render_pass) const {
-    Y_TODO(make material compilation thread safe?)
+MaterialTemplate::MaterialTemplate(MaterialTemplate&&) = default;
+MaterialTemplate& MaterialTemplate::operator=(MaterialTemplate&&) = default;
+
+std::shared_ptr<const GraphicPipeline> MaterialTemplate::compile(const RenderPass& render_pass) const {
     if(!render_pass.vk_render_pass()) {
         y_fatal("Unable to compile material: null renderpass");
     }
 
     const auto& key = render_pass.layout();
-    const auto it = _compiled.find(key);
-    if(it == _compiled.end()) {
-        if(_compiled.size() == max_compiled_pipelines) {
-            log_msg("Discarding graphic pipeline", Log::Warning);
-            std::move(_compiled.begin() + 1, _compiled.end(), _compiled.begin());
-            _compiled.pop();
+
+    {
+        const auto lock = std::unique_lock(_compiled->lock);
+        if(auto pipeline = _compiled->find(key)) {
+            return pipeline;
         }
+    }
 
-        _compiled.insert(key, MaterialCompiler::compile(this, render_pass));
+    // Compile without holding the lock so other layouts can be compiled in parallel
+    auto pipeline = std::make_shared<const GraphicPipeline>(MaterialCompiler::compile(this, render_pass));
+    pipeline_cache().add_known_layout(_hash, key);
 
 #ifdef Y_DEBUG
-        if(const auto* debug = debug_utils(); debug && !_name.is_empty()) {
-            debug->set_resource_name(_compiled.last().second.vk_pipeline(), _name.data());
-        }
+    if(const auto* debug = debug_utils(); debug && !_name.is_empty()) {
+        debug->set_resource_name(pipeline->vk_pipeline(), _name.data());
+    }
 #endif
 
-        return _compiled.last().second;
+    const auto lock = std::unique_lock(_compiled->lock);
+    if(auto existing = _compiled->find(key)) {
+        // Another thread compiled the same layout first
+        return existing;
+    }
+
+    if(_compiled->pipelines.size() == max_compiled_pipelines) {
+        _compiled->evict_least_recently_used();
     }
-    return it->second;
+
+    _compiled->pipelines << CompiledPipelines::Entry{key, pipeline, ++_compiled->use_counter};
+    return pipeline;
 }
 
+const MaterialShaders& MaterialTemplate::shaders() const {
+    const auto lock = std::unique_lock(_compiled->lock);
+    if(!_compiled->shaders) {
+        _compiled->shaders = std::make_unique<MaterialShaders>(_data);
+    }
+    return *_compiled->shaders;
+}
 
 const MaterialTemplateData& MaterialTemplate::data() const {
     return _data;
 }
 
+u64 MaterialTemplate::hash() const {
+    return _hash;
+}
+
 void MaterialTemplate::set_name(const char* name) {
     unused(name);
 #ifdef Y_DEBUG
@@ -77,4 +148,3 @@ void MaterialTemplate::set_name(const char* name) {
 }
 
 }
-
@@ -27,9 +27,10 @@ SOFTWARE.
 #include <yave/graphics/framebuffer/RenderPass.h>
 #include <yave/graphics/descriptors/DescriptorSet.h>
 
-#include <y/core/AssocVector.h>
 #include <y/core/String.h>
 
+#include <memory>
+
 #include "GraphicPipeline.h"
 #include "MaterialTemplateData.h"
 
@@ -40,21 +41,33 @@ class MaterialTemplate final {
     public:
         static constexpr usize max_compiled_pipelines = 8;
 
-        MaterialTemplate() = default;
+        MaterialTemplate();
         MaterialTemplate(MaterialTemplateData&& data);
+        ~MaterialTemplate();
+
+        MaterialTemplate(MaterialTemplate&&);
+        MaterialTemplate& operator=(MaterialTemplate&&);
 
-        const GraphicPipeline& compile(const RenderPass& render_pass) const;
+        // Thread safe. Pipelines are cached per render pass layout, the least recently used is discarded when full
+        // Discarded pipelines stay alive as long as the returned pointer, their Vulkan objects are then destroyed once the GPU is done with them
+        std::shared_ptr<const GraphicPipeline> compile(const RenderPass& render_pass) const;
 
         const MaterialTemplateData& data() const;
+        u64 hash() const;
 
         void set_name(const char* name);
 
     private:
-        //void swap(Material& other);
+        friend class MaterialCompiler;
+
+        struct CompiledPipelines;
+
+        const MaterialShaders& shaders() const;
 
-        mutable core::AssocVector<RenderPass::Layout, GraphicPipeline> _compiled;
+        std::unique_ptr<CompiledPipelines> _compiled;
 
         MaterialTemplateData _data;
+        u64 _hash = 0;
 
 #ifdef Y_DEBUG
         core::String _name;
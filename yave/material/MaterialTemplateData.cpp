@@ -24,8 +24,14 @@ SOFTWARE.
 
 #include <yave/graphics/shaders/ShaderModule.h>
 
+#include <y/utils/hash.h>
+
 namespace yave {
 
+static u64 hash_spirv(const SpirVData& data) {
+    return u64(hash_range(data.data(), data.data() + data.size() / sizeof(u32)));
+}
+
 MaterialTemplateData& MaterialTemplateData::set_frag_data(const SpirVData& data) {
     y_debug_assert(ShaderModuleBase::shader_type(data) == ShaderType::Fragment);
     _frag = data;
@@ -69,6 +75,18 @@ MaterialTemplateData& MaterialTemplateData::set_cull_mode(CullMode cull) {
     return *this;
 }
 
+u64 MaterialTemplateData::hash() const {
+    u64 h = hash_spirv(_frag);
+    hash_combine(h, hash_spirv(_vert));
+    hash_combine(h, hash_spirv(_geom));
+    hash_combine(h, u64(_primitive_type));
+    hash_combine(h, u64(_depth_mode));
+    hash_combine(h, u64(_blend_mode));
+    hash_combine(h, u64(_cull_mode));
+    hash_combine(h, u64(_depth_write));
+    return h;
+}
+
 
 }
 
@@ -66,9 +66,12 @@ class MaterialTemplateData {
 
         MaterialTemplateData& set_cull_mode(CullMode cull);
 
+        // Stable across runs, used to identify templates in the pipeline cache
+        u64 hash() const;
 
     private:
         friend class MaterialCompiler;
+        friend struct MaterialShaders;
 
         SpirVData _frag;
         SpirVData _vert;
@@ -80,10 +80,23 @@ const MeshDrawCommand& MeshDrawData::draw_command() const {
     return _command;
 }
 
+core::Span<MeshDrawCommand> MeshDrawData::sub_meshes() const {
+    return _sub_meshes;
+}
+
 void MeshDrawData::swap(MeshDrawData& other) {
     std::swap(_command, other._command);
     std::swap(_vertex_count, other._vertex_count);
     std::swap(_mesh_buffers, other._mesh_buffers);
+    _sub_meshes.swap(other._sub_meshes);
+
+    // The allocator keeps track of live meshes to patch them when defragmenting
+    if(_mesh_buffers) {
+        _mesh_buffers->parent()->relink(this);
+    }
+    if(other._mesh_buffers) {
+        other._mesh_buffers->parent()->relink(&other);
+    }
 }
 
 }
@@ -26,6 +26,8 @@ SOFTWARE.
 
 #include <yave/graphics/buffers/Buffer.h>
 
+#include <y/core/FixedArray.h>
+
 #include <memory>
 
 namespace yave {
@@ -83,6 +85,7 @@ class MeshDrawData : NonCopyable {
         TriangleSubBuffer triangle_buffer() const;
 
         const MeshDrawCommand& draw_command() const;
+        core::Span<MeshDrawCommand> sub_meshes() const;
 
     private:
         friend class LifetimeManager;
@@ -96,6 +99,8 @@ class MeshDrawData : NonCopyable {
         MeshDrawCommand _command = {};
         u32 _vertex_count = 0;
 
+        core::FixedArray<MeshDrawCommand> _sub_meshes;
+
         MeshDrawBuffers* _mesh_buffers = nullptr;
 };
 
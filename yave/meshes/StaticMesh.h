@@ -27,8 +27,6 @@ SOFTWARE.
 
 #include <yave/assets/AssetTraits.h>
 
-#include <y/core/FixedArray.h>
-
 Y_TODO(move into graphics?)
 
 namespace yave {
@@ -54,7 +52,6 @@ class StaticMesh : NonCopyable {
 
     private:
         MeshDrawData _draw_data = {};
-        core::FixedArray<MeshDrawCommand> _sub_meshes;
         AABB _aabb;
 };
 
@@ -40,7 +40,7 @@ namespace yave {
 
 
 static const AtmosphereComponent* find_atmosphere_component(const SceneView& scene) {
-    for(const auto& [id, comp] : scene.world().query<AtmosphereComponent>(ecs::tags::not_hidden)) {
+    for(const auto& [id, comp] : scene.world().cached_query<AtmosphereComponent>(ecs::tags::not_hidden)) {
         const auto& [atmo] = comp;
         return &atmo;
     }
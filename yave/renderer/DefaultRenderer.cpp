@@ -33,7 +33,7 @@ DefaultRenderer DefaultRenderer::create(FrameGraph& framegraph, const SceneView&
     DefaultRenderer renderer;
 
     renderer.camera         = CameraBufferPass::create(framegraph, scene_view, size, settings.taa);
-    renderer.gbuffer        = GBufferPass::create(framegraph, renderer.camera, size);
+    renderer.gbuffer        = GBufferPass::create(framegraph, renderer.camera, size, settings.culling);
     renderer.ssao           = SSAOPass::create(framegraph, renderer.gbuffer, settings.ssao);
     renderer.lighting       = LightingPass::create(framegraph, renderer.gbuffer, renderer.ssao.ao, settings.lighting);
     renderer.atmosphere     = AtmospherePass::create(framegraph, renderer.gbuffer, renderer.lighting.lit);
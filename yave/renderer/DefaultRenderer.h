@@ -38,6 +38,7 @@ struct RendererSettings {
     SSAOSettings ssao;
     BloomSettings bloom;
     TAASettings taa;
+    GPUCullingSettings culling;
 };
 
 struct DefaultRenderer {
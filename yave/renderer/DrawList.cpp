@@ -0,0 +1,125 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "DrawList.h"
+
+#include <y/utils/sort.h>
+
+#include <bit>
+
+namespace yave {
+
+static_assert(DrawList::template_bits < 32 && DrawList::material_bits < 32 && DrawList::mesh_bits < 32);
+
+u32 DrawList::depth_bucket(float depth) {
+    // Exponent and 3 mantissa bits of the distance, which gives logarithmic buckets from 2^-9 to 2^23
+    static constexpr u32 min_bucket = 118 << 3;
+    static constexpr u32 max_bucket = (1 << depth_bits) - 1;
+
+    const u32 bits = std::bit_cast<u32>(std::max(depth, 0.0f)) >> 20;
+    return std::min(max_bucket, bits - std::min(bits, min_bucket));
+}
+
+u64 DrawList::make_key(u32 template_id, u32 material_id, u32 mesh_id, float depth) {
+    y_debug_assert(template_id < (1 << template_bits));
+    y_debug_assert(material_id < (1 << material_bits));
+    y_debug_assert(mesh_id < (1 << mesh_bits));
+
+    u64 key = template_id;
+    key = (key << material_bits) | material_id;
+    key = (key << mesh_bits) | mesh_id;
+    key = (key << depth_bits) | depth_bucket(depth);
+    return key;
+}
+
+u32 DrawList::compact_id(IdMap& ids, const void* ptr) {
+    if(const auto it = ids.find(ptr); it != ids.end()) {
+        return it->second;
+    }
+    const u32 id = u32(ids.size());
+    ids.emplace(ptr, id);
+    return id;
+}
+
+void DrawList::clear() {
+    _template_ids.make_empty();
+    _material_ids.make_empty();
+    _mesh_ids.make_empty();
+    _keys.make_empty();
+    _indices.make_empty();
+    _batches.make_empty();
+}
+
+void DrawList::reserve(usize draw_count) {
+    draw_count = std::min(draw_count, max_draws);
+    _keys.set_min_capacity(draw_count);
+    _indices.set_min_capacity(draw_count);
+}
+
+bool DrawList::push(const void* material_template, const void* material, const void* mesh, float depth, u32 index) {
+    // Material and mesh ids can not exceed the number of draws
+    if(_keys.size() >= max_draws) {
+        return false;
+    }
+
+    if(_template_ids.size() >= max_templates && !_template_ids.contains(material_template)) {
+        return false;
+    }
+
+    const u32 template_id = compact_id(_template_ids, material_template);
+    _keys << make_key(template_id, compact_id(_material_ids, material), compact_id(_mesh_ids, mesh), depth);
+    _indices << index;
+
+    return true;
+}
+
+void DrawList::sort() {
+    y_profile();
+
+    const usize count = _keys.size();
+    _keys_buffer.set_min_size(count);
+    _indices_buffer.set_min_size(count);
+    radix_sort(_keys.data(), _indices.data(), count, _keys_buffer.data(), _indices_buffer.data());
+
+    _batches.make_empty();
+    for(usize i = 0; i != count; ++i) {
+        const u64 key = _keys[i] >> depth_bits;
+        if(_batches.is_empty() || _batches.last().key != key) {
+            _batches.emplace_back(key, u32(i), 0u);
+        }
+        ++_batches.last().count;
+    }
+}
+
+usize DrawList::size() const {
+    return _keys.size();
+}
+
+core::Span<u32> DrawList::indices() const {
+    return _indices;
+}
+
+core::Span<DrawList::Batch> DrawList::batches() const {
+    return _batches;
+}
+
+}
@@ -0,0 +1,90 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_RENDERER_DRAWLIST_H
+#define YAVE_RENDERER_DRAWLIST_H
+
+#include <yave/yave.h>
+
+#include <y/core/FrameArena.h>
+
+namespace yave {
+
+// Sorts draws by (template, material, mesh, depth) and groups identical template/material/mesh into instanced batches.
+// Depth is the least significant part of the key: it only orders instances inside a batch (front to back).
+// For opaque geometry pipeline and descriptor changes cost more than the overdraw we would save by sorting on depth first,
+// so this should not be used when strict depth ordering is needed (transparency).
+// All storage comes from the calling thread's frame arena: a DrawList is scratch data and must not be kept across frames.
+class DrawList : NonCopyable {
+    public:
+        static constexpr usize depth_bits = 8;
+        static constexpr usize mesh_bits = 22;
+        static constexpr usize material_bits = 22;
+        static constexpr usize template_bits = 12;
+
+        static_assert(depth_bits + mesh_bits + material_bits + template_bits == 64);
+
+        struct Batch {
+            u64 key = 0;
+            u32 first = 0;
+            u32 count = 0;
+        };
+
+        static u64 make_key(u32 template_id, u32 material_id, u32 mesh_id, float depth);
+        static u32 depth_bucket(float depth);
+
+        static constexpr usize max_draws = usize(1) << std::min(material_bits, mesh_bits);
+        static constexpr usize max_templates = usize(1) << template_bits;
+
+        void clear();
+        void reserve(usize draw_count);
+
+        // index is returned, in sorted order, by indices()
+        // Returns false, and ignores the draw, if the list is full
+        bool push(const void* material_template, const void* material, const void* mesh, float depth, u32 index);
+
+        void sort();
+
+        usize size() const;
+
+        core::Span<u32> indices() const;
+        core::Span<Batch> batches() const;
+
+    private:
+        using IdMap = core::FrameHashMap<const void*, u32>;
+
+        static u32 compact_id(IdMap& ids, const void* ptr);
+
+        IdMap _template_ids;
+        IdMap _material_ids;
+        IdMap _mesh_ids;
+
+        core::FrameVector<u64> _keys;
+        core::FrameVector<u32> _indices;
+        core::FrameVector<u64> _keys_buffer;
+        core::FrameVector<u32> _indices_buffer;
+
+        core::FrameVector<Batch> _batches;
+};
+
+}
+
+#endif // YAVE_RENDERER_DRAWLIST_H
@@ -29,13 +29,15 @@ SOFTWARE.
 
 namespace yave {
 
-GBufferPass GBufferPass::create(FrameGraph& framegraph, const CameraBufferPass& camera, const math::Vec2ui& size) {
+GBufferPass GBufferPass::create(FrameGraph& framegraph, const CameraBufferPass& camera, const math::Vec2ui& size, const GPUCullingSettings& culling_settings) {
     static constexpr ImageFormat depth_format = VK_FORMAT_D32_SFLOAT;
     static constexpr ImageFormat motion_format = VK_FORMAT_R16G16_SFLOAT;
     static constexpr ImageFormat color_format = VK_FORMAT_R8G8B8A8_SRGB;
     static constexpr ImageFormat normal_format = VK_FORMAT_A2R10G10B10_UNORM_PACK32;
     static constexpr ImageFormat emissive_format = VK_FORMAT_B10G11R11_UFLOAT_PACK32;
 
+    const GPUCullingPass culling = GPUCullingPass::create(framegraph, camera, culling_settings);
+
     FrameGraphPassBuilder builder = framegraph.add_pass("G-buffer pass");
 
     const auto depth = builder.declare_image(depth_format, size);
@@ -50,7 +52,7 @@ GBufferPass GBufferPass::create(FrameGraph& framegraph, const CameraBufferPass&
     pass.color = color;
     pass.normal = normal;
     pass.emissive = emissive;
-    pass.scene_pass = SceneRenderSubPass::create(builder, camera);
+    pass.scene_pass = culling.is_enabled() ? SceneRenderSubPass::create(builder, camera, culling) : SceneRenderSubPass::create(builder, camera);
 
     builder.add_depth_output(depth);
     builder.add_color_output(motion);
@@ -62,6 +64,10 @@ GBufferPass GBufferPass::create(FrameGraph& framegraph, const CameraBufferPass&
         pass.scene_pass.render(render_pass, self);
     });
 
+    if(culling.is_enabled() && culling_settings.occlusion_culling) {
+        GPUCullingPass::build_depth_pyramid(framegraph, depth);
+    }
+
     return pass;
 }
 
@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_RENDERER_GBUFFERPASS_H
 
 #include "SceneRenderSubPass.h"
+#include "GPUCullingPass.h"
 
 namespace yave {
 
@@ -35,7 +36,7 @@ struct GBufferPass {
     FrameGraphImageId normal;
     FrameGraphImageId emissive;
 
-    static GBufferPass create(FrameGraph& framegraph, const CameraBufferPass& camera, const math::Vec2ui& size);
+    static GBufferPass create(FrameGraph& framegraph, const CameraBufferPass& camera, const math::Vec2ui& size, const GPUCullingSettings& culling_settings = {});
 };
 
 }
@@ -0,0 +1,170 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "GPUCullingPass.h"
+
+#include <yave/camera/Camera.h>
+
+#include <yave/framegraph/FrameGraph.h>
+#include <yave/framegraph/FrameGraphPass.h>
+#include <yave/framegraph/FrameGraphFrameResources.h>
+
+#include <yave/graphics/device/DeviceResources.h>
+#include <yave/graphics/commands/CmdBufferRecorder.h>
+#include <yave/graphics/shaders/ComputeProgram.h>
+#include <yave/graphics/images/Image.h>
+
+#include <yave/ecs/EntityWorld.h>
+
+namespace yave {
+
+static const std::array<FrameGraphPersistentResourceId, GPUCullingPass::hiz_levels>& hiz_persistent_ids() {
+    static const auto ids = [] {
+        std::array<FrameGraphPersistentResourceId, GPUCullingPass::hiz_levels> ids;
+        for(auto& id : ids) {
+            id = FrameGraphPersistentResourceId::create();
+        }
+        return ids;
+    }();
+    return ids;
+}
+
+
+bool GPUCullingPass::is_enabled() const {
+    return draws.is_valid();
+}
+
+GPUCullingPass GPUCullingPass::create(FrameGraph& framegraph, const CameraBufferPass& camera, const GPUCullingSettings& settings) {
+    GPUCullingPass pass;
+    pass.scene_view = camera.view;
+
+    if(!settings.enable || !pass.scene_view.has_world()) {
+        return pass;
+    }
+
+    const RendererSystem* renderer = pass.scene_view.world().find_system<RendererSystem>();
+    if(!renderer || renderer->transform_buffer().is_null()) {
+        return pass;
+    }
+
+    const RendererSystem::StaticMeshManager& static_meshes = renderer->static_meshes();
+    const usize instance_count = static_meshes.instance_count();
+    if(!instance_count) {
+        return pass;
+    }
+
+    struct CullingParams {
+        math::Vec4 frustum_planes[5];
+
+        u32 instance_count;
+        u32 occlusion_culling;
+        math::Vec2ui hiz_size;
+    } params = {};
+
+    static_assert(sizeof(CullingParams) % 16 == 0);
+
+    {
+        const Frustum frustum = camera.unjittered_view.camera().frustum();
+        for(usize i = 0; i != 5; ++i) {
+            const Frustum::Plane& plane = frustum.planes()[i];
+            params.frustum_planes[i] = math::Vec4(plane.normal, -(plane.normal.dot(frustum.position()) + plane.offset));
+        }
+    }
+
+    std::array<FrameGraphImageId, hiz_levels> hiz;
+    for(usize i = 0; i != hiz_levels; ++i) {
+        hiz[i] = framegraph.get_prev_image(hiz_persistent_ids()[i]);
+    }
+
+    params.instance_count = u32(instance_count);
+    params.occlusion_culling = settings.occlusion_culling && hiz[0].is_valid();
+    params.hiz_size = hiz[0].is_valid() ? framegraph.image_size(hiz[0]) : math::Vec2ui(1);
+
+    pass.groups = static_meshes.groups();
+
+    const auto region = framegraph.region("GPU culling");
+
+    FrameGraphComputePassBuilder builder = framegraph.add_compute_pass("Static mesh culling pass");
+
+    pass.draws = builder.declare_typed_buffer<VkDrawIndexedIndirectCommand>(instance_count);
+    pass.indices = builder.declare_typed_buffer<math::Vec2ui>(instance_count);
+    pass.draw_counts = builder.declare_typed_buffer<u32>(pass.groups.size());
+
+    const auto params_buffer = builder.declare_typed_buffer<CullingParams>();
+
+    builder.map_buffer(params_buffer, params);
+    builder.map_buffer(pass.draw_counts);
+
+    const Texture& black = *device_resources()[DeviceResources::BlackTexture];
+
+    builder.add_uniform_input(camera.camera);
+    builder.add_uniform_input(params_buffer);
+    builder.add_external_input(Descriptor(static_meshes.instance_buffer()));
+    builder.add_external_input(Descriptor(renderer->transform_buffer()));
+    builder.add_storage_output(pass.draws);
+    builder.add_storage_output(pass.indices);
+    builder.add_storage_output(pass.draw_counts);
+    builder.add_external_input(Descriptor(static_meshes.stats_buffer()));
+    for(const FrameGraphImageId level : hiz) {
+        builder.add_uniform_input_with_default(level, Descriptor(black));
+    }
+
+    builder.set_render_func([=, draw_counts = pass.draw_counts, group_count = pass.groups.size()](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+        {
+            auto counts = self->resources().map_buffer(draw_counts);
+            std::fill_n(counts.data(), group_count, 0u);
+        }
+
+        const auto& program = device_resources()[DeviceResources::CullStaticMeshesProgram];
+        recorder.dispatch_size(program, math::Vec2ui(u32(instance_count), 1), self->descriptor_sets());
+    });
+
+    return pass;
+}
+
+void GPUCullingPass::build_depth_pyramid(FrameGraph& framegraph, FrameGraphImageId depth) {
+    const auto region = framegraph.region("Depth pyramid");
+
+    FrameGraphImageId prev_level = depth;
+    math::Vec2ui size = framegraph.image_size(depth);
+
+    for(usize i = 0; i != hiz_levels; ++i) {
+        size = math::Vec2ui(std::max(1u, size.x() / 2), std::max(1u, size.y() / 2));
+
+        FrameGraphComputePassBuilder builder = framegraph.add_compute_pass("Depth pyramid pass");
+
+        const auto level = builder.declare_image(VK_FORMAT_R32_SFLOAT, size);
+
+        builder.add_input_usage(level, ImageUsage::TextureBit);
+        builder.add_uniform_input(prev_level, SamplerType::PointClamp);
+        builder.add_storage_output(level);
+        builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+            const auto& program = device_resources()[DeviceResources::DepthPyramidProgram];
+            recorder.dispatch_size(program, size, self->descriptor_sets());
+        });
+
+        framegraph.set_persistent(level, hiz_persistent_ids()[i]);
+        prev_level = level;
+    }
+}
+
+}
@@ -37,6 +37,7 @@ SOFTWARE.
 #include <yave/components/DirectionalLightComponent.h>
 #include <yave/components/SkyLightComponent.h>
 #include <yave/ecs/EntityWorld.h>
+#include <yave/scene/FramePacket.h>
 
 #include <y/utils/log.h>
 #include <y/utils/format.h>
@@ -51,17 +52,49 @@ static constexpr usize max_point_lights = 1024;
 static constexpr usize max_spot_lights = 1024;
 
 
-static std::tuple<const IBLProbe*, float, bool>  find_probe(const ecs::EntityWorld& world) {
+// Calls func(id, transform, light) for every visible light until it returns false.
+// Lights come from the view's frame packet if it has one, the transform is unused for directional and sky lights.
+template<typename T, typename F>
+static void for_each_light(const SceneView& scene, F&& func) {
+    if(const FramePacket* packet = scene.packet()) {
+        for(const FramePacket::Light<T>& light : packet->lights<T>()) {
+            if(!func(light.id, light.transform, light.component)) {
+                break;
+            }
+        }
+        return;
+    }
+
     const std::array tags = {ecs::tags::not_hidden};
-    for(auto id_comp : world.query<SkyLightComponent>(tags)) {
-        const SkyLightComponent& sky = id_comp.component<SkyLightComponent>();
-        if(const IBLProbe* probe = sky.probe().get()) {
-            y_debug_assert(!probe->is_null());
-            return {probe, sky.intensity(), sky.display_sky()};
+    if constexpr(std::is_same_v<T, DirectionalLightComponent> || std::is_same_v<T, SkyLightComponent>) {
+        const TransformableComponent no_transform;
+        for(auto&& [id, comp] : scene.world().cached_query<T>(tags)) {
+            const auto& [l] = comp;
+            if(!func(id, no_transform, l)) {
+                break;
+            }
+        }
+    } else {
+        for(auto&& [id, comp] : scene.world().cached_query<TransformableComponent, T>(tags)) {
+            const auto& [t, l] = comp;
+            if(!func(id, t, l)) {
+                break;
+            }
         }
     }
+}
 
-    return {device_resources().empty_probe().get(), 1.0f, true};
+static std::tuple<const IBLProbe*, float, bool>  find_probe(const SceneView& scene) {
+    std::tuple<const IBLProbe*, float, bool> found = {device_resources().empty_probe().get(), 1.0f, true};
+    for_each_light<SkyLightComponent>(scene, [&](ecs::EntityId, const TransformableComponent&, const SkyLightComponent& sky) {
+        if(const IBLProbe* probe = sky.probe().get()) {
+            y_debug_assert(!probe->is_null());
+            found = {probe, sky.intensity(), sky.display_sky()};
+            return false;
+        }
+        return true;
+    });
+    return found;
 }
 
 
@@ -71,7 +104,7 @@ static FrameGraphMutableImageId ambient_pass(FrameGraph& framegraph,
                                              FrameGraphImageId ao) {
 
     const SceneView& scene = gbuffer.scene_pass.scene_view;
-    auto [ibl_probe, intensity, sky] = find_probe(scene.world());
+    auto [ibl_probe, intensity, sky] = find_probe(scene);
     const Texture& white = *device_resources()[DeviceResources::WhiteTexture];
 
     FrameGraphPassBuilder builder = framegraph.add_pass("Ambient/Sun pass");
@@ -102,10 +135,7 @@ static FrameGraphMutableImageId ambient_pass(FrameGraph& framegraph,
         u32 count = 0;
         auto mapping = self->resources().map_buffer(directional_buffer);
 
-        const std::array tags = {ecs::tags::not_hidden};
-        for(auto&& [id, components] : scene.world().query<DirectionalLightComponent>(tags)) {
-            const auto& [l] = components;
-
+        for_each_light<DirectionalLightComponent>(scene, [&](ecs::EntityId id, const TransformableComponent&, const DirectionalLightComponent& l) {
             auto shadow_indices = math::Vec4ui(u32(-1));
             if(l.cast_shadow()) {
                 if(const auto it = shadow_pass.shadow_indices->find(id.as_u64()); it != shadow_pass.shadow_indices->end()) {
@@ -123,9 +153,10 @@ static FrameGraphMutableImageId ambient_pass(FrameGraph& framegraph,
 
             if(count == mapping.size()) {
                 log_msg("Too many directional lights, discarding...", Log::Warning);
-                break;
+                return false;
             }
-        }
+            return true;
+        });
 
         {
             auto params = self->resources().map_buffer(params_buffer);
@@ -159,13 +190,10 @@ static u32 fill_point_light_buffer(uniform::PointLight* points, const SceneView&
 
     u32 count = 0;
 
-    const std::array tags = {ecs::tags::not_hidden};
-    for(auto point : scene.world().query<TransformableComponent, PointLightComponent>(tags)) {
-        const auto& [t, l] = point.components;
-
+    for_each_light<PointLightComponent>(scene, [&](ecs::EntityId, const TransformableComponent& t, const PointLightComponent& l) {
         const float scaled_range = l.range() * t.transform().scale().max_component();
         if(!frustum.is_inside(t.position(), scaled_range)) {
-            continue;
+            return true;
         }
 
         points[count++] = {
@@ -181,9 +209,10 @@ static u32 fill_point_light_buffer(uniform::PointLight* points, const SceneView&
 
         if(count == max_point_lights) {
             log_msg("Too many point lights, discarding...", Log::Warning);
-            break;
+            return false;
         }
-    }
+        return true;
+    });
     return count;
 }
 
@@ -203,10 +232,7 @@ static u32 fill_spot_light_buffer(
 
     u32 count = 0;
 
-    const std::array tags = {ecs::tags::not_hidden};
-    for(auto&& [id, comp] : scene.world().query<TransformableComponent, SpotLightComponent>(tags)) {
-        const auto& [t, l] = comp;
-
+    for_each_light<SpotLightComponent>(scene, [&](ecs::EntityId id, const TransformableComponent& t, const SpotLightComponent& l) {
         const math::Vec3 forward = t.forward().normalized();
         const float scale = t.transform().scale().max_component();
         const float scaled_range = l.range() * scale;
@@ -219,7 +245,7 @@ static u32 fill_spot_light_buffer(
 
         const math::Vec3 encl_sphere_center =  t.position() + forward * enclosing_sphere.dist_to_center;
         if(!frustum.is_inside(encl_sphere_center, enclosing_sphere.radius)) {
-            continue;
+            return true;
         }
 
         auto shadow_indices = math::Vec4ui(u32(-1));
@@ -255,9 +281,10 @@ static u32 fill_spot_light_buffer(
 
         if(count == max_spot_lights) {
             log_msg("Too many spot lights, discarding...", Log::Warning);
-            break;
+            return false;
         }
-    }
+        return true;
+    });
 
     return count;
 }
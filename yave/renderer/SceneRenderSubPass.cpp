@@ -22,6 +22,7 @@ SOFTWARE.
 
 #include "SceneRenderSubPass.h"
 #include "TAAPass.h"
+#include "GPUCullingPass.h"
 
 #include <yave/framegraph/FrameGraph.h>
 #include <yave/framegraph/FrameGraphPass.h>
@@ -49,10 +50,14 @@ static core::Vector<ecs::EntityId> visible_entities(const SceneView& scene_view)
     return core::Vector<ecs::EntityId>(world.component_set<T>().ids());
 }
 
-static void fill_scene_render_pass(SceneRenderSubPass& pass, FrameGraphPassBuilder& builder) {
+static void fill_scene_render_pass(SceneRenderSubPass& pass, FrameGraphPassBuilder& builder, const GPUCullingPass* culling = nullptr) {
     const std::array tags = {ecs::tags::not_hidden};
 
-    pass.static_meshes_sub_pass = StaticMeshRenderSubPass::create(builder, pass.scene_view, visible_entities<StaticMeshComponent>(pass.scene_view), tags);
+    if(culling && culling->is_enabled()) {
+        pass.static_meshes_sub_pass = StaticMeshRenderSubPass::create(builder, *culling);
+    } else {
+        pass.static_meshes_sub_pass = StaticMeshRenderSubPass::create(builder, pass.scene_view, visible_entities<StaticMeshComponent>(pass.scene_view), tags);
+    }
 
     pass.main_descriptor_set_index = builder.next_descriptor_set_index();
     builder.add_uniform_input(pass.camera, PipelineStage::None, pass.main_descriptor_set_index);
@@ -82,6 +87,16 @@ SceneRenderSubPass SceneRenderSubPass::create(FrameGraphPassBuilder& builder, co
     return pass;
 }
 
+SceneRenderSubPass SceneRenderSubPass::create(FrameGraphPassBuilder& builder, const CameraBufferPass& camera, const GPUCullingPass& culling) {
+    SceneRenderSubPass pass;
+    pass.scene_view = camera.view;
+    pass.camera = camera.camera;
+
+    fill_scene_render_pass(pass, builder, &culling);
+
+    return pass;
+}
+
 void SceneRenderSubPass::render(RenderPassRecorder& render_pass, const FrameGraphPass* pass) const {
     render_pass.set_main_descriptor_set(pass->descriptor_sets()[main_descriptor_set_index]);
     static_meshes_sub_pass.render(render_pass, pass);
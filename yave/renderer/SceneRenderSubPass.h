@@ -40,6 +40,7 @@ struct SceneRenderSubPass {
 
     static SceneRenderSubPass create(FrameGraphPassBuilder& builder, const SceneView& scene_view);
     static SceneRenderSubPass create(FrameGraphPassBuilder& builder, const CameraBufferPass& camera);
+    static SceneRenderSubPass create(FrameGraphPassBuilder& builder, const CameraBufferPass& camera, const GPUCullingPass& culling);
 
     void render(RenderPassRecorder& render_pass, const FrameGraphPass* pass) const;
 
@@ -174,8 +174,8 @@ static Camera directional_camera(const Camera& cam, const DirectionalLightCompon
 
 
 struct ShadowCastingLights {
-    core::Vector<std::tuple<ecs::EntityId, const DirectionalLightComponent*>> directionals;
-    core::Vector<std::tuple<ecs::EntityId, const TransformableComponent*, const SpotLightComponent*>> spots;
+    core::FrameVector<std::tuple<ecs::EntityId, const DirectionalLightComponent*>> directionals;
+    core::FrameVector<std::tuple<ecs::EntityId, const TransformableComponent*, const SpotLightComponent*>> spots;
 };
 
 static ShadowCastingLights collect_shadow_casting_lights(const SceneView& scene) {
@@ -185,7 +185,7 @@ static ShadowCastingLights collect_shadow_casting_lights(const SceneView& scene)
     ShadowCastingLights shadow_casters;
 
     shadow_casters.directionals.set_min_capacity(world.component_set<DirectionalLightComponent>().size());
-    for(auto&& [id, comp] : world.query<DirectionalLightComponent>(tags)) {
+    for(auto&& [id, comp] : world.cached_query<DirectionalLightComponent>(tags)) {
         const auto& [l] = comp;
         if(!l.cast_shadow()) {
             continue;
@@ -208,7 +208,7 @@ static ShadowCastingLights collect_shadow_casting_lights(const SceneView& scene)
         const core::Vector<ecs::EntityId> visible = octree_system->find_entities(scene.camera());
         collect_spots(world.query<TransformableComponent, SpotLightComponent>(visible, tags));
     } else {
-        collect_spots(world.query<TransformableComponent, SpotLightComponent>(tags));
+        collect_spots(world.cached_query<TransformableComponent, SpotLightComponent>(tags));
     }
 
     return shadow_casters;
@@ -262,7 +262,7 @@ ShadowMapPass ShadowMapPass::create(FrameGraph& framegraph, const SceneView& sce
 
     ShadowMapPass pass;
     pass.shadow_map = shadow_map;
-    pass.shadow_indices = std::make_shared<core::FlatHashMap<u64, math::Vec4ui>>();
+    pass.shadow_indices = std::make_shared<core::FrameHashMap<u64, math::Vec4ui>>();
 
     core::Vector<SubPass> sub_passes;
     {
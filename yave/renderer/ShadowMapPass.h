@@ -24,7 +24,7 @@ SOFTWARE.
 
 #include "GBufferPass.h"
 
-#include <y/core/HashMap.h>
+#include <y/core/FrameArena.h>
 
 namespace yave {
 
@@ -43,7 +43,8 @@ struct ShadowMapPass {
     FrameGraphImageId shadow_map;
     FrameGraphTypedBufferId<uniform::ShadowMapParams> shadow_params;
 
-    std::shared_ptr<core::FlatHashMap<u64, math::Vec4ui>> shadow_indices;
+    // Only valid for the frame the pass was created in
+    std::shared_ptr<core::FrameHashMap<u64, math::Vec4ui>> shadow_indices;
 
     static ShadowMapPass create(FrameGraph& framegraph, const SceneView& scene, const ShadowMapSettings& settings = ShadowMapSettings());
 };
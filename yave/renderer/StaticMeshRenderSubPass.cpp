@@ -21,10 +21,11 @@ SOFTWARE.
 **********************************/
 
 #include "StaticMeshRenderSubPass_custom.h"
+#include "GPUCullingPass.h"
 
 namespace yave {
 
-StaticMeshRenderSubPass StaticMeshRenderSubPass::create(FrameGraphPassBuilder& builder, const SceneView& view, core::Vector<ecs::EntityId>&& ids, core::Span<core::String> tags) {
+StaticMeshRenderSubPass StaticMeshRenderSubPass::create(FrameGraphPassBuilder& builder, const SceneView& view, core::Vector<ecs::EntityId>&& ids, core::Span<ecs::Tag> tags) {
     y_profile();
 
     const ecs::EntityWorld& world = view.world();
@@ -49,7 +50,10 @@ StaticMeshRenderSubPass StaticMeshRenderSubPass::create(FrameGraphPassBuilder& b
     const i32 descriptor_set_index = builder.next_descriptor_set_index();
 
     const auto indices_buffer = builder.declare_typed_buffer<math::Vec2ui>(batch_count);
+    const auto indirect_buffer = builder.declare_typed_buffer<VkDrawIndexedIndirectCommand>(batch_count);
     builder.map_buffer(indices_buffer);
+    builder.map_buffer(indirect_buffer);
+    builder.add_input_usage(indirect_buffer, BufferUsage::IndirectBit);
 
     builder.add_external_input(Descriptor(renderer->transform_buffer()), stage, descriptor_set_index);
     builder.add_external_input(Descriptor(material_allocator().material_buffer()), stage, descriptor_set_index);
@@ -60,21 +64,75 @@ StaticMeshRenderSubPass StaticMeshRenderSubPass::create(FrameGraphPassBuilder& b
     pass.ids = std::move(ids);
     pass.tags = tags;
     pass.indices_buffer = indices_buffer;
+    pass.indirect_buffer = indirect_buffer;
+    pass.descriptor_set_index = descriptor_set_index;
+    return pass;
+}
+
+StaticMeshRenderSubPass StaticMeshRenderSubPass::create(FrameGraphPassBuilder& builder, const GPUCullingPass& culling) {
+    y_profile();
+
+    if(!culling.is_enabled()) {
+        return {};
+    }
+
+    const RendererSystem* renderer = culling.scene_view.world().find_system<RendererSystem>();
+    y_debug_assert(renderer);
+
+    static const PipelineStage stage = PipelineStage::VertexBit | PipelineStage::FragmentBit;
+    const i32 descriptor_set_index = builder.next_descriptor_set_index();
+
+    builder.add_external_input(Descriptor(renderer->transform_buffer()), stage, descriptor_set_index);
+    builder.add_external_input(Descriptor(material_allocator().material_buffer()), stage, descriptor_set_index);
+    builder.add_storage_input(culling.indices, stage, descriptor_set_index);
+    builder.add_input_usage(culling.draws, BufferUsage::IndirectBit);
+    builder.add_input_usage(culling.draw_counts, BufferUsage::IndirectBit);
+
+    StaticMeshRenderSubPass pass;
+    pass.scene_view = culling.scene_view;
+    pass.indices_buffer = culling.indices;
+    pass.indirect_buffer = culling.draws;
+    pass.draw_count_buffer = culling.draw_counts;
+    pass.groups = culling.groups;
     pass.descriptor_set_index = descriptor_set_index;
     return pass;
 }
 
 void StaticMeshRenderSubPass::render(RenderPassRecorder& render_pass, const FrameGraphPass* pass) const {
+    if(!indirect_buffer.is_valid()) {
+        return;
+    }
+
+    const TypedSubBuffer<VkDrawIndexedIndirectCommand, BufferUsage::IndirectBit> indirect = pass->resources().buffer<BufferUsage::IndirectBit>(indirect_buffer);
+
+    if(draw_count_buffer.is_valid()) {
+        // Draws have been compacted by the culling pass, one range per material template
+        const TypedSubBuffer<u32, BufferUsage::IndirectBit> draw_counts = pass->resources().buffer<BufferUsage::IndirectBit>(draw_count_buffer);
+        render_pass.bind_mesh_buffers(mesh_allocator().mesh_buffers());
+
+        for(usize i = 0; i != groups.size(); ++i) {
+            const std::array<DescriptorSetBase, 2> desc_sets = {pass->descriptor_sets()[descriptor_set_index], texture_library().descriptor_set()};
+            render_pass.bind_material_template(groups[i].material_template, desc_sets, true);
+            render_pass.draw_indirect_count(indirect, draw_counts, groups[i].first, i, groups[i].count);
+        }
+        return;
+    }
+
+    // Batches are sorted by template first, so every template is bound once and drawn with a single multi draw
     const MaterialTemplate* previous = nullptr;
-    render_custom(render_pass, pass, [&](ecs::EntityId, const StaticMeshComponent&, const MeshDrawCommand& draw_cmd, const Material* material, u32 instance_index) {
-        if(const MaterialTemplate* mat_template = material->material_template(); mat_template != previous) {
+    usize first_batch = 0;
+    const usize batch_count = render_custom(render_pass, pass, [&](const Batch& batch) {
+        if(const MaterialTemplate* mat_template = batch.material->material_template(); mat_template != previous) {
+            render_pass.draw_indirect(indirect, first_batch, batch.index - first_batch);
+            first_batch = batch.index;
+
             const std::array<DescriptorSetBase, 2> desc_sets = {pass->descriptor_sets()[descriptor_set_index], texture_library().descriptor_set()};
             render_pass.bind_material_template(mat_template, desc_sets, true);
             previous = mat_template;
         }
-
-        render_pass.draw(draw_cmd.vk_indirect_data(instance_index));
     });
+
+    render_pass.draw_indirect(indirect, first_batch, batch_count - first_batch);
 }
 
 
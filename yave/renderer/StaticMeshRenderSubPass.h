@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include <yave/scene/SceneView.h>
 #include <yave/framegraph/FrameGraphPass.h>
+#include <yave/ecs/tags.h>
+#include <yave/systems/RendererSystem.h>
 
 
 #include <y/core/Vector.h>
@@ -31,20 +33,38 @@ SOFTWARE.
 
 namespace yave {
 
+struct GPUCullingPass;
+
 struct StaticMeshRenderSubPass {
+    // One instanced draw: all instances share the same mesh and material
+    struct Batch {
+        const MeshDrawCommand& draw_cmd;
+        const Material* material = nullptr;
+        core::Span<ecs::EntityId> ids;
+        u32 first_instance = 0;
+        u32 index = 0;
+    };
+
     SceneView scene_view;
     core::Vector<ecs::EntityId> ids;
-    core::Vector<core::String> tags;
+    core::Vector<ecs::Tag> tags;
 
     FrameGraphMutableTypedBufferId<math::Vec2ui> indices_buffer;
+    FrameGraphMutableTypedBufferId<VkDrawIndexedIndirectCommand> indirect_buffer;
     i32 descriptor_set_index = -1;
 
-    static StaticMeshRenderSubPass create(FrameGraphPassBuilder& builder, const SceneView& view, core::Vector<ecs::EntityId>&& ids, core::Span<core::String> tags = {});
+    // Only used for GPU driven rendering
+    FrameGraphMutableTypedBufferId<u32> draw_count_buffer;
+    core::Vector<RendererSystem::StaticMeshManager::Group> groups;
+
+    static StaticMeshRenderSubPass create(FrameGraphPassBuilder& builder, const SceneView& view, core::Vector<ecs::EntityId>&& ids, core::Span<ecs::Tag> tags = {});
+    static StaticMeshRenderSubPass create(FrameGraphPassBuilder& builder, const GPUCullingPass& culling);
 
     void render(RenderPassRecorder& render_pass, const FrameGraphPass* pass) const;
 
-    template<typename RenderFunc>
-    void render_custom(RenderPassRecorder& render_pass, const FrameGraphPass* pass, RenderFunc&& render_func) const;
+    // Calls batch_func for every batch, in sorted order, and fills indirect_buffer. Returns the number of batches.
+    template<typename BatchFunc>
+    usize render_custom(RenderPassRecorder& render_pass, const FrameGraphPass* pass, BatchFunc&& batch_func) const;
 };
 
 
@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_RENDERER_STATICMESHRENDERSUBPASS_CUSTOM_H
 
 #include "StaticMeshRenderSubPass.h"
+#include "DrawList.h"
 
 #include <yave/framegraph/FrameGraph.h>
 #include <yave/framegraph/FrameGraphPass.h>
@@ -42,54 +43,105 @@ SOFTWARE.
 
 namespace yave {
 
-template<typename RenderFunc>
-void StaticMeshRenderSubPass::render_custom(RenderPassRecorder& render_pass, const FrameGraphPass* pass, RenderFunc&& render_func) const {
+template<typename BatchFunc>
+usize StaticMeshRenderSubPass::render_custom(RenderPassRecorder& render_pass, const FrameGraphPass* pass, BatchFunc&& batch_func) const {
     y_profile();
+    y_debug_assert(!draw_count_buffer.is_valid());
 
     if(!scene_view.has_world()) {
-        return;
+        return 0;
     }
 
     const ecs::EntityWorld& world = scene_view.world();
     auto query = world.query<TransformableComponent, StaticMeshComponent>(ids, tags);
     if(query.is_empty()) {
-        return;
+        return 0;
     }
 
-    render_pass.bind_mesh_buffers(mesh_allocator().mesh_buffers());
+    struct Draw {
+        ecs::EntityId id;
+        const MeshDrawCommand* draw_cmd = nullptr;
+        const Material* material = nullptr;
+        u32 transform_index = u32(-1);
+    };
 
-    u32 index = 0;
-    auto indices_mapping = pass->resources().map_buffer(indices_buffer);
-    for(const auto& [id, comp] : query.id_components()) {
-        const auto& [tr, mesh] = comp;
-        const u32 transform_index = tr.transform_index();
-        if(!mesh.mesh() || transform_index == u32(-1)) {
-            continue;
-        }
+    core::FrameVector<Draw> draws;
+    draws.set_min_capacity(query.size());
+
+    DrawList draw_list;
+    draw_list.reserve(query.size());
+
+    {
+        y_profile_zone("building draw list");
 
-        const auto materials = mesh.materials();
-        if(materials.size() == 1) {
-            if(const Material* mat = materials[0].get()) {
-                render_func(id, mesh, mesh.mesh()->draw_command(), mat, index);
-                indices_mapping[index++] = math::Vec2ui(
-                    transform_index,
-                    mat->draw_data().index()
-                );
+        const math::Vec3 camera_pos = scene_view.camera().position();
+        usize dropped = 0;
+        auto push_draw = [&](ecs::EntityId id, const MeshDrawCommand& draw_cmd, const Material* mat, u32 transform_index, float depth) {
+            if(!draw_list.push(mat->material_template(), mat, &draw_cmd, depth, u32(draws.size()))) {
+                ++dropped;
+                return;
             }
-        } else {
-            for(usize i = 0; i != materials.size(); ++i) {
-                if(const Material* mat = materials[i].get()) {
-                    render_func(id, mesh, mesh.mesh()->sub_meshes()[i], mat, index);
-                    indices_mapping[index++] = math::Vec2ui(
-                        transform_index,
-                        mat->draw_data().index()
-                    );
+            draws.emplace_back(id, &draw_cmd, mat, transform_index);
+        };
+
+        for(const auto& [id, comp] : query.id_components()) {
+            const auto& [tr, mesh] = comp;
+            const u32 transform_index = tr.transform_index();
+            if(!mesh.mesh() || transform_index == u32(-1)) {
+                continue;
+            }
+
+            const float depth = (tr.position() - camera_pos).length();
+            const auto materials = mesh.materials();
+            if(materials.size() == 1) {
+                if(const Material* mat = materials[0].get()) {
+                    push_draw(id, mesh.mesh()->draw_command(), mat, transform_index, depth);
+                }
+            } else {
+                for(usize i = 0; i != materials.size(); ++i) {
+                    if(const Material* mat = materials[i].get()) {
+                        push_draw(id, mesh.mesh()->sub_meshes()[i], mat, transform_index, depth);
+                    }
                 }
             }
         }
+
+        if(dropped) {
+            log_msg(fmt("Draw list is full, {} draws were skipped", dropped), Log::Warning);
+        }
+
+        draw_list.sort();
     }
-}
 
+    render_pass.bind_mesh_buffers(mesh_allocator().mesh_buffers());
+
+    auto indices_mapping = pass->resources().map_buffer(indices_buffer);
+    auto indirect_mapping = pass->resources().map_buffer(indirect_buffer);
+
+    const core::Span<u32> sorted = draw_list.indices();
+    const core::Span<DrawList::Batch> batches = draw_list.batches();
+
+    core::FrameVector<ecs::EntityId> batch_ids;
+    for(usize i = 0; i != batches.size(); ++i) {
+        const DrawList::Batch& batch = batches[i];
+        const Draw& first = draws[sorted[batch.first]];
+
+        batch_ids.make_empty();
+        for(u32 k = batch.first; k != batch.first + batch.count; ++k) {
+            const Draw& draw = draws[sorted[k]];
+            indices_mapping[k] = math::Vec2ui(
+                draw.transform_index,
+                draw.material->draw_data().index()
+            );
+            batch_ids << draw.id;
+        }
+
+        indirect_mapping[i] = first.draw_cmd->vk_indirect_data(batch.first, batch.count);
+        batch_func(Batch{*first.draw_cmd, first.material, batch_ids, batch.first, u32(i)});
+    }
+
+    return batches.size();
+}
 }
 
 #endif // YAVE_RENDERER_STATICMESHRENDERSUBPASS_CUSTOM_H
@@ -0,0 +1,131 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "FramePacket.h"
+
+#include <yave/ecs/EntityWorld.h>
+
+namespace yave {
+
+template<typename T>
+static void extract_lights(const ecs::EntityWorld& world, core::Vector<FramePacket::Light<T>>& lights) {
+    lights.clear();
+
+    const std::array tags = {ecs::tags::not_hidden};
+    if constexpr(std::is_same_v<T, DirectionalLightComponent> || std::is_same_v<T, SkyLightComponent>) {
+        for(auto&& [id, comp] : world.cached_query<T>(tags)) {
+            const auto& [l] = comp;
+            lights.emplace_back(id, TransformableComponent(), l);
+        }
+    } else {
+        for(auto&& [id, comp] : world.cached_query<TransformableComponent, T>(tags)) {
+            const auto& [t, l] = comp;
+            lights.emplace_back(id, t, l);
+        }
+    }
+}
+
+void FramePacket::extract(const ecs::EntityWorld& world, const Camera& camera) {
+    y_profile();
+
+    _camera = camera;
+
+    {
+        y_profile_zone("static meshes");
+
+        _static_meshes.clear();
+        _materials.clear();
+
+        const std::array tags = {ecs::tags::not_hidden};
+        for(auto&& [id, comp] : world.cached_query<TransformableComponent, StaticMeshComponent>(tags)) {
+            const auto& [t, m] = comp;
+
+            const core::Span<AssetPtr<Material>> mats = m.materials();
+            _static_meshes.emplace_back(id, t.transform(), m.mesh(), u32(_materials.size()), u32(mats.size()));
+            for(const AssetPtr<Material>& mat : mats) {
+                _materials.emplace_back(mat);
+            }
+        }
+    }
+
+    {
+        y_profile_zone("lights");
+
+        extract_lights(world, _directional_lights);
+        extract_lights(world, _point_lights);
+        extract_lights(world, _spot_lights);
+        extract_lights(world, _sky_lights);
+    }
+}
+
+u64 FramePacket::frame_id() const {
+    return _frame_id;
+}
+
+const Camera& FramePacket::camera() const {
+    return _camera;
+}
+
+core::Span<FramePacket::StaticMeshInstance> FramePacket::static_meshes() const {
+    return _static_meshes;
+}
+
+core::Span<AssetPtr<Material>> FramePacket::materials(const StaticMeshInstance& mesh) const {
+    return core::Span<AssetPtr<Material>>(_materials.data() + mesh.first_material, mesh.material_count);
+}
+
+
+
+FramePacket& FramePacketBuffer::begin_write() {
+    return _packets[_write];
+}
+
+void FramePacketBuffer::end_write() {
+    {
+        const auto lock = std::unique_lock(_lock);
+        _packets[_write]._frame_id = _next_frame_id++;
+        std::swap(_write, _ready);
+        _has_ready = true;
+    }
+    _condition.notify_all();
+}
+
+const FramePacket* FramePacketBuffer::acquire_latest() {
+    const auto lock = std::unique_lock(_lock);
+    if(_has_ready) {
+        std::swap(_read, _ready);
+        _has_ready = false;
+        _has_read = true;
+    }
+    return _has_read ? &_packets[_read] : nullptr;
+}
+
+const FramePacket* FramePacketBuffer::wait_for_next() {
+    auto lock = std::unique_lock(_lock);
+    _condition.wait(lock, [this] { return _has_ready; });
+    std::swap(_read, _ready);
+    _has_ready = false;
+    _has_read = true;
+    return &_packets[_read];
+}
+
+}
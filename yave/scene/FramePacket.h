@@ -0,0 +1,133 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_SCENE_FRAMEPACKET_H
+#define YAVE_SCENE_FRAMEPACKET_H
+
+#include <yave/camera/Camera.h>
+
+#include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/components/DirectionalLightComponent.h>
+#include <yave/components/PointLightComponent.h>
+#include <yave/components/SpotLightComponent.h>
+#include <yave/components/SkyLightComponent.h>
+
+#include <y/core/Vector.h>
+
+#include <array>
+#include <mutex>
+#include <condition_variable>
+
+namespace yave {
+
+// Copy of the render relevant state of a world, extracted once per frame.
+// Once published a packet is never modified, so it can be rendered while the world simulates the next frame.
+class FramePacket : NonMovable {
+    public:
+        template<typename T>
+        struct Light {
+            ecs::EntityId id;
+            TransformableComponent transform;
+            T component;
+        };
+
+        struct StaticMeshInstance {
+            ecs::EntityId id;
+            math::Transform<> transform;
+            AssetPtr<StaticMesh> mesh;
+            u32 first_material = 0;
+            u32 material_count = 0;
+        };
+
+        FramePacket() = default;
+
+        // Reuses the packet's storage
+        void extract(const ecs::EntityWorld& world, const Camera& camera);
+
+        u64 frame_id() const;
+        const Camera& camera() const;
+
+        core::Span<StaticMeshInstance> static_meshes() const;
+        core::Span<AssetPtr<Material>> materials(const StaticMeshInstance& mesh) const;
+
+        template<typename T>
+        core::Span<Light<T>> lights() const {
+            if constexpr(std::is_same_v<T, DirectionalLightComponent>) {
+                return _directional_lights;
+            } else if constexpr(std::is_same_v<T, PointLightComponent>) {
+                return _point_lights;
+            } else if constexpr(std::is_same_v<T, SpotLightComponent>) {
+                return _spot_lights;
+            } else {
+                static_assert(std::is_same_v<T, SkyLightComponent>, "Unsupported light type");
+                return _sky_lights;
+            }
+        }
+
+    private:
+        friend class FramePacketBuffer;
+
+        u64 _frame_id = 0;
+        Camera _camera;
+
+        core::Vector<StaticMeshInstance> _static_meshes;
+        core::Vector<AssetPtr<Material>> _materials;
+
+        core::Vector<Light<DirectionalLightComponent>> _directional_lights;
+        core::Vector<Light<PointLightComponent>> _point_lights;
+        core::Vector<Light<SpotLightComponent>> _spot_lights;
+        core::Vector<Light<SkyLightComponent>> _sky_lights;
+};
+
+
+// Triple buffered packets: the simulation writes one while the renderer reads another.
+// Writing never blocks, the renderer always gets the latest published packet.
+class FramePacketBuffer : NonMovable {
+    public:
+        FramePacketBuffer() = default;
+
+        // Simulation side
+        FramePacket& begin_write();
+        void end_write();
+
+        // Render side, the returned packet stays valid until the next call.
+        // Returns null if nothing was ever published.
+        const FramePacket* acquire_latest();
+        const FramePacket* wait_for_next();
+
+    private:
+        std::array<FramePacket, 3> _packets;
+
+        usize _write = 0;
+        usize _ready = 1;
+        usize _read = 2;
+        bool _has_ready = false;
+        bool _has_read = false;
+        u64 _next_frame_id = 0;
+
+        std::mutex _lock;
+        std::condition_variable _condition;
+};
+
+}
+
+#endif // YAVE_SCENE_FRAMEPACKET_H
@@ -21,6 +21,7 @@ SOFTWARE.
 **********************************/
 
 #include "SceneView.h"
+#include "FramePacket.h"
 
 #include <yave/graphics/commands/CmdBufferRecorder.h>
 
@@ -31,6 +32,12 @@ SceneView::SceneView(const ecs::EntityWorld* world, Camera cam) :
         _camera(cam) {
 }
 
+SceneView::SceneView(const ecs::EntityWorld* world, const FramePacket* packet) :
+        _world(world),
+        _packet(packet),
+        _camera(packet->camera()) {
+}
+
 const ecs::EntityWorld& SceneView::world() const {
     y_debug_assert(has_world());
     return *_world;
@@ -40,6 +47,10 @@ bool SceneView::has_world() const {
     return _world;
 }
 
+const FramePacket* SceneView::packet() const {
+    return _packet;
+}
+
 const Camera& SceneView::camera() const {
     return _camera;
 }
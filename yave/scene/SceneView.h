@@ -33,6 +33,9 @@ class SceneView {
         SceneView() = default;
         SceneView(const ecs::EntityWorld* world, Camera cam = Camera());
 
+        // Passes that support it read from the packet instead of the world
+        SceneView(const ecs::EntityWorld* world, const FramePacket* packet);
+
 #ifdef Y_DEBUG
         ~SceneView() {
             _world = nullptr;
@@ -43,11 +46,14 @@ class SceneView {
 
         bool has_world() const;
 
+        const FramePacket* packet() const;
+
         const Camera& camera() const;
         Camera& camera();
 
     private:
         const ecs::EntityWorld* _world = nullptr;
+        const FramePacket* _packet = nullptr;
         Camera _camera;
 };
 
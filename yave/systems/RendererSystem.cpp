@@ -29,8 +29,16 @@ SOFTWARE.
 #include <yave/graphics/commands/CmdQueue.h>
 #include <yave/graphics/descriptors/DescriptorSet.h>
 #include <yave/graphics/device/DeviceResources.h>
+#include <yave/graphics/device/MeshAllocator.h>
+#include <yave/graphics/device/UploadRingBuffer.h>
 
 #include <yave/components/TransformableComponent.h>
+#include <yave/components/StaticMeshComponent.h>
+#include <yave/systems/AssetLoaderSystem.h>
+#include <yave/material/Material.h>
+#include <yave/meshes/StaticMesh.h>
+
+#include <algorithm>
 
 namespace yave {
 
@@ -100,13 +108,13 @@ void RendererSystem::TransformManager::tick(bool only_recent) {
         };
 
         // moved_count * 2 because we might push 2 modifications if the transformable has not been allocated
-        auto transform_staging = TypedBuffer<math::Transform<>, BufferUsage::StorageBit, MemoryType::Staging>(moved_count * 2);
-        auto index_staging = TypedBuffer<u32, BufferUsage::StorageBit, MemoryType::Staging>(moved_count * 2);
+        const UploadAllocation transform_staging = upload_ring_buffer().alloc<math::Transform<>>(moved_count * 2);
+        const UploadAllocation index_staging = upload_ring_buffer().alloc<u32>(moved_count * 2);
 
         u32 index = 0;
         {
-            auto transform_mapping = transform_staging.map(MappingAccess::WriteOnly);
-            auto index_mapping = index_staging.map(MappingAccess::WriteOnly);
+            auto transform_mapping = transform_staging.typed_buffer<math::Transform<>>().map(MappingAccess::WriteOnly);
+            auto index_mapping = index_staging.typed_buffer<u32>().map(MappingAccess::WriteOnly);
             for(const auto& [tr] : query.components()) {
                 realloc_if_needed();
 
@@ -131,7 +139,9 @@ void RendererSystem::TransformManager::tick(bool only_recent) {
                 }
 
                 const auto& program = device_resources()[DeviceResources::UpdateTransformsProgram];
-                recorder.dispatch_size(program, math::Vec2ui(index, 1), DescriptorSet(_transform_buffer, transform_staging, index_staging, InlineDescriptor(index)));
+                const SubBuffer<BufferUsage::StorageBit> transforms(transform_staging.buffer());
+                const SubBuffer<BufferUsage::StorageBit> indices(index_staging.buffer());
+                recorder.dispatch_size(program, math::Vec2ui(index, 1), DescriptorSet(_transform_buffer, transforms, indices, InlineDescriptor(index)));
             }
             recorder.submit_async();
         }
@@ -152,20 +162,168 @@ void RendererSystem::TransformManager::tick(bool only_recent) {
 
 
 
+RendererSystem::StaticMeshManager::StaticMeshManager(ecs::EntityWorld& world) : _stats_buffer(1), _world(world) {
+    _mesh_created = _world.on_created<StaticMeshComponent>().subscribe([this](ecs::EntityId, StaticMeshComponent&) {
+        _dirty = true;
+    });
+    _mesh_destroyed = _world.on_destroyed<StaticMeshComponent>().subscribe([this](ecs::EntityId, StaticMeshComponent&) {
+        _dirty = true;
+    });
+    _transform_created = _world.on_created<TransformableComponent>().subscribe([this](ecs::EntityId, TransformableComponent&) {
+        _dirty = true;
+    });
+    _mesh_relocated = mesh_allocator().on_relocated().subscribe([this] {
+        _dirty = true;
+    });
+
+    consume_stats();
+}
+
+RendererSystem::StaticMeshManager::~StaticMeshManager() {
+}
+
+usize RendererSystem::StaticMeshManager::instance_count() const {
+    return _instance_count;
+}
+
+core::Span<RendererSystem::StaticMeshManager::Group> RendererSystem::StaticMeshManager::groups() const {
+    return _groups;
+}
+
+uniform::CullingStats RendererSystem::StaticMeshManager::consume_stats() {
+    auto mapping = _stats_buffer.map(MappingAccess::ReadWrite);
+    const uniform::CullingStats stats = mapping[0];
+    mapping[0] = {};
+    return stats;
+}
+
+void RendererSystem::StaticMeshManager::tick() {
+    if(!_dirty) {
+        const AssetLoaderSystem* loader = _world.find_system<AssetLoaderSystem>();
+        _dirty = (loader && !loader->recently_loaded().is_empty()) || !_world.recently_mutated<StaticMeshComponent>().is_empty();
+    }
+
+    if(_dirty) {
+        rebuild();
+    }
+}
+
+void RendererSystem::StaticMeshManager::rebuild() {
+    y_profile();
+
+    struct Instance {
+        const MaterialTemplate* material_template = nullptr;
+        uniform::StaticMeshInstance instance;
+    };
+
+    _dirty = false;
+
+    core::Vector<Instance> instances;
+
+    const ecs::SparseIdSetBase* hidden = _world.tag_set(ecs::tags::hidden);
+    const auto group = std::as_const(_world).group<TransformableComponent, StaticMeshComponent>();
+    for(const auto& [id, comp] : group) {
+        if(hidden && hidden->contains(id)) {
+            continue;
+        }
+
+        const auto& [tr, mesh] = comp;
+        const StaticMesh* static_mesh = mesh.mesh().get();
+        const u32 transform_index = tr.transform_index();
+        if(!static_mesh || transform_index == u32(-1)) {
+            continue;
+        }
+
+        const AABB& aabb = static_mesh->aabb();
+        const auto materials = mesh.materials();
+        for(usize i = 0; i != materials.size(); ++i) {
+            const Material* mat = materials[i].get();
+            if(!mat) {
+                continue;
+            }
+
+            const MeshDrawCommand& draw_cmd = materials.size() == 1 ? static_mesh->draw_command() : static_mesh->sub_meshes()[i];
+
+            Instance& inst = instances.emplace_back();
+            inst.material_template = mat->material_template();
+            inst.instance.center = aabb.center();
+            inst.instance.radius = aabb.radius();
+            inst.instance.transform_index = transform_index;
+            inst.instance.material_index = mat->draw_data().index();
+            inst.instance.index_count = draw_cmd.index_count;
+            inst.instance.first_index = draw_cmd.first_index;
+            inst.instance.vertex_offset = draw_cmd.vertex_offset;
+        }
+    }
+
+    std::stable_sort(instances.begin(), instances.end(), [](const Instance& a, const Instance& b) {
+        return a.material_template < b.material_template;
+    });
+
+    _groups.make_empty();
+    for(usize i = 0; i != instances.size(); ++i) {
+        if(_groups.is_empty() || _groups.last().material_template != instances[i].material_template) {
+            _groups.emplace_back(instances[i].material_template, u32(i), 0u);
+        }
+        instances[i].instance.group_index = u32(_groups.size() - 1);
+        instances[i].instance.group_offset = _groups.last().first;
+        ++_groups.last().count;
+    }
+
+    _instance_count = instances.size();
+    if(instances.is_empty()) {
+        return;
+    }
+
+    y_profile_msg(fmt_c_str("{} static mesh instances in {} groups", instances.size(), _groups.size()));
+
+    const UploadAllocation staging = upload_ring_buffer().alloc<uniform::StaticMeshInstance>(instances.size());
+    {
+        auto mapping = staging.typed_buffer<uniform::StaticMeshInstance>().map(MappingAccess::WriteOnly);
+        for(usize i = 0; i != instances.size(); ++i) {
+            mapping[i] = instances[i].instance;
+        }
+    }
+
+    if(_instance_buffer.size() < instances.size()) {
+        _instance_buffer = InstanceBuffer(2_uu << log2ui(instances.size()));
+    }
+
+    {
+        ComputeCmdBufferRecorder recorder = create_disposable_compute_cmd_buffer();
+        recorder.unbarriered_copy(staging.buffer(), SubBuffer<BufferUsage::TransferDstBit>(_instance_buffer, staging.buffer().byte_size(), 0));
+        recorder.submit_async();
+    }
+}
+
+
+
+
+
+
 RendererSystem::RendererSystem() : ecs::System("RendererSystem") {
 }
 
 void RendererSystem::destroy() {
+    _static_mesh_manager = nullptr;
     _transform_manager = nullptr;
 }
 
 void RendererSystem::setup() {
+    if(!world().has_group<TransformableComponent, StaticMeshComponent>()) {
+        world().create_group<TransformableComponent, StaticMeshComponent>();
+    }
+
     _transform_manager = std::make_unique<TransformManager>(world());
     _transform_manager->tick(false);
+
+    _static_mesh_manager = std::make_unique<StaticMeshManager>(world());
+    _static_mesh_manager->tick();
 }
 
 void RendererSystem::tick() {
     _transform_manager->tick(false);
+    _static_mesh_manager->tick();
 }
 
 }
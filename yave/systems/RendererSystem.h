@@ -70,6 +70,57 @@ class RendererSystem : public ecs::System {
                 ecs::EntityWorld& _world;
         };
 
+        // Keeps every visible static mesh instance in a GPU buffer for GPU driven culling
+        class StaticMeshManager : NonMovable {
+            public:
+                using InstanceBuffer = TypedBuffer<uniform::StaticMeshInstance, BufferUsage::StorageBit | BufferUsage::TransferDstBit>;
+                using StatsBuffer = TypedBuffer<uniform::CullingStats, BufferUsage::StorageBit, MemoryType::Staging>;
+
+                // Instances are sorted by material template, each group is drawn with a single indirect count draw
+                struct Group {
+                    const MaterialTemplate* material_template = nullptr;
+                    u32 first = 0;
+                    u32 count = 0;
+                };
+
+                TypedSubBuffer<uniform::StaticMeshInstance, BufferUsage::StorageBit> instance_buffer() const {
+                    return _instance_buffer;
+                }
+
+                TypedSubBuffer<uniform::CullingStats, BufferUsage::StorageBit> stats_buffer() const {
+                    return _stats_buffer;
+                }
+
+                StaticMeshManager(ecs::EntityWorld& world);
+                ~StaticMeshManager();
+
+                void tick();
+
+                usize instance_count() const;
+                core::Span<Group> groups() const;
+
+                // Stats written by the culling passes of previous frames, reading them resets the counters
+                uniform::CullingStats consume_stats();
+
+            private:
+                void rebuild();
+
+                InstanceBuffer _instance_buffer;
+                StatsBuffer _stats_buffer;
+
+                core::Vector<Group> _groups;
+                usize _instance_count = 0;
+
+                bool _dirty = true;
+
+                concurrent::Subscription _mesh_created;
+                concurrent::Subscription _mesh_destroyed;
+                concurrent::Subscription _transform_created;
+                concurrent::Subscription _mesh_relocated;
+
+                ecs::EntityWorld& _world;
+        };
+
 
 
 
@@ -79,12 +130,21 @@ class RendererSystem : public ecs::System {
             return _transform_manager->transform_buffer();
         }
 
+        const StaticMeshManager& static_meshes() const {
+            return *_static_mesh_manager;
+        }
+
+        StaticMeshManager& static_meshes() {
+            return *_static_mesh_manager;
+        }
+
         void destroy() override;
         void setup() override;
         void tick() override;
 
     private:
         std::unique_ptr<TransformManager> _transform_manager;
+        std::unique_ptr<StaticMeshManager> _static_mesh_manager;
 
 };
 
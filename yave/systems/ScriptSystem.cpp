@@ -29,10 +29,40 @@ SOFTWARE.
 
 #include <y/utils/log.h>
 #include <y/utils/format.h>
+#include <y/utils/memory_tracking.h>
+
+#include <cstdlib>
 
 namespace yave {
 
-ScriptSystem::ScriptSystem() : ecs::System("ScriptSystem") {
+// Lua doesn't go through operator new, so its allocations are reported here
+static void* tracked_lua_alloc(void*, void* ptr, usize old_size, usize new_size) {
+    if(!new_size) {
+        if(ptr) {
+            memory_tracking::on_free(old_size, MemoryTag::Scripting);
+        }
+        std::free(ptr);
+        return nullptr;
+    }
+
+    // Lua handles allocation failures, including over budget ones
+    if(!memory_tracking::on_alloc(new_size, MemoryTag::Scripting)) {
+        return nullptr;
+    }
+
+    void* new_ptr = std::realloc(ptr, new_size);
+    if(!new_ptr) {
+        memory_tracking::on_free(new_size, MemoryTag::Scripting);
+        return nullptr;
+    }
+
+    if(ptr) {
+        memory_tracking::on_free(old_size, MemoryTag::Scripting);
+    }
+    return new_ptr;
+}
+
+ScriptSystem::ScriptSystem() : ecs::System("ScriptSystem"), _state(sol::default_at_panic, tracked_lua_alloc) {
     _state.open_libraries();
 
     script::bind_math_types(_state);
@@ -43,6 +73,8 @@ ScriptSystem::ScriptSystem() : ecs::System("ScriptSystem") {
 }
 
 void ScriptSystem::update(float) {
+    y_memory_tag(MemoryTag::Scripting);
+
     ScriptWorldComponent* scripts_comp = world().get_or_add_world_component<ScriptWorldComponent>();
 
     _state["world"] = &world();
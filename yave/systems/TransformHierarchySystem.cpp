@@ -0,0 +1,210 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "TransformHierarchySystem.h"
+
+#include <yave/components/TransformableComponent.h>
+
+#include <yave/ecs/EntityWorld.h>
+
+#include <y/utils/log.h>
+#include <y/utils/format.h>
+
+namespace yave {
+
+// Levels smaller than this are not worth dispatching to other threads
+static constexpr usize parallel_level_size = 4096;
+
+
+TransformHierarchySystem::TransformHierarchySystem() : ecs::System("TransformHierarchySystem") {
+}
+
+void TransformHierarchySystem::destroy() {
+    _parent_changed = {};
+}
+
+void TransformHierarchySystem::setup() {
+    // Keep the world transform when reparenting, the local one will be recomputed
+    _parent_changed = world().on_parent_changed().subscribe([this](ecs::EntityId id) {
+        if(TransformableComponent* tr = world().component_mut<TransformableComponent>(id)) {
+            tr->_world_changed = true;
+            tr->_dirty = true;
+        }
+    });
+
+    world().make_mutated<TransformableComponent>(world().component_set<TransformableComponent>().ids());
+}
+
+void TransformHierarchySystem::tick() {
+    y_profile();
+
+    const ecs::SparseComponentSet<TransformableComponent>& transformables = world().component_set<TransformableComponent>();
+
+    {
+        // Ids left over from the last tick might have been removed since
+        const core::Vector<ecs::EntityId> pending(_dirty.ids());
+        for(const ecs::EntityId id : pending) {
+            if(!transformables.contains(id)) {
+                _dirty.erase(id);
+            }
+        }
+        for(const ecs::EntityId id : world().recently_mutated<TransformableComponent>()) {
+            _dirty.insert(id);
+        }
+    }
+
+    if(_dirty.is_empty()) {
+        return;
+    }
+
+    _ids.make_empty();
+    _parents.make_empty();
+    _levels.make_empty();
+
+    {
+        y_profile_zone("collecting roots");
+        for(const ecs::EntityId id : _dirty.ids()) {
+            ecs::EntityId parent;
+            bool has_dirty_parent = false;
+            for(const ecs::EntityId p : world().parents(id)) {
+                if(_dirty.contains(p)) {
+                    has_dirty_parent = true;
+                    break;
+                }
+                if(!parent.is_valid() && transformables.contains(p)) {
+                    parent = p;
+                }
+            }
+
+            if(!has_dirty_parent) {
+                _ids << id;
+                _parents << parent;
+            }
+        }
+    }
+
+    {
+        y_profile_zone("collecting children");
+        usize level_begin = 0;
+        while(level_begin != _ids.size()) {
+            const usize level_end = _ids.size();
+            _levels << level_begin;
+            for(usize i = level_begin; i != level_end; ++i) {
+                collect_children(_ids[i], _ids[i]);
+            }
+            level_begin = level_end;
+        }
+        _levels << _ids.size();
+    }
+
+    // Anything mutated from now on will be picked up by post_tick
+    _dirty.make_empty();
+
+    {
+        y_profile_zone("mutating");
+
+        // Marks everything as mutated at once
+        auto query = world().query<ecs::Mutate<TransformableComponent>>(_ids);
+        y_debug_assert(query.size() == _ids.size());
+
+        _entries.make_empty();
+        _entries.set_min_capacity(_ids.size());
+
+        usize index = 0;
+        for(auto&& [tr] : query.components()) {
+            const ecs::EntityId parent = _parents[index++];
+            _entries.emplace_back(&tr, parent.is_valid() ? transformables.try_get(parent) : nullptr);
+        }
+    }
+
+    for(usize i = 0; i + 1 < _levels.size(); ++i) {
+        update_level(core::Span<Entry>(_entries.data() + _levels[i], _levels[i + 1] - _levels[i]));
+    }
+
+    y_profile_msg(fmt_c_str("{} transforms updated in {} levels", _entries.size(), _levels.size() - 1));
+}
+
+void TransformHierarchySystem::post_tick() {
+    y_profile();
+
+    // Mutations from systems that ticked after us are forgotten by the world once the tick ends
+    const ecs::SparseComponentSet<TransformableComponent>& transformables = world().component_set<TransformableComponent>();
+    for(const ecs::EntityId id : world().recently_mutated<TransformableComponent>()) {
+        const TransformableComponent* tr = transformables.try_get(id);
+        if(tr && tr->_dirty) {
+            _dirty.insert(id);
+        }
+    }
+}
+
+void TransformHierarchySystem::collect_children(ecs::EntityId id, ecs::EntityId parent) {
+    const ecs::SparseComponentSet<TransformableComponent>& transformables = world().component_set<TransformableComponent>();
+    for(const ecs::EntityId child : world().children(id)) {
+        if(transformables.contains(child)) {
+            _ids << child;
+            _parents << parent;
+        } else {
+            // Entities without transform are transparent
+            collect_children(child, parent);
+        }
+    }
+}
+
+void TransformHierarchySystem::update_level(core::Span<Entry> entries) {
+    y_profile_dyn_zone(fmt_c_str("updating {} transforms", entries.size()));
+
+    auto update_range = [](const Entry* begin, const Entry* end) {
+        for(const Entry* it = begin; it != end; ++it) {
+            it->transformable->update_from_parent(it->parent);
+        }
+        return usize(end - begin);
+    };
+
+    if(entries.size() < parallel_level_size) {
+        update_range(entries.begin(), entries.end());
+        return;
+    }
+
+    if(!_thread_pool) {
+        _thread_pool = std::make_unique<concurrent::StaticThreadPool>();
+    }
+
+    const usize chunk_size = (entries.size() + _thread_pool->concurency()) / (_thread_pool->concurency() + 1);
+
+    core::Vector<std::future<usize>> futures;
+    const Entry* begin = entries.begin() + chunk_size;
+    while(begin < entries.end()) {
+        const Entry* end = std::min(begin + chunk_size, entries.end());
+        futures.emplace_back(_thread_pool->schedule_with_future([=] { return update_range(begin, end); }));
+        begin = end;
+    }
+
+    // The calling thread processes the first chunk
+    update_range(entries.begin(), entries.begin() + chunk_size);
+
+    for(auto& future : futures) {
+        future.wait();
+    }
+}
+
+}
+
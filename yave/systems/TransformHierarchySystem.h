@@ -0,0 +1,74 @@
+/*******************************
+Copyright (c) 2016-2023 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_SYSTEMS_TRANSFORMHIERARCHYSYSTEM_H
+#define YAVE_SYSTEMS_TRANSFORMHIERARCHYSYSTEM_H
+
+#include <yave/ecs/System.h>
+#include <yave/ecs/SparseComponentSet.h>
+
+#include <y/concurrent/Signal.h>
+#include <y/concurrent/StaticThreadPool.h>
+#include <y/core/Vector.h>
+
+namespace yave {
+
+class TransformableComponent;
+
+// Propagates transforms from parents to children.
+// Only subtrees rooted at recently mutated TransformableComponents are updated, one depth level at a time.
+// Every updated component is marked as mutated in one batch so downstream systems pick them up in the same tick.
+// Transforms changed after the system ticked are kept and propagated on the next tick.
+class TransformHierarchySystem : public ecs::System {
+    public:
+        TransformHierarchySystem();
+
+        void destroy() override;
+        void setup() override;
+        void tick() override;
+        void post_tick() override;
+
+    private:
+        struct Entry {
+            TransformableComponent* transformable = nullptr;
+            const TransformableComponent* parent = nullptr;
+        };
+
+        void collect_children(ecs::EntityId id, ecs::EntityId parent);
+        void update_level(core::Span<Entry> entries);
+
+        // Transforms to propagate, including the ones mutated by systems that ticked after us
+        ecs::SparseIdSet _dirty;
+
+        core::Vector<ecs::EntityId> _ids;
+        core::Vector<ecs::EntityId> _parents;
+        core::Vector<usize> _levels;
+        core::Vector<Entry> _entries;
+
+        std::unique_ptr<concurrent::StaticThreadPool> _thread_pool;
+
+        concurrent::Subscription _parent_changed;
+};
+
+}
+
+#endif // YAVE_SYSTEMS_TRANSFORMHIERARCHYSYSTEM_H
+
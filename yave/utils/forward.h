@@ -85,6 +85,8 @@ class FrameGraphPersistentResourceId;
 class FrameGraphRegion;
 class FrameGraphResourceId;
 class FrameGraphResourcePool;
+class FramePacket;
+class FramePacketBuffer;
 class Framebuffer;
 class Frustum;
 class GenericAssetPtr;
@@ -153,6 +155,9 @@ class TransferCmdBufferRecorder;
 class TransformManager;
 class TransformableComponent;
 class TransientBuffer;
+class UploadAllocation;
+class UploadRingBuffer;
+class PipelineCache;
 class Window;
 struct AABBTypeInfo;
 struct Allocator;
@@ -213,6 +218,7 @@ struct Level;
 struct LightingPass;
 struct LightingSettings;
 struct LoadableComponentTypeInfo;
+struct MaterialShaders;
 struct MeshDrawCommand;
 struct Mip;
 struct Monitor;
@@ -261,6 +267,7 @@ class EntityId;
 class EntityPool;
 class EntityPrefab;
 class EntityWorld;
+class PrefabSpawnPlan;
 class SparseIdSet;
 class SparseIdSetBase;
 class System;
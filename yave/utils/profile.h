@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_UTILS_PROFILE_H
 
 #include <y/concurrent/concurrent.h>
+#include <y/utils/trace.h>
 #include <cstring>
 
 #if defined(TRACY_ENABLE) && !defined(YAVE_PROFILING_DISABLED)
@@ -53,6 +54,27 @@ SOFTWARE.
 #define y_profile_alloc(ptr, size)          TracyAlloc(ptr, size)
 #define y_profile_free(ptr)                 TracyFree(ptr)
 
+#define y_profile_plot(name, value)         TracyPlot(name, value)
+
+#elif !defined(YAVE_PROFILING_DISABLED)
+
+// Without Tracy, zones go to the built-in recorder (see y/utils/trace.h), which is off until trace::set_enabled(true)
+
+#define y_profile_frame_begin()             do {} while(false)
+#define y_profile_frame_end()               do { y::trace::frame_mark(); } while(false)
+
+#define y_profile_msg(msg)                  do { if(y::trace::is_enabled()) { y::trace::message(msg); } } while(false)
+
+#define y_profile()                         const y::trace::Zone y_create_name_with_prefix(trace)(__FUNCTION__)
+#define y_profile_zone(name)                const y::trace::Zone y_create_name_with_prefix(trace)(name)
+#define y_profile_dyn_zone(name)            const y::trace::Zone y_create_name_with_prefix(trace)(y::trace::dynamic_name, y::trace::is_enabled() ? std::string_view(name) : std::string_view())
+
+
+#define y_profile_alloc(ptr, size)          do {} while(false)
+#define y_profile_free(ptr)                 do {} while(false)
+
+#define y_profile_plot(name, value)         do { y::trace::plot(name, y::i64(value)); } while(false)
+
 #else
 
 #define y_profile_frame_begin()             do {} while(false)
@@ -67,6 +89,8 @@ SOFTWARE.
 #define y_profile_alloc(ptr, size)          do {} while(false)
 #define y_profile_free(ptr)                 do {} while(false)
 
+#define y_profile_plot(name, value)         do {} while(false)
+
 #endif // YAVE_PROFILING
 
 #endif // YAVE_UTILS_PROFILE_H